@@ -3,8 +3,9 @@
 using namespace BOSS;
 
 ActionSet::ActionSet()
+    : _race(Races::None)
 {
-
+    std::fill(_mask, _mask + MaskWords, 0);
 }
 
 const size_t ActionSet::size() const
@@ -22,23 +23,39 @@ const ActionType & ActionSet::operator [] (const size_t & index) const
     return _actionTypes[index];
 }
 
-ActionType & ActionSet::operator [] (const size_t & index)
+const bool ActionSet::hasBit(const ActionID id) const
 {
-    return _actionTypes[index];
+    return (_mask[id >> 6] >> (id & 63)) & 1;
 }
 
 const bool ActionSet::contains(const ActionType & action) const
 {
-    return _actionTypes.contains(action);
+    return action.getRace() == _race && hasBit(action.ID());
 }
 
 void ActionSet::add(const ActionType & action)
 {
+    BOSS_ASSERT(isEmpty() || action.getRace() == _race, "All actions in an ActionSet must be of the same race");
+
+    if (contains(action))
+    {
+        return;
+    }
+
+    _race = action.getRace();
+    _mask[action.ID() >> 6] |= 1ULL << (action.ID() & 63);
     _actionTypes.push_back(action);
 }
 
 void ActionSet::remove(const ActionType & action)
 {
+    if (!contains(action))
+    {
+        return;
+    }
+
+    _mask[action.ID() >> 6] &= ~(1ULL << (action.ID() & 63));
+
     for (size_t i(0); i<_actionTypes.size(); ++i)
     {
         if (_actionTypes[i] == action)
@@ -51,5 +68,26 @@ void ActionSet::remove(const ActionType & action)
 
 void ActionSet::clear()
 {
+    std::fill(_mask, _mask + MaskWords, 0);
     _actionTypes.clear();
-}
\ No newline at end of file
+}
+
+// insertion sort, since a set of legal actions is short and often nearly in order
+void ActionSet::sortByKey(int * keys)
+{
+    for (size_t i(1); i < _actionTypes.size(); ++i)
+    {
+        const ActionType action = _actionTypes[i];
+        const int key = keys[i];
+
+        size_t j = i;
+        for (; j > 0 && keys[j-1] > key; --j)
+        {
+            _actionTypes[j] = _actionTypes[j-1];
+            keys[j] = keys[j-1];
+        }
+
+        _actionTypes[j] = action;
+        keys[j] = key;
+    }
+}
@@ -8,9 +8,19 @@
 namespace BOSS
 {
 
+// A set of actions of one race. Membership is a bit per action ID, so contains() and remove()
+// of an action that isn't there don't scan. The actions are also kept in a list, in the order
+// they were added, so that iterating by index visits them in the same order as always
+// and the searches that branch on them give the same results.
 class ActionSet
 {
-	Vec<ActionType, Constants::MAX_ACTION_TYPES> _actionTypes;
+    static const size_t MaskWords = (Constants::MAX_ACTION_TYPES + 63) / 64;
+
+    unsigned long long                              _mask[MaskWords];
+    RaceID                                          _race;
+	Vec<ActionType, Constants::MAX_ACTION_TYPES>    _actionTypes;
+
+    const bool hasBit(const ActionID id) const;
 
 public:
 
@@ -21,12 +31,15 @@ public:
     const bool contains(const ActionType & type) const;
 
     const ActionType & operator [] (const size_t & index) const;
-    ActionType & operator [] (const size_t & index);
 
+    // adding an action that is already in the set does nothing
     void add(const ActionType & action);
-    void addAllActions(const RaceID & race);
     void remove(const ActionType & action);
     void clear();
+
+    // reorder the actions by ascending key, keys[i] being the key of the i-th action
+    // actions with equal keys keep their order, and the keys are reordered with them
+    void sortByKey(int * keys);
 };
 
-}
\ No newline at end of file
+}
@@ -5,27 +5,6 @@
 
 using namespace BOSS;
 
-ActionType::ActionType()
-: _race(Races::None)
-, _id(0)
-{
-
-}
-
-ActionType::ActionType(const RaceID & race, const ActionID & id)
-: _race(race)
-, _id(id)
-{
-
-}
-
-ActionType::ActionType(const ActionType & type)
-: _race(type._race)
-, _id(type._id)
-{
-
-}
-
 ActionType::ActionType(const BWAPI::UnitType & type)
     : _race(ActionTypeData::GetRaceID(type.getRace()))
     , _id(ActionTypeData::GetActionID(type))
@@ -47,58 +26,18 @@ ActionType::ActionType(const BWAPI::TechType & type)
 
 }
 
-ActionType & ActionType::operator = (const ActionType & rhs)
-{
-    if (this != &rhs)
-    {
-        new (this) ActionType(rhs);
-    }
-
-    return *this;
-}   
-
-const ActionID              ActionType::ID()                    const { return _id; }
-const RaceID                ActionType::getRace()               const { return _race; }
-
 BWAPI::UnitType             ActionType::getUnitType()           const { return ActionTypeData::GetActionTypeData(_race, _id).getUnitType(); }
 BWAPI::UpgradeType          ActionType::getUpgradeType()        const { return ActionTypeData::GetActionTypeData(_race, _id).getUpgradeType(); }
 BWAPI::TechType             ActionType::getTechType()           const { return ActionTypeData::GetActionTypeData(_race, _id).getTechType(); }
 
 BWAPI::UnitType             ActionType::whatBuildsBWAPI()       const { return ActionTypeData::GetActionTypeData(_race, _id).whatBuildsBWAPI(); }
-ActionType		            ActionType::whatBuildsActionType()  const { return ActionTypes::GetActionType(_race, whatBuildsAction()); }
-ActionID                    ActionType::whatBuildsAction()      const { return ActionTypeData::GetActionTypeData(_race, _id).whatBuildsAction(); }	
 
-const PrerequisiteSet &     ActionType::getPrerequisites()      const { return ActionTypeData::GetActionTypeData(_race, _id).getPrerequisites(); }
 const PrerequisiteSet &     ActionType::getRecursivePrerequisites()      const { return ActionTypeData::GetActionTypeData(_race, _id).getRecursivePrerequisites(); }
 int                         ActionType::getType()               const { return ActionTypeData::GetActionTypeData(_race, _id).getType(); }
 	
 const std::string &         ActionType::getName()               const { return ActionTypeData::GetActionTypeData(_race, _id).getName(); }
 const std::string &         ActionType::getShortName()          const { return ActionTypeData::GetActionTypeData(_race, _id).getShortName(); }
 const std::string &         ActionType::getMetaName()           const { return ActionTypeData::GetActionTypeData(_race, _id).getMetaName(); }
-	
-FrameCountType              ActionType::buildTime()             const { return ActionTypeData::GetActionTypeData(_race, _id).buildTime(); }
-ResourceCountType           ActionType::mineralPrice()          const { return ActionTypeData::GetActionTypeData(_race, _id).mineralPrice(); }
-ResourceCountType           ActionType::mineralPriceScaled()    const { return ActionTypeData::GetActionTypeData(_race, _id).mineralPriceScaled(); }
-ResourceCountType           ActionType::gasPrice()              const { return ActionTypeData::GetActionTypeData(_race, _id).gasPrice(); }
-ResourceCountType           ActionType::gasPriceScaled()        const { return ActionTypeData::GetActionTypeData(_race, _id).gasPriceScaled(); }
-SupplyCountType             ActionType::supplyRequired()        const { return ActionTypeData::GetActionTypeData(_race, _id).supplyRequired(); }
-SupplyCountType             ActionType::supplyProvided()        const { return ActionTypeData::GetActionTypeData(_race, _id).supplyProvided(); }
-UnitCountType               ActionType::numProduced()           const { return ActionTypeData::GetActionTypeData(_race, _id).numProduced(); }
-
-bool                        ActionType::isAddon()               const { return ActionTypeData::GetActionTypeData(_race, _id).isAddon(); }
-bool                        ActionType::isRefinery()            const { return ActionTypeData::GetActionTypeData(_race, _id).isRefinery(); }
-bool                        ActionType::isWorker()              const { return ActionTypeData::GetActionTypeData(_race, _id).isWorker(); }
-bool                        ActionType::isBuilding()            const { return ActionTypeData::GetActionTypeData(_race, _id).isBuilding(); }
-bool                        ActionType::isResourceDepot()       const { return ActionTypeData::GetActionTypeData(_race, _id).isResourceDepot(); }
-bool                        ActionType::isSupplyProvider()      const { return ActionTypeData::GetActionTypeData(_race, _id).isSupplyProvider(); }
-bool                        ActionType::isUnit()                const { return ActionTypeData::GetActionTypeData(_race, _id).isUnit(); }
-bool                        ActionType::isTech()                const { return ActionTypeData::GetActionTypeData(_race, _id).isTech(); }
-bool                        ActionType::isUpgrade()             const { return ActionTypeData::GetActionTypeData(_race, _id).isUpgrade(); }
-bool                        ActionType::whatBuildsIsBuilding()  const { return ActionTypeData::GetActionTypeData(_race, _id).whatBuildsIsBuilding(); }
-bool                        ActionType::whatBuildsIsLarva()     const { return ActionTypeData::GetActionTypeData(_race, _id).whatBuildsIsLarva(); }
-bool                        ActionType::canProduce()            const { return ActionTypeData::GetActionTypeData(_race, _id).canProduce(); }
-bool                        ActionType::requiresAddon()         const { return ActionTypeData::GetActionTypeData(_race, _id).requiresAddon(); }
-bool                        ActionType::isMorphed()             const { return ActionTypeData::GetActionTypeData(_race, _id).isMorphed(); }
 
 bool ActionType::canBuild(const ActionType & t) const 
 { 
@@ -142,12 +81,6 @@ bool ActionType::canBuild(const ActionType & t) const
     return false;
 }
 
-ActionType                  ActionType::requiredAddonType()     const { return ActionTypes::GetActionType(_race, ActionTypeData::GetActionTypeData(_race, _id).requiredAddonID()); }
-
-const bool ActionType::operator == (const ActionType & rhs)     const { return _race == rhs._race && _id == rhs._id; }
-const bool ActionType::operator != (const ActionType & rhs)     const { return _race != rhs._race || _id != rhs._id; }
-const bool ActionType::operator <  (const ActionType & rhs)     const { return _id < rhs._id; }
-
 namespace BOSS
 {
 namespace ActionTypes
@@ -159,14 +92,48 @@ namespace ActionTypes
     std::vector<ActionType>  supplyProviderActionTypes;
     std::vector<ActionType>  resourceDepotActionTypes;
     size_t numActionTypes[Races::NUM_RACES] = {0, 0, 0};
+    ActionTypeValues Values[Races::None + 1][Constants::MAX_ACTIONS];
+
+    void setValues(const ActionTypeData & data)
+    {
+        ActionTypeValues & values       = Values[data.getRaceID()][data.getActionID()];
+        values.prerequisites            = &data.getPrerequisites();
+        values.mineralPrice             = data.mineralPrice();
+        values.gasPrice                 = data.gasPrice();
+        values.supplyRequired           = data.supplyRequired();
+        values.supplyProvided           = data.supplyProvided();
+        values.buildTime                = data.buildTime();
+        values.numProduced              = data.numProduced();
+        values.whatBuilds               = data.whatBuildsAction();
+        values.requiredAddon            = data.requiredAddonID();
+        values.unit                     = data.isUnit();
+        values.tech                     = data.isTech();
+        values.upgrade                  = data.isUpgrade();
+        values.building                 = data.isBuilding();
+        values.worker                   = data.isWorker();
+        values.refinery                 = data.isRefinery();
+        values.resourceDepot            = data.isResourceDepot();
+        values.supplyProvider           = data.isSupplyProvider();
+        values.addon                    = data.isAddon();
+        values.requiresAddon            = data.requiresAddon();
+        values.morphed                  = data.isMorphed();
+        values.canProduce               = data.canProduce();
+        values.whatBuildsIsBuilding     = data.whatBuildsIsBuilding();
+        values.whatBuildsIsLarva        = data.whatBuildsIsLarva();
+    }
 
     void init()
     {
         for (RaceID r(0); r < Races::NUM_RACES; ++r)
         {
+            BOSS_ASSERT(ActionTypeData::GetNumActionTypes(r) <= Constants::MAX_ACTIONS, "Too many action types: %d", (int)ActionTypeData::GetNumActionTypes(r));
+
             allActionTypes.push_back(std::vector<ActionType>());
             for (ActionID a(0); a < ActionTypeData::GetNumActionTypes(r); ++a)
             {
+                // the values first, the accessors below read them
+                setValues(ActionTypeData::GetActionTypeData(r, a));
+
                 ActionType type(r, a);
                 allActionTypes[r].push_back(type);
 
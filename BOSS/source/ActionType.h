@@ -9,20 +9,18 @@ class PrerequisiteSet;
 
 class ActionType
 {
-    const ActionID	    _id;
-    const RaceID        _race;
+    // no const members or user defined copies, so that arrays of actions copy as plain memory
+    ActionID	        _id;
+    RaceID              _race;
 
 public:
 	
-    ActionType();
-    ActionType(const RaceID & race, const ActionID & id);
-    ActionType(const ActionType & type);
+    ActionType() : _id(0), _race(Races::None) { }
+    ActionType(const RaceID & race, const ActionID & id) : _id(id), _race(race) { }
     ActionType(const BWAPI::UnitType & type);
     ActionType(const BWAPI::UpgradeType & type);
     ActionType(const BWAPI::TechType & type);
 
-    ActionType & operator = (const ActionType & rhs);
-
     const ActionID              ID()                    const;
     const RaceID                getRace()               const;
 
@@ -75,8 +73,43 @@ public:
 
 class ActionSet;
 
+// The values the searches read for every child they generate. ActionTypes::init() copies them out of
+// ActionTypeData into a flat table for each race, which the inline accessors at the end of this file read.
+class ActionTypeValues
+{
+public:
+
+    const PrerequisiteSet * prerequisites;
+    ResourceCountType       mineralPrice;
+    ResourceCountType       gasPrice;
+    SupplyCountType         supplyRequired;
+    SupplyCountType         supplyProvided;
+    FrameCountType          buildTime;
+    UnitCountType           numProduced;
+    ActionID                whatBuilds;
+    ActionID                requiredAddon;
+
+    bool                    unit;
+    bool                    tech;
+    bool                    upgrade;
+    bool                    building;
+    bool                    worker;
+    bool                    refinery;
+    bool                    resourceDepot;
+    bool                    supplyProvider;
+    bool                    addon;
+    bool                    requiresAddon;
+    bool                    morphed;
+    bool                    canProduce;
+    bool                    whatBuildsIsBuilding;
+    bool                    whatBuildsIsLarva;
+};
+
 namespace ActionTypes
 {
+    // indexed by race then action ID, the Races::None row is left empty
+    extern ActionTypeValues Values[Races::None + 1][Constants::MAX_ACTIONS];
+
     void init();
     const std::vector<ActionType> &  GetAllActionTypes(const RaceID race);
     const ActionType & GetActionType(const RaceID & race, const ActionID & id);
@@ -93,4 +126,41 @@ namespace ActionTypes
     extern ActionType None;
 
 }
-}
\ No newline at end of file
+
+inline const ActionID           ActionType::ID()                    const { return _id; }
+inline const RaceID             ActionType::getRace()               const { return _race; }
+
+inline ActionID                 ActionType::whatBuildsAction()      const { return ActionTypes::Values[_race][_id].whatBuilds; }
+inline ActionType               ActionType::whatBuildsActionType()  const { return ActionType(_race, ActionTypes::Values[_race][_id].whatBuilds); }
+inline ActionType               ActionType::requiredAddonType()     const { return ActionType(_race, ActionTypes::Values[_race][_id].requiredAddon); }
+inline const PrerequisiteSet &  ActionType::getPrerequisites()      const { return *ActionTypes::Values[_race][_id].prerequisites; }
+
+inline FrameCountType           ActionType::buildTime()             const { return ActionTypes::Values[_race][_id].buildTime; }
+inline ResourceCountType        ActionType::mineralPrice()          const { return ActionTypes::Values[_race][_id].mineralPrice; }
+inline ResourceCountType        ActionType::mineralPriceScaled()    const { return ActionTypes::Values[_race][_id].mineralPrice * 100; }
+inline ResourceCountType        ActionType::gasPrice()              const { return ActionTypes::Values[_race][_id].gasPrice; }
+inline ResourceCountType        ActionType::gasPriceScaled()        const { return ActionTypes::Values[_race][_id].gasPrice * 100; }
+inline SupplyCountType          ActionType::supplyRequired()        const { return ActionTypes::Values[_race][_id].supplyRequired; }
+inline SupplyCountType          ActionType::supplyProvided()        const { return ActionTypes::Values[_race][_id].supplyProvided; }
+inline UnitCountType            ActionType::numProduced()           const { return ActionTypes::Values[_race][_id].numProduced; }
+
+inline bool                     ActionType::isRefinery()            const { return ActionTypes::Values[_race][_id].refinery; }
+inline bool                     ActionType::isWorker()              const { return ActionTypes::Values[_race][_id].worker; }
+inline bool                     ActionType::isBuilding()            const { return ActionTypes::Values[_race][_id].building; }
+inline bool                     ActionType::isResourceDepot()       const { return ActionTypes::Values[_race][_id].resourceDepot; }
+inline bool                     ActionType::isSupplyProvider()      const { return ActionTypes::Values[_race][_id].supplyProvider; }
+inline bool                     ActionType::isUnit()                const { return ActionTypes::Values[_race][_id].unit; }
+inline bool                     ActionType::isTech()                const { return ActionTypes::Values[_race][_id].tech; }
+inline bool                     ActionType::isUpgrade()             const { return ActionTypes::Values[_race][_id].upgrade; }
+inline bool                     ActionType::whatBuildsIsBuilding()  const { return ActionTypes::Values[_race][_id].whatBuildsIsBuilding; }
+inline bool                     ActionType::whatBuildsIsLarva()     const { return ActionTypes::Values[_race][_id].whatBuildsIsLarva; }
+inline bool                     ActionType::canProduce()            const { return ActionTypes::Values[_race][_id].canProduce; }
+inline bool                     ActionType::isAddon()               const { return ActionTypes::Values[_race][_id].addon; }
+inline bool                     ActionType::requiresAddon()         const { return ActionTypes::Values[_race][_id].requiresAddon; }
+inline bool                     ActionType::isMorphed()             const { return ActionTypes::Values[_race][_id].morphed; }
+
+inline const bool ActionType::operator == (const ActionType & rhs)  const { return _race == rhs._race && _id == rhs._id; }
+inline const bool ActionType::operator != (const ActionType & rhs)  const { return _race != rhs._race || _id != rhs._id; }
+inline const bool ActionType::operator <  (const ActionType & rhs)  const { return _id < rhs._id; }
+
+}
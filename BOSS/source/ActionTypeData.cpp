@@ -441,12 +441,13 @@ void ActionTypeData::AddPrerequisites()
 
             for (size_t p(0); p<pre.size(); ++p)
             {
-                const ActionType & preActionType = pre.getActionType(p);
+                // read the data, ActionTypes::init() hasn't filled the tables the ActionType accessors read yet
+                const ActionTypeData & preData = allActionTypeDataVec[r][pre.getActionType(p).ID()];
 
                 // the addon has to be an addon of the building that construct the unit
-                if (preActionType.isAddon() && (preActionType.whatBuildsAction() == typeData.whatBuildsActionID))
+                if (preData.isAddon() && (preData.whatBuildsAction() == typeData.whatBuildsActionID))
                 {
-                    typeData.setRequiredAddon(true, preActionType.ID());
+                    typeData.setRequiredAddon(true, preData.getActionID());
                 }
             }
         }
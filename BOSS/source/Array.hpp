@@ -5,41 +5,52 @@
 
 namespace BOSS
 {
+// Fixed capacity vector, stored inline so that the states of the search stacks don't allocate.
+// Copies only copy the elements in use, since most of the capacity usually isn't.
 template <class T,size_t max_capacity>
 class Vec
 {
-    size_t	_size;
-    size_t  _capacity;
-    T		_arr[max_capacity];
+    unsigned short  _size;
+    T		        _arr[max_capacity];
 
 public:
 
     Vec<T,max_capacity>()
         : _size(0)
-        ,_capacity(max_capacity)
     {
 		BOSS_ASSERT(max_capacity>0, "Vec initializing with capacity = 0");
     }
 
     Vec<T,max_capacity>(const size_t & size)
-        : _size(size)
-        ,_capacity(max_capacity)
+        : _size((unsigned short)size)
     {
-        BOSS_ASSERT(size <= max_capacity,"Vec initializing with size > capacity, Size = %d, Capacity = %d",size,_capacity);
+        BOSS_ASSERT(size <= max_capacity,"Vec initializing with size > capacity, Size = %d, Capacity = %d",size,max_capacity);
     }
 
     Vec<T,max_capacity>(const size_t & size,const T & val)
-        : _size(size)
-        ,_capacity(max_capacity)
+        : _size((unsigned short)size)
     {
-        BOSS_ASSERT(size <= max_capacity,"Vec initializing with size > capacity, Size = %d, Capacity = %d",size,_capacity);
+        BOSS_ASSERT(size <= max_capacity,"Vec initializing with size > capacity, Size = %d, Capacity = %d",size,max_capacity);
         fill(val);
     }
+
+    Vec<T,max_capacity>(const Vec<T,max_capacity> & rhs)
+        : _size(rhs._size)
+    {
+        std::copy(rhs._arr, rhs._arr + rhs._size, _arr);
+    }
+
+    Vec<T,max_capacity> & operator = (const Vec<T,max_capacity> & rhs)
+    {
+        _size = rhs._size;
+        std::copy(rhs._arr, rhs._arr + rhs._size, _arr);
+        return *this;
+    }
     
     void resize(const size_t & size)
     {
-        BOSS_ASSERT(size <= max_capacity,"Vec resizing with size > capacity, Size = %d, Cpacity = %d",size,_capacity);
-        _size = size;
+        BOSS_ASSERT(size <= max_capacity,"Vec resizing with size > capacity, Size = %d, Cpacity = %d",size,max_capacity);
+        _size = (unsigned short)size;
     }
 
     T & get(const size_t & index)
@@ -80,7 +91,7 @@ public:
     void addSorted(const T & e)
     {
         size_t index(0);
-        while (_arr[index] < e)
+        while (index < _size && _arr[index] < e)
         {
             ++index;
         }
@@ -100,7 +111,7 @@ public:
     void copyShiftRight(const size_t & index)
     {
         BOSS_ASSERT(_size < capacity(),"Array over capacity: Size = %d",capacity());
-        for (size_t i(_size + 1); i > index; --i)
+        for (size_t i(_size); i > index; --i)
         {
             _arr[i] = _arr[i-1];
         }
@@ -119,9 +130,9 @@ public:
         _size--;
     }
     
-    const size_t & capacity() const
+    size_t capacity() const
     {
-        return _capacity;
+        return max_capacity;
     }
 
     void push_back(const T & e)
@@ -178,7 +189,7 @@ public:
         _size = 0;
     }
 
-    const size_t & size() const
+    size_t size() const
     {
         return _size;
     }
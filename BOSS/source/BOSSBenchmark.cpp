@@ -0,0 +1,412 @@
+#include "BOSSBenchmark.h"
+#include "BOSSParameters.h"
+#include "BuildOrderTester.h"
+#include "CombatSearchExperiment.h"
+#include "JSONTools.h"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <map>
+#include <iomanip>
+
+using namespace BOSS;
+
+namespace
+{
+    // jobs faster than this in the baseline are too noisy to compare times
+    const double MinComparedMS = 10;
+
+    std::string CSVField(std::string field)
+    {
+        for (char & c : field)
+        {
+            if (c == ',' || c == '\n' || c == '"')
+            {
+                c = ' ';
+            }
+        }
+
+        return field;
+    }
+
+    std::vector<std::string> SplitCSVLine(const std::string & line)
+    {
+        std::vector<std::string> fields;
+        std::stringstream ss(line);
+        std::string field;
+        while (std::getline(ss, field, ','))
+        {
+            fields.push_back(field);
+        }
+
+        return fields;
+    }
+
+    const char * CSVHeader = "name,type,race,solved,valid,skipped,nodes,time_ms,nodes_per_sec,first_ms,best_ms,makespan,value";
+}
+
+Benchmark::Result::Result()
+    : solved(false)
+    , valid(true)
+    , skipped(false)
+    , nodes(0)
+    , timeMS(0)
+    , firstMS(-1)
+    , bestMS(-1)
+    , makespan(-1)
+    , value(0)
+{
+
+}
+
+double Benchmark::Result::nodesPerSecond() const
+{
+    return timeMS > 0 ? (1000.0 * nodes / timeMS) : 0;
+}
+
+Benchmark::Options::Options()
+    : threads(std::max(1u, std::thread::hardware_concurrency()))
+    , randomGoals(10)
+    , timeLimit(2000)
+    , tolerance(0.25)
+{
+
+}
+
+std::vector<Benchmark::Job> Benchmark::GetRandomGoalJobs(const RaceID race, const size_t numGoals, const int timeLimit)
+{
+    // the start state and goals of BuildOrderTester::BenchmarkDFBB
+    GameState startState(race);
+    startState.setStartingState();
+    startState.addCompletedAction(ActionTypes::GetWorker(race), 5);
+    startState.addCompletedAction(ActionTypes::GetSupplyProvider(race));
+
+    // goals are made here, not in the jobs, since rand() isn't shared well between threads
+    srand(race + 1);
+    std::vector<Job> jobs;
+    for (size_t i(0); i < numGoals; ++i)
+    {
+        const BuildOrderSearchGoal goal = BuildOrderTester::GetRandomGoal(race);
+        const std::string name = Races::GetRaceName(race) + " goal " + std::to_string(i);
+
+        jobs.push_back([=]()
+        {
+            Result result;
+            result.name = name;
+            result.type = "DFBB";
+            result.race = Races::GetRaceName(race);
+
+            try
+            {
+                DFBB_BuildOrderSmartSearch search(race);
+                search.setState(startState);
+                search.setGoal(goal);
+                search.setTimeLimit(timeLimit);
+                search.search();
+
+                const DFBB_BuildOrderSearchResults & results = search.getResults();
+                result.solved = results.solved;
+                result.nodes = results.nodesExpanded;
+                result.timeMS = results.timeElapsed;
+                result.makespan = results.upperBound;
+
+                if (!results.improvements.empty())
+                {
+                    result.firstMS = results.improvements.front().first;
+                    result.bestMS = results.improvements.back().first;
+                }
+
+                // the same check as BuildOrderTester::DoRandomTests
+                if (!results.buildOrder.empty())
+                {
+                    GameState state(startState);
+                    result.valid = results.buildOrder.doActions(state) && goal.isAchievedBy(state);
+                }
+            }
+            catch (const BOSSException &)
+            {
+                // some random goals can't be planned by the naive search that gives the upper bound
+                result.skipped = true;
+            }
+
+            return result;
+        });
+    }
+
+    return jobs;
+}
+
+std::vector<Benchmark::Job> Benchmark::GetCombatSearchJobs(const std::string & configFile)
+{
+    BOSSParameters::Instance().ParseParameters(configFile);
+
+    rapidjson::Document document;
+    JSONTools::ParseJSONFile(document, configFile);
+
+    std::vector<Job> jobs;
+    if (!document.HasMember("Experiments"))
+    {
+        return jobs;
+    }
+
+    const rapidjson::Value & experiments = document["Experiments"];
+    for (rapidjson::Value::ConstMemberIterator itr = experiments.MemberBegin(); itr != experiments.MemberEnd(); ++itr)
+    {
+        const rapidjson::Value & val = itr->value;
+
+        if (!val.HasMember("Type") || !val["Type"].IsString() || std::string(val["Type"].GetString()) != "CombatSearch" ||
+            !val.HasMember("Run") || !val["Run"].IsBool() || !val["Run"].GetBool())
+        {
+            continue;
+        }
+
+        // the experiment is read here, where the parameters singleton is safe to use
+        std::shared_ptr<CombatSearchExperiment> experiment(new CombatSearchExperiment(itr->name.GetString(), val));
+        const std::string race = val.HasMember("Race") && val["Race"].IsString() ? val["Race"].GetString() : "";
+
+        for (const std::string & searchType : experiment->getSearchTypes())
+        {
+            jobs.push_back([=]()
+            {
+                Result result;
+                result.name = experiment->getName() + " " + searchType;
+                result.type = searchType;
+                result.race = race;
+
+                std::shared_ptr<CombatSearch> search = experiment->makeSearch(searchType);
+                search->search();
+
+                const CombatSearchResults & results = search->getResults();
+                result.solved = results.solved;
+                result.nodes = results.nodesExpanded;
+                result.timeMS = results.timeElapsed;
+                result.value = results.highestEval;
+
+                return result;
+            });
+        }
+    }
+
+    return jobs;
+}
+
+std::vector<Benchmark::Result> Benchmark::RunJobs(const std::vector<Job> & jobs, const size_t numThreads)
+{
+    std::vector<Result> results(jobs.size());
+    std::atomic<size_t> nextJob(0);
+    std::mutex printMutex;
+
+    auto worker = [&]()
+    {
+        for (size_t j = nextJob++; j < jobs.size(); j = nextJob++)
+        {
+            results[j] = jobs[j]();
+
+            std::lock_guard<std::mutex> lock(printMutex);
+            const Result & r = results[j];
+            std::cout << r.name << " [" << r.type << "] " << r.nodes << " nodes " << r.timeMS << "ms";
+            if (r.makespan >= 0)
+            {
+                std::cout << " makespan " << r.makespan;
+            }
+            if (r.value > 0)
+            {
+                std::cout << " value " << r.value;
+            }
+            std::cout << (r.skipped ? " (skipped)" : r.solved ? "" : " (timed out)") << (r.valid ? "" : " (INVALID)") << std::endl;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t t(1); t < std::min(numThreads, jobs.size()); ++t)
+    {
+        threads.push_back(std::thread(worker));
+    }
+
+    worker();
+
+    for (std::thread & thread : threads)
+    {
+        thread.join();
+    }
+
+    return results;
+}
+
+std::vector<Benchmark::Result> Benchmark::Run(const Options & options)
+{
+    std::vector<Job> jobs;
+    for (RaceID race(0); race < Races::NUM_RACES; ++race)
+    {
+        const std::vector<Job> raceJobs = GetRandomGoalJobs(race, options.randomGoals, options.timeLimit);
+        jobs.insert(jobs.end(), raceJobs.begin(), raceJobs.end());
+    }
+
+    if (!options.configFile.empty())
+    {
+        const std::vector<Job> combatJobs = GetCombatSearchJobs(options.configFile);
+        jobs.insert(jobs.end(), combatJobs.begin(), combatJobs.end());
+    }
+
+    std::cout << "Running " << jobs.size() << " jobs on " << options.threads << " threads\n";
+    return RunJobs(jobs, options.threads);
+}
+
+void Benchmark::WriteCSV(const std::vector<Result> & results, const std::string & filename)
+{
+    std::ofstream outFile(filename);
+    BOSS_ASSERT(outFile.good(), "Couldn't open benchmark results file: %s", filename.c_str());
+    outFile << std::setprecision(12);
+
+    outFile << CSVHeader << "\n";
+    for (const Result & r : results)
+    {
+        outFile << CSVField(r.name) << "," << CSVField(r.type) << "," << CSVField(r.race) << "," << r.solved << "," << r.valid << "," << r.skipped << ","
+                << r.nodes << "," << r.timeMS << "," << r.nodesPerSecond() << "," << r.firstMS << "," << r.bestMS << ","
+                << r.makespan << "," << r.value << "\n";
+    }
+}
+
+void Benchmark::WriteJSON(const std::vector<Result> & results, const std::string & filename)
+{
+    std::ofstream outFile(filename);
+    BOSS_ASSERT(outFile.good(), "Couldn't open benchmark results file: %s", filename.c_str());
+    outFile << std::setprecision(12);
+
+    outFile << "[\n";
+    for (size_t i(0); i < results.size(); ++i)
+    {
+        const Result & r = results[i];
+        outFile << "    { \"name\" : \"" << CSVField(r.name) << "\", \"type\" : \"" << CSVField(r.type) << "\", \"race\" : \"" << CSVField(r.race) << "\""
+                << ", \"solved\" : " << (r.solved ? "true" : "false") << ", \"valid\" : " << (r.valid ? "true" : "false")
+                << ", \"skipped\" : " << (r.skipped ? "true" : "false")
+                << ", \"nodes\" : " << r.nodes << ", \"timeMS\" : " << r.timeMS << ", \"nodesPerSec\" : " << r.nodesPerSecond()
+                << ", \"firstMS\" : " << r.firstMS << ", \"bestMS\" : " << r.bestMS
+                << ", \"makespan\" : " << r.makespan << ", \"value\" : " << r.value << " }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    outFile << "]\n";
+}
+
+std::vector<Benchmark::Result> Benchmark::ReadCSV(const std::string & filename)
+{
+    std::ifstream inFile(filename);
+    BOSS_ASSERT(inFile.good(), "Couldn't open benchmark baseline file: %s", filename.c_str());
+
+    std::vector<Result> results;
+    std::string line;
+    std::getline(inFile, line);
+    BOSS_ASSERT(line == CSVHeader, "Benchmark baseline file has the wrong header: %s", filename.c_str());
+
+    while (std::getline(inFile, line))
+    {
+        const std::vector<std::string> fields = SplitCSVLine(line);
+        if (fields.size() != 13)
+        {
+            continue;
+        }
+
+        Result r;
+        r.name      = fields[0];
+        r.type      = fields[1];
+        r.race      = fields[2];
+        r.solved    = fields[3] == "1";
+        r.valid     = fields[4] == "1";
+        r.skipped   = fields[5] == "1";
+        r.nodes     = std::stoull(fields[6]);
+        r.timeMS    = std::stod(fields[7]);
+        r.firstMS   = std::stod(fields[9]);
+        r.bestMS    = std::stod(fields[10]);
+        r.makespan  = std::stoi(fields[11]);
+        r.value     = std::stod(fields[12]);
+        results.push_back(r);
+    }
+
+    return results;
+}
+
+size_t Benchmark::CompareToBaseline(const std::vector<Result> & results, const std::vector<Result> & baseline, const double tolerance)
+{
+    std::map<std::string, const Result *> baselineByName;
+    for (const Result & r : baseline)
+    {
+        baselineByName[r.name] = &r;
+    }
+
+    size_t regressions = 0;
+    size_t compared = 0;
+    double totalTime = 0;
+    double totalBaselineTime = 0;
+
+    for (const Result & r : results)
+    {
+        auto it = baselineByName.find(r.name);
+        if (it == baselineByName.end())
+        {
+            std::cout << r.name << ": not in the baseline\n";
+            continue;
+        }
+
+        const Result & b = *it->second;
+
+        // a job skipped in either run has nothing to compare
+        if (r.skipped || b.skipped)
+        {
+            if (r.skipped && !b.skipped)
+            {
+                std::cout << r.name << ": REGRESSION skipped\n";
+                ++regressions;
+            }
+            continue;
+        }
+
+        ++compared;
+
+        std::vector<std::string> problems;
+        if (!r.valid && b.valid)
+        {
+            problems.push_back("invalid build order");
+        }
+
+        if (b.solved && !r.solved)
+        {
+            problems.push_back("no longer solved");
+        }
+
+        if (r.solved && b.solved)
+        {
+            if (r.makespan > b.makespan || r.value < b.value)
+            {
+                problems.push_back("worse result");
+            }
+            else if (r.makespan < b.makespan || r.value > b.value)
+            {
+                std::cout << r.name << ": better result\n";
+            }
+
+            totalTime += r.timeMS;
+            totalBaselineTime += b.timeMS;
+
+            if (b.timeMS >= MinComparedMS && r.timeMS > b.timeMS * (1 + tolerance))
+            {
+                problems.push_back("slower, " + std::to_string(r.timeMS) + "ms vs " + std::to_string(b.timeMS) + "ms");
+            }
+        }
+
+        for (const std::string & problem : problems)
+        {
+            std::cout << r.name << ": REGRESSION " << problem << "\n";
+        }
+
+        regressions += problems.empty() ? 0 : 1;
+    }
+
+    std::cout << compared << " jobs compared, " << regressions << " regressions";
+    if (totalBaselineTime > 0)
+    {
+        std::cout << ", solved jobs took " << totalTime << "ms vs " << totalBaselineTime << "ms";
+    }
+    std::cout << "\n";
+
+    return regressions;
+}
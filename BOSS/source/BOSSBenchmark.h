@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Common.h"
+#include "BOSS.h"
+#include <functional>
+
+namespace BOSS
+{
+
+// Batch runs of the searches, for performance regression tests.
+// Jobs are random DFBB goals, like BuildOrderTester::BenchmarkDFBB, and the combat search
+// experiments of a config file. They run on a pool of threads and the results are written
+// as CSV or JSON. A CSV from an earlier run can be given as a baseline to compare against.
+namespace Benchmark
+{
+    class Result
+    {
+    public:
+
+        std::string         name;           // unique within a run, jobs are matched to the baseline by name
+        std::string         type;           // DFBB or the combat search type
+        std::string         race;
+        bool                solved;         // finished within the time limit
+        bool                valid;          // the plan found is legal and reaches the goal
+        bool                skipped;        // the job couldn't be run, the other fields mean nothing
+        unsigned long long  nodes;
+        double              timeMS;
+        double              firstMS;        // time to the first and the best solution, -1 if unknown
+        double              bestMS;
+        int                 makespan;       // DFBB finish frame, -1 for combat searches
+        double              value;          // combat search army integral, 0 for DFBB
+
+        Result();
+
+        double nodesPerSecond() const;
+    };
+
+    class Options
+    {
+    public:
+
+        size_t              threads;
+        size_t              randomGoals;    // per race
+        int                 timeLimit;      // milliseconds per DFBB search
+        std::string         configFile;     // combat search experiments, none if empty
+        double              tolerance;      // a job this much slower than the baseline is a regression
+
+        Options();
+    };
+
+    typedef std::function<Result()> Job;
+
+    // the same goals for the same number of goals, so that runs can be compared
+    std::vector<Job> GetRandomGoalJobs(const RaceID race, const size_t numGoals, const int timeLimit);
+
+    // one job per search type of each experiment in the config with "Run" true
+    std::vector<Job> GetCombatSearchJobs(const std::string & configFile);
+
+    // results are in the order of the jobs, whatever order they finish in
+    std::vector<Result> RunJobs(const std::vector<Job> & jobs, const size_t numThreads);
+
+    std::vector<Result> Run(const Options & options);
+
+    void WriteCSV(const std::vector<Result> & results, const std::string & filename);
+    void WriteJSON(const std::vector<Result> & results, const std::string & filename);
+    std::vector<Result> ReadCSV(const std::string & filename);
+
+    // prints the differences and returns the number of regressions: a job that solved in
+    // the baseline but not now, a worse makespan or value, or a slowdown beyond the tolerance
+    size_t CompareToBaseline(const std::vector<Result> & results, const std::vector<Result> & baseline, const double tolerance);
+}
+
+}
@@ -0,0 +1,87 @@
+#include "BOSS.h"
+#include "BOSSBenchmark.h"
+
+#include <cstdlib>
+
+using namespace BOSS;
+
+// Batch benchmark of the searches, built by Makefile.linux. For example
+//
+//   BOSS_bench --random 20 --time-limit 5000 --csv baseline.csv
+//   ... change the search ...
+//   BOSS_bench --random 20 --time-limit 5000 --csv new.csv --baseline baseline.csv
+//
+// Times are wall clock, so compare runs with the same number of threads, at most one per core.
+// The exit code is the number of regressions against the baseline, capped at 100.
+
+void PrintUsage()
+{
+    std::cout << "Usage: BOSS_bench [options]\n"
+              << "  --threads N         jobs run at the same time, default one per core\n"
+              << "  --random N          random DFBB goals per race, default 10\n"
+              << "  --time-limit MS     time limit of each DFBB search, default 2000\n"
+              << "  --config FILE       also run the combat search experiments in a BOSS config file\n"
+              << "  --csv FILE          write the results as CSV\n"
+              << "  --json FILE         write the results as JSON\n"
+              << "  --baseline FILE     compare the results to the CSV of an earlier run\n"
+              << "  --tolerance X       a job more than this fraction slower than the baseline is a regression, default 0.25\n";
+}
+
+int main(int argc, char *argv[])
+{
+    Benchmark::Options options;
+    std::string csvFile;
+    std::string jsonFile;
+    std::string baselineFile;
+
+    for (int i(1); i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+
+        if (i + 1 >= argc)
+        {
+            PrintUsage();
+            return 1;
+        }
+
+        const std::string val = argv[++i];
+
+        if      (arg == "--threads")    { options.threads = std::max(1, atoi(val.c_str())); }
+        else if (arg == "--random")     { options.randomGoals = std::max(0, atoi(val.c_str())); }
+        else if (arg == "--time-limit") { options.timeLimit = atoi(val.c_str()); }
+        else if (arg == "--config")     { options.configFile = val; }
+        else if (arg == "--csv")        { csvFile = val; }
+        else if (arg == "--json")       { jsonFile = val; }
+        else if (arg == "--baseline")   { baselineFile = val; }
+        else if (arg == "--tolerance")  { options.tolerance = atof(val.c_str()); }
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    // Initialize all the BOSS internal data
+    BWAPI::BWAPI_init();
+    BOSS::init();
+
+    const std::vector<Benchmark::Result> results = Benchmark::Run(options);
+
+    if (!csvFile.empty())
+    {
+        Benchmark::WriteCSV(results, csvFile);
+    }
+
+    if (!jsonFile.empty())
+    {
+        Benchmark::WriteJSON(results, jsonFile);
+    }
+
+    if (!baselineFile.empty())
+    {
+        const size_t regressions = Benchmark::CompareToBaseline(results, Benchmark::ReadCSV(baselineFile), options.tolerance);
+        return (int)std::min(regressions, size_t(100));
+    }
+
+    return 0;
+}
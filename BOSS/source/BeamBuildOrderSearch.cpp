@@ -0,0 +1,262 @@
+#include "BeamBuildOrderSearch.h"
+#include "DFBB_BuildOrderStackSearch.h"
+#include "Tools.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+using namespace BOSS;
+
+BeamBuildOrderSearch::BeamBuildOrderSearch(const DFBB_BuildOrderSearchParameters & p)
+    : _params(p)
+    , _nextNode(0)
+    , _width(0)
+    , _truncated(false)
+    , _firstSearch(true)
+{
+
+}
+
+void BeamBuildOrderSearch::setTimeLimit(double ms)
+{
+    _params.searchTimeLimit = ms;
+}
+
+const DFBB_BuildOrderSearchResults & BeamBuildOrderSearch::getResults() const
+{
+    return _results;
+}
+
+void BeamBuildOrderSearch::search()
+{
+    _searchTimer.start();
+
+    if (_results.finished)
+    {
+        return;
+    }
+
+    if (_firstSearch)
+    {
+        _results.upperBound = _params.initialUpperBound ? _params.initialUpperBound : Tools::GetUpperBound(_params.initialState, _params.goal, &_results.upperBoundCached);
+        _results.upperBoundTime = _searchTimer.getElapsedTimeInMilliSec();
+
+        // add one frame to the upper bound so our strictly lesser than check still works if we have an exact upper bound
+        _results.upperBound += 1;
+
+        _lowerBoundTable.init(_params.goal, _params.initialState.getRace(), LOWER_BOUND_TABLE_SIZE);
+        _width = std::max(_params.beamWidth, (size_t)1);
+        _firstSearch = false;
+
+        startPass();
+    }
+
+    _results.timedOut = false;
+
+    while (true)
+    {
+        while (_nextNode < _beam.size())
+        {
+            _results.nodesExpanded++;
+
+            // the beam stays as it is, so the next call carries on from this state
+            if (isTimeOut())
+            {
+                _results.timedOut = true;
+                _results.timeElapsed = _searchTimer.getElapsedTimeInMilliSec();
+                return;
+            }
+
+            expand(_beam[_nextNode]);
+            ++_nextNode;
+        }
+
+        if (!_children.empty())
+        {
+            nextDepth();
+            continue;
+        }
+
+        // a pass that kept every child it didn't prune has searched the whole tree
+        if (!_truncated || _width >= _params.maxBeamWidth)
+        {
+            break;
+        }
+
+        _width = std::min(_width * 2, std::max(_params.maxBeamWidth, (size_t)1));
+        startPass();
+    }
+
+    // only a pass that dropped nothing proves there is no better plan
+    _results.solved = !_truncated;
+    _results.finished = true;
+    _results.timeElapsed = _searchTimer.getElapsedTimeInMilliSec();
+}
+
+bool BeamBuildOrderSearch::isTimeOut()
+{
+    if (_results.nodesExpanded % 200 != 0)
+    {
+        return false;
+    }
+
+    return (_params.stopFlag && *_params.stopFlag) || (_params.searchTimeLimit && (_searchTimer.getElapsedTimeInMilliSec() > _params.searchTimeLimit));
+}
+
+// Start over from the initial state with the current width. The best plan so far stays as the bound.
+void BeamBuildOrderSearch::startPass()
+{
+    const GameState & state = _params.initialState;
+    const Step none = { -1, 0, 0 };
+
+    _steps.clear();
+    _beam.clear();
+    _children.clear();
+    _beam.emplace_back(state, none, 0, state.getCurrentFrame() + _lowerBoundTable.getLowerBound(state, _params.goal));
+    _nextNode = 0;
+    _truncated = false;
+}
+
+// Add the children of a state that could still beat the best plan to _children.
+void BeamBuildOrderSearch::expand(const Node & node)
+{
+    if (node.lowerBound >= _results.upperBound)
+    {
+        return;
+    }
+
+    ActionSet legalActions;
+    DFBB_BuildOrderStackSearch::GenerateLegalActions(_params, node.state, legalActions);
+
+    for (size_t a(0); a < legalActions.size(); ++a)
+    {
+        const ActionType & action = legalActions[a];
+
+        const FrameCountType actionFinishTime = node.state.whenCanPerform(action) + action.buildTime();
+        if (std::max(actionFinishTime, node.lowerBound) >= _results.upperBound)
+        {
+            continue;
+        }
+
+        const UnitCountType repetitions = DFBB_BuildOrderStackSearch::GetRepetitions(_params, node.state, action);
+        BOSS_ASSERT(repetitions > 0, "Can't have zero repetitions!");
+
+        // do the action as many times as legal to 'repeat', as DFBB does
+        GameState child(node.state);
+        Step last = { node.step, action.ID(), 0 };
+        for (; last.repetitions < repetitions && child.isLegal(action); ++last.repetitions)
+        {
+            child.doAction(action);
+        }
+
+        if (_params.goal.isAchievedBy(child))
+        {
+            if (child.getLastActionFinishTime() < _results.upperBound)
+            {
+                BuildOrder buildOrder = getBuildOrder(node.step);
+                for (UnitCountType r(0); r < last.repetitions; ++r)
+                {
+                    buildOrder.add(action);
+                }
+
+                updateResults(child, buildOrder);
+            }
+
+            continue;
+        }
+
+        const FrameCountType frame = child.getCurrentFrame();
+        const FrameCountType lowerBound = frame + _lowerBoundTable.getLowerBound(child, _params.goal);
+        if (lowerBound >= _results.upperBound)
+        {
+            continue;
+        }
+
+        _children.emplace_back(child, last, frame + _params.beamWeight * (lowerBound - frame), lowerBound);
+    }
+}
+
+// Keep the best _width children as the beam of the next depth.
+// A child is dropped if a kept one has the same hash and at least its resources, as in the transposition table.
+void BeamBuildOrderSearch::nextDepth()
+{
+    // sort indices, the states are too big to move around
+    std::vector<size_t> order(_children.size());
+    for (size_t i(0); i < order.size(); ++i)
+    {
+        order[i] = i;
+    }
+
+    std::stable_sort(order.begin(), order.end(), [this](const size_t a, const size_t b)
+    {
+        const Node & na = _children[a];
+        const Node & nb = _children[b];
+        return na.rank < nb.rank || (na.rank == nb.rank && na.lowerBound < nb.lowerBound);
+    });
+
+    _beam.clear();
+    std::unordered_map<HashType, size_t> kept;
+    for (const size_t i : order)
+    {
+        if (_beam.size() >= _width)
+        {
+            _truncated = true;
+            break;
+        }
+
+        Node & child = _children[i];
+        const HashType hash = child.state.getHash();
+        auto same = kept.find(hash);
+        if (same != kept.end())
+        {
+            const GameState & other = _beam[same->second].state;
+            if (other.getMinerals() >= child.state.getMinerals() && other.getGas() >= child.state.getGas())
+            {
+                continue;
+            }
+        }
+
+        _steps.push_back(child.last);
+        child.step = (int)_steps.size() - 1;
+        kept.emplace(hash, _beam.size());
+        _beam.push_back(std::move(child));
+    }
+
+    _children.clear();
+    _nextNode = 0;
+}
+
+BuildOrder BeamBuildOrderSearch::getBuildOrder(int step) const
+{
+    std::vector<const Step *> path;
+    for (; step >= 0; step = _steps[step].parent)
+    {
+        path.push_back(&_steps[step]);
+    }
+
+    BuildOrder buildOrder;
+    for (auto it = path.rbegin(); it != path.rend(); ++it)
+    {
+        const ActionType & action = ActionTypes::GetActionType(_params.initialState.getRace(), (*it)->action);
+        for (UnitCountType r(0); r < (*it)->repetitions; ++r)
+        {
+            buildOrder.add(action);
+        }
+    }
+
+    return buildOrder;
+}
+
+void BeamBuildOrderSearch::updateResults(const GameState & state, const BuildOrder & buildOrder)
+{
+    const FrameCountType finishTime = state.getLastActionFinishTime();
+
+    _results.timeElapsed = _searchTimer.getElapsedTimeInMilliSec();
+    _results.upperBound = finishTime;
+    _results.solutionFound = true;
+    _results.finalState = state;
+    _results.buildOrder = buildOrder;
+    _results.improvements.push_back(std::make_pair(_results.timeElapsed, finishTime));
+
+    _results.printResults(true);
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Common.h"
+#include "ActionType.h"
+#include "DFBB_BuildOrderSearchResults.h"
+#include "DFBB_BuildOrderSearchParameters.h"
+#include "Timer.hpp"
+#include "BuildOrder.h"
+#include "LowerBoundTable.h"
+
+namespace BOSS
+{
+
+// Anytime beam search for goals too large for DFBB to finish.
+// The search goes one depth at a time, expanding every state of the beam with the same children
+// and repetitions as DFBB. Of the children, only the beamWidth ranked best by
+// frame + beamWeight * lower bound are kept for the next depth. Children that can't beat the best
+// plan found so far are pruned, as in DFBB. When the beam is empty the width doubles and the
+// search starts over, keeping its best plan as the bound, until maxBeamWidth has been searched.
+// The results are only solved if the last pass dropped no child; otherwise they are just finished.
+// Only the states of two depths are kept; earlier depths keep one step per state for the build order.
+class BeamBuildOrderSearch
+{
+    class Step
+    {
+    public:
+
+        int                 parent;         // index of the step before, -1 at the initial state
+        ActionID            action;
+        UnitCountType       repetitions;
+    };
+
+    class Node
+    {
+    public:
+
+        GameState           state;
+        Step                last;           // the step to this state, added to _steps if the state is kept
+        int                 step;           // index of last in _steps, -1 for the initial state
+        double              rank;           // lower is expanded first
+        FrameCountType      lowerBound;     // earliest frame the goal could be met from this state
+
+        Node(const GameState & s, const Step & l, const double r, const FrameCountType lb)
+            : state(s)
+            , last(l)
+            , step(-1)
+            , rank(r)
+            , lowerBound(lb)
+        {
+
+        }
+    };
+
+    DFBB_BuildOrderSearchParameters     _params;
+    DFBB_BuildOrderSearchResults        _results;
+
+    Timer                               _searchTimer;
+    LowerBoundTable                     _lowerBoundTable;
+
+    std::vector<Step>                   _steps;
+    std::vector<Node>                   _beam;          // the states of the current depth
+    std::vector<Node>                   _children;      // the children of the beam expanded so far
+    size_t                              _nextNode;      // the next state of the beam to expand
+    size_t                              _width;
+    bool                                _truncated;     // did this pass drop any child that wasn't pruned?
+    bool                                _firstSearch;
+
+    bool                                isTimeOut();
+    void                                startPass();
+    void                                expand(const Node & node);
+    void                                nextDepth();
+    BuildOrder                          getBuildOrder(int step) const;
+    void                                updateResults(const GameState & state, const BuildOrder & buildOrder);
+
+public:
+
+    BeamBuildOrderSearch(const DFBB_BuildOrderSearchParameters & p);
+
+    void setTimeLimit(double ms);
+
+    // resumes where the last call timed out, like DFBB_BuildOrderStackSearch::search
+    void search();
+    const DFBB_BuildOrderSearchResults & getResults() const;
+};
+
+}
@@ -0,0 +1,207 @@
+#include "BuildOrderGoalComparison.h"
+#include "NaiveBuildOrderSearch.h"
+
+#include <thread>
+
+using namespace BOSS;
+
+BuildOrderGoalComparison::Plan::Plan()
+    : makespan(-1)
+    , optimal(false)
+    , naive(false)
+    , nodesExpanded(0)
+{
+
+}
+
+BuildOrderGoalComparison::BuildOrderGoalComparison(const GameState & state, const std::vector<BuildOrderSearchGoal> & goals)
+    : _initialState(state)
+    , _goals(goals)
+    , _failed(goals.size(), false)
+    , _plans(goals.size())
+    , _timeLimit(0)
+    , _sliceTime(50)
+    , _numThreads(1)
+    , _stopFlag(nullptr)
+{
+    for (const BuildOrderSearchGoal & goal : _goals)
+    {
+        _searches.emplace_back(new DFBB_BuildOrderSmartSearch(state.getRace()));
+        _searches.back()->setState(state);
+        _searches.back()->setGoal(goal);
+
+        // the searches are usually stopped before they finish, so search the children that look closest to the goal first
+        _searches.back()->setChildOrder(ChildOrders::ClosestToGoal);
+    }
+}
+
+void BuildOrderGoalComparison::setTimeLimit(double ms)
+{
+    _timeLimit = ms;
+}
+
+void BuildOrderGoalComparison::setSliceTime(int ms)
+{
+    _sliceTime = std::max(ms, 1);
+}
+
+void BuildOrderGoalComparison::setNumThreads(size_t n)
+{
+    _numThreads = std::max(n, (size_t)1);
+}
+
+void BuildOrderGoalComparison::setStopFlag(const std::atomic<bool> * stopFlag)
+{
+    _stopFlag = stopFlag;
+}
+
+DFBB_BuildOrderSmartSearch & BuildOrderGoalComparison::getSearch(const size_t goal)
+{
+    BOSS_ASSERT(goal < _searches.size(), "Goal index out of range: %d", (int)goal);
+
+    return *_searches[goal];
+}
+
+const std::vector<BuildOrderGoalComparison::Plan> & BuildOrderGoalComparison::getPlans() const
+{
+    return _plans;
+}
+
+int BuildOrderGoalComparison::getFastestGoal() const
+{
+    int fastest = -1;
+    for (size_t g(0); g < _plans.size(); ++g)
+    {
+        if (_plans[g].makespan >= 0 && (fastest < 0 || _plans[g].makespan < _plans[fastest].makespan))
+        {
+            fastest = (int)g;
+        }
+    }
+
+    return fastest;
+}
+
+void BuildOrderGoalComparison::search()
+{
+    _timer.start();
+
+    _queue.clear();
+    for (size_t g(0); g < _goals.size(); ++g)
+    {
+        _queue.push_back(g);
+    }
+
+    std::vector<std::thread> threads;
+    for (size_t t(1); t < std::min(_numThreads, _goals.size()); ++t)
+    {
+        threads.push_back(std::thread(&BuildOrderGoalComparison::searchSlices, this));
+    }
+
+    searchSlices();
+
+    for (std::thread & thread : threads)
+    {
+        thread.join();
+    }
+
+    for (size_t g(0); g < _goals.size(); ++g)
+    {
+        makePlan(g);
+    }
+}
+
+// only called with _queueMutex held, Timer isn't safe to share between threads
+bool BuildOrderGoalComparison::isTimeOut()
+{
+    return (_stopFlag && *_stopFlag) || (_timeLimit > 0 && _timer.getElapsedTimeInMilliSec() >= _timeLimit);
+}
+
+// runs on each thread, until there is no unfinished search left to take or the time is up
+void BuildOrderGoalComparison::searchSlices()
+{
+    while (true)
+    {
+        size_t goal = 0;
+        int sliceTime = _sliceTime;
+
+        {
+            std::lock_guard<std::mutex> lock(_queueMutex);
+            if (_queue.empty() || isTimeOut())
+            {
+                return;
+            }
+
+            goal = _queue.front();
+            _queue.pop_front();
+
+            if (_timeLimit > 0)
+            {
+                sliceTime = std::max(1, std::min(sliceTime, (int)(_timeLimit - _timer.getElapsedTimeInMilliSec())));
+            }
+        }
+
+        bool finished = false;
+        bool failed = false;
+
+        try
+        {
+            // resumes the goal's search where its last slice stopped, or starts it on the first slice
+            DFBB_BuildOrderSmartSearch & search = *_searches[goal];
+            search.setTimeLimit(sliceTime);
+            search.setStopFlag(_stopFlag);
+            search.search();
+            finished = search.getResults().finished;
+        }
+        catch (const BOSSException &)
+        {
+            failed = true;
+        }
+        catch (...)
+        {
+            // anything else escaping a thread would end the program
+            failed = true;
+        }
+
+        std::lock_guard<std::mutex> lock(_queueMutex);
+        _failed[goal] = failed;
+        if (!finished && !failed)
+        {
+            _queue.push_back(goal);
+        }
+    }
+}
+
+// the search's plan, or the naive search's if the search didn't beat it
+void BuildOrderGoalComparison::makePlan(const size_t goal)
+{
+    Plan & plan = _plans[goal];
+    const DFBB_BuildOrderSearchResults & results = _searches[goal]->getResults();
+
+    plan = Plan();
+    plan.nodesExpanded = results.nodesExpanded;
+
+    plan.optimal = results.solved && !_failed[goal];
+
+    try
+    {
+        if (results.solutionFound && !_failed[goal])
+        {
+            plan.buildOrder = results.buildOrder;
+        }
+        else
+        {
+            NaiveBuildOrderSearch naiveSearch(_initialState, _goals[goal]);
+            plan.buildOrder = naiveSearch.solve();
+            plan.naive = true;
+        }
+
+        plan.resources = Tools::GetResourceCurve(_initialState, plan.buildOrder);
+        plan.makespan = plan.resources.back().frame - _initialState.getCurrentFrame();
+    }
+    catch (const BOSSException &)
+    {
+        // some goals can't be planned even by the naive search
+        plan = Plan();
+        plan.nodesExpanded = results.nodesExpanded;
+    }
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Common.h"
+#include "GameState.h"
+#include "BuildOrderSearchGoal.h"
+#include "BuildOrder.h"
+#include "DFBB_BuildOrderSmartSearch.h"
+#include "Tools.h"
+#include "Timer.hpp"
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+namespace BOSS
+{
+
+// Plans several candidate goals from the same state within one time limit, so they can be compared.
+// Each goal has its own DFBB_BuildOrderSmartSearch. The threads take turns at the unfinished searches,
+// one slice at a time, so every goal gets searched even if the time runs out before any is solved.
+// A goal whose search found nothing better in time gets the naive search's plan.
+class BuildOrderGoalComparison
+{
+public:
+
+    class Plan
+    {
+    public:
+
+        BuildOrder                          buildOrder;
+        FrameCountType                      makespan;       // frames from the start state until the goal is met, -1 if there is no plan
+        bool                                optimal;        // the search finished, so no plan meets the goal sooner
+        bool                                naive;          // the plan is the naive search's
+        unsigned long long                  nodesExpanded;
+        std::vector<Tools::ResourcePoint>   resources;      // see Tools::GetResourceCurve
+
+        Plan();
+    };
+
+private:
+
+    GameState                                                   _initialState;
+    std::vector<BuildOrderSearchGoal>                           _goals;
+    std::vector<std::unique_ptr<DFBB_BuildOrderSmartSearch>>    _searches;
+    std::vector<bool>                                           _failed;        // the search threw, written under _queueMutex
+    std::vector<Plan>                                           _plans;
+
+    double                                                      _timeLimit;
+    int                                                         _sliceTime;
+    size_t                                                      _numThreads;
+    const std::atomic<bool> *                                   _stopFlag;
+
+    Timer                                                       _timer;
+    std::mutex                                                  _queueMutex;
+    std::deque<size_t>                                          _queue;         // goals whose search isn't finished or being run
+
+    bool                                                        isTimeOut();
+    void                                                        searchSlices();
+    void                                                        makePlan(const size_t goal);
+
+public:
+
+    BuildOrderGoalComparison(const GameState & state, const std::vector<BuildOrderSearchGoal> & goals);
+
+    // the time for all the goals together, in milliseconds
+    void                                setTimeLimit(double ms);
+
+    // how long a thread searches one goal before it moves on to the next
+    void                                setSliceTime(int ms);
+    void                                setNumThreads(size_t n);
+
+    // the searches stop, as if timed out, when another thread sets the flag
+    void                                setStopFlag(const std::atomic<bool> * stopFlag);
+
+    // to change a goal's search settings before search()
+    DFBB_BuildOrderSmartSearch &        getSearch(const size_t goal);
+
+    // blocks until every goal is solved or the time is up, using the calling thread as one of the threads
+    void                                search();
+
+    // in the order of the goals
+    const std::vector<Plan> &           getPlans() const;
+
+    // the goal whose plan meets it soonest, -1 if no goal has a plan
+    int                                 getFastestGoal() const;
+};
+
+}
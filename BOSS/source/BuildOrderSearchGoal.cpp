@@ -109,7 +109,7 @@ std::string BuildOrderSearchGoal::toString() const
     return ss.str();
 }
 
-bool BuildOrderSearchGoal::isAchievedBy(const GameState & state)
+bool BuildOrderSearchGoal::isAchievedBy(const GameState & state) const
 {
     static const ActionType & Hatchery      = ActionTypes::GetActionType("Zerg_Hatchery");
     static const ActionType & Lair          = ActionTypes::GetActionType("Zerg_Lair");
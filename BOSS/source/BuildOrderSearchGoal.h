@@ -24,7 +24,7 @@ public:
 	
 	bool                operator == (const BuildOrderSearchGoal & g);
 	bool                hasGoal() const;
-    bool                isAchievedBy(const GameState & state);
+    bool                isAchievedBy(const GameState & state) const;
 
 	SupplyCountType     supplyRequired() const;
 	UnitCountType       operator [] (const ActionID & a) const;
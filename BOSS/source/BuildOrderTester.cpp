@@ -45,7 +45,7 @@ void BuildOrderTester::TestRandomBuilds(const RaceID race, const size_t numTests
 {
     for (size_t i(0); i < numTests; ++i)
     {
-        GameState state = GetStartState(race, 20);            
+        GetStartState(race, 20);
     }
 }
 
@@ -172,4 +172,571 @@ void BuildOrderTester::DoRandomTests(const RaceID race, const size_t numTests)
 
         }
     }
-}
\ No newline at end of file
+}
+
+// Solve the same random goals with and without the transposition table, and compare
+// the nodes expanded and the solve times. Goals are seeded by race so runs can be compared.
+void BuildOrderTester::BenchmarkDFBB(const RaceID race, const size_t numTests, const int timeLimit)
+{
+    // a few more workers and supply than the game start, since the naive upper bound search
+    // can't plan a refinery with only four workers
+    GameState startState(race);
+    startState.setStartingState();
+    startState.addCompletedAction(ActionTypes::GetWorker(race), 5);
+    startState.addCompletedAction(ActionTypes::GetSupplyProvider(race));
+
+    srand(race + 1);
+    std::vector<BuildOrderSearchGoal> goals;
+    for (size_t i(0); i < numTests; ++i)
+    {
+        goals.push_back(GetRandomGoal(race));
+    }
+
+    unsigned long long totalNodes[2] = {0, 0};
+    double totalTime[2] = {0, 0};
+    size_t numSolved[2] = {0, 0};
+    std::stringstream ss;
+
+    for (size_t i(0); i < goals.size(); ++i)
+    {
+        ss << Races::GetRaceName(race) << " goal " << i;
+
+        DFBB_BuildOrderSearchResults results[2];
+        try
+        {
+            for (size_t tt(0); tt < 2; ++tt)
+            {
+                DFBB_BuildOrderSmartSearch search(race);
+                search.setState(startState);
+                search.setGoal(goals[i]);
+                search.setTimeLimit(timeLimit);
+                search.setUseTranspositionTable(tt == 1);
+                search.search();
+                results[tt] = search.getResults();
+            }
+        }
+        catch (const BOSSException &)
+        {
+            // some random goals can't be planned by the naive search that gives the upper bound
+            ss << "   skipped\n";
+            continue;
+        }
+
+        for (size_t tt(0); tt < 2; ++tt)
+        {
+            totalNodes[tt] += results[tt].nodesExpanded;
+            totalTime[tt] += results[tt].timeElapsed;
+            numSolved[tt] += results[tt].solved ? 1 : 0;
+
+            ss << (tt ? "   TT " : "   no TT ") << results[tt].upperBound << " frames " << results[tt].nodesExpanded << " nodes "
+               << results[tt].transpositionCutoffs << " cutoffs " << results[tt].timeElapsed << "ms" << (results[tt].solved ? "" : " (timed out)");
+        }
+
+        ss << "\n";
+    }
+
+    for (size_t tt(0); tt < 2; ++tt)
+    {
+        ss << (tt ? "TT:    " : "no TT: ") << numSolved[tt] << "/" << goals.size() << " solved, "
+           << totalNodes[tt] << " nodes, " << totalTime[tt] << "ms\n";
+    }
+
+    std::cout << ss.str();
+}
+
+// Solve the same goals with 1, 2, 4, ... maxThreads threads.
+// Solved goals must have the same makespan with any number of threads.
+void BuildOrderTester::BenchmarkParallelDFBB(const RaceID race, const size_t numTests, const int timeLimit, const size_t maxThreads)
+{
+    GameState startState(race);
+    startState.setStartingState();
+    startState.addCompletedAction(ActionTypes::GetWorker(race), 5);
+    startState.addCompletedAction(ActionTypes::GetSupplyProvider(race));
+
+    srand(race + 1);
+    std::vector<BuildOrderSearchGoal> goals;
+    for (size_t i(0); i < numTests; ++i)
+    {
+        goals.push_back(GetRandomGoal(race));
+    }
+
+    std::vector<size_t> threadCounts;
+    for (size_t threads(1); threads < maxThreads; threads *= 2)
+    {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    std::vector<unsigned long long> totalNodes(threadCounts.size(), 0);
+    std::vector<double> totalTime(threadCounts.size(), 0);
+    std::vector<size_t> numSolved(threadCounts.size(), 0);
+    size_t mismatches = 0;
+    std::stringstream ss;
+
+    for (size_t i(0); i < goals.size(); ++i)
+    {
+        ss << Races::GetRaceName(race) << " goal " << i;
+
+        std::vector<DFBB_BuildOrderSearchResults> results(threadCounts.size());
+        try
+        {
+            for (size_t t(0); t < threadCounts.size(); ++t)
+            {
+                DFBB_BuildOrderSmartSearch search(race);
+                search.setState(startState);
+                search.setGoal(goals[i]);
+                search.setTimeLimit(timeLimit);
+                search.setNumThreads(threadCounts[t]);
+                search.search();
+                results[t] = search.getResults();
+            }
+        }
+        catch (const BOSSException &)
+        {
+            ss << "   skipped\n";
+            continue;
+        }
+
+        for (size_t t(0); t < threadCounts.size(); ++t)
+        {
+            totalNodes[t] += results[t].nodesExpanded;
+            totalTime[t] += results[t].timeElapsed;
+            numSolved[t] += results[t].solved ? 1 : 0;
+
+            if (results[t].solved && results[0].solved && results[t].upperBound != results[0].upperBound)
+            {
+                ++mismatches;
+            }
+
+            ss << "   " << threadCounts[t] << "T " << results[t].upperBound << " frames " << results[t].nodesExpanded << " nodes "
+               << results[t].timeElapsed << "ms" << (results[t].solved ? "" : " (timed out)");
+        }
+
+        ss << "\n";
+    }
+
+    for (size_t t(0); t < threadCounts.size(); ++t)
+    {
+        ss << threadCounts[t] << " threads: " << numSolved[t] << "/" << goals.size() << " solved, " << totalNodes[t] << " nodes, "
+           << totalTime[t] << "ms, " << (totalTime[t] > 0 ? totalNodes[t] / totalTime[t] : 0) << " nodes/ms\n";
+    }
+
+    ss << mismatches << " solved goals with a different makespan than 1 thread\n";
+
+    std::cout << ss.str();
+}
+
+// Searches in a game come in a sequence: each one starts from a state where part of the last plan
+// has been carried out, often with a bigger goal. This plays such sequences, carrying out the first
+// half of each plan and adding a few units to the goal, and solves each search twice: with the naive
+// upper bound, and warm started from the rest of the last plan.
+void BuildOrderTester::BenchmarkWarmStart(const RaceID race, const size_t numGames, const size_t numSearches, const int timeLimit)
+{
+    srand(race + 1);
+
+    unsigned long long totalNodes[2] = {0, 0};
+    double totalTime[2] = {0, 0};
+    size_t numSolved[2] = {0, 0};
+    size_t numSearched = 0;
+    size_t numBetterPlans = 0;
+    std::stringstream ss;
+
+    for (size_t game(0); game < numGames; ++game)
+    {
+        GameState state(race);
+        state.setStartingState();
+        state.addCompletedAction(ActionTypes::GetWorker(race), 5);
+        state.addCompletedAction(ActionTypes::GetSupplyProvider(race));
+
+        BuildOrderSearchGoal goal = GetRandomGoal(race);
+        BuildOrder plan;
+        GameState planState(state);
+
+        for (size_t i(0); i < numSearches; ++i)
+        {
+            ss << Races::GetRaceName(race) << " game " << game << " search " << i;
+
+            DFBB_BuildOrderSearchResults results[2];
+            BuildOrder warmStart;
+            try
+            {
+                warmStart = Tools::GetWarmStartBuildOrder(plan, planState, state, goal);
+
+                for (size_t warm(0); warm < 2; ++warm)
+                {
+                    DFBB_BuildOrderSmartSearch search(race);
+                    search.setState(state);
+                    search.setGoal(goal);
+                    search.setTimeLimit(timeLimit);
+                    if (warm)
+                    {
+                        search.setInitialUpperBound(Tools::GetUpperBound(state, goal, warmStart));
+                    }
+                    search.search();
+                    results[warm] = search.getResults();
+                }
+            }
+            catch (const BOSSException &)
+            {
+                ss << "   skipped\n";
+                break;
+            }
+
+            // a search that found no plan reports its initial upper bound plus one,
+            // and the warm started one only reports plans at least as good as its upper bound
+            FrameCountType warmFinish = results[1].solutionFound ? results[1].upperBound : Tools::GetUpperBound(state, goal, warmStart);
+            FrameCountType coldFinish = results[0].solutionFound ? results[0].upperBound : results[0].upperBound - 1;
+
+            ++numSearched;
+            numBetterPlans += warmFinish < coldFinish ? 1 : 0;
+
+            for (size_t warm(0); warm < 2; ++warm)
+            {
+                totalNodes[warm] += results[warm].nodesExpanded;
+                totalTime[warm] += results[warm].timeElapsed;
+                numSolved[warm] += results[warm].solved ? 1 : 0;
+
+                ss << (warm ? "   warm " : "   cold ") << (warm ? warmFinish : coldFinish) << " frames " << results[warm].nodesExpanded << " nodes "
+                   << results[warm].timeElapsed << "ms" << (results[warm].solved ? "" : " (timed out)");
+            }
+            ss << "\n";
+
+            if (!results[0].solutionFound || results[0].buildOrder.size() < 2)
+            {
+                break;
+            }
+
+            // carry out the first half of the plan, and want a few more units
+            plan = results[0].buildOrder;
+            planState = state;
+            plan.doActions(state, 0, plan.size() / 2);
+
+            BuildOrderSearchGoal extra = GetRandomGoal(race);
+            for (size_t a(0); a < ActionTypes::GetAllActionTypes(race).size(); ++a)
+            {
+                const ActionType & actionType = ActionTypes::GetActionType(race, a);
+                if (rand() % 3 == 0 && extra.getGoal(actionType) > goal.getGoal(actionType))
+                {
+                    goal.setGoal(actionType, goal.getGoal(actionType) + 1);
+                }
+            }
+        }
+    }
+
+    for (size_t warm(0); warm < 2; ++warm)
+    {
+        ss << (warm ? "warm: " : "cold: ") << numSolved[warm] << "/" << numSearched << " solved, "
+           << totalNodes[warm] << " nodes, " << totalTime[warm] << "ms\n";
+    }
+
+    ss << numBetterPlans << " searches with a better plan when warm started\n";
+
+    std::cout << ss.str();
+}
+
+// Search the same goals with each child order, and with the makespan deepened.
+// Measures how soon the first plan and a plan within 5% of the best one are found, which is
+// what a search that times out gets. Solved goals must have the same makespan with any order.
+void BuildOrderTester::BenchmarkChildOrder(const RaceID race, const size_t numTests, const int timeLimit)
+{
+    GameState startState(race);
+    startState.setStartingState();
+    startState.addCompletedAction(ActionTypes::GetWorker(race), 5);
+    startState.addCompletedAction(ActionTypes::GetSupplyProvider(race));
+
+    srand(race + 1);
+    std::vector<BuildOrderSearchGoal> goals;
+    for (size_t i(0); i < numTests; ++i)
+    {
+        goals.push_back(GetRandomGoal(race));
+    }
+
+    const ChildOrder orders[]   = { ChildOrders::ActionIDOrder, ChildOrders::EarliestFirst, ChildOrders::ClosestToGoal, ChildOrders::History, ChildOrders::ActionIDOrder, ChildOrders::ClosestToGoal };
+    const bool deepening[]      = { false, false, false, false, true, true };
+    const char * names[]        = { "id", "earliest", "closest", "history", "id+deep", "closest+deep" };
+    const size_t numConfigs = 6;
+
+    std::vector<double> firstTime(numConfigs, 0), closeTime(numConfigs, 0);
+    std::vector<size_t> numFirst(numConfigs, 0), numClose(numConfigs, 0), numSolved(numConfigs, 0);
+    size_t numSearched = 0;
+    size_t mismatches = 0;
+    std::stringstream ss;
+
+    for (size_t i(0); i < goals.size(); ++i)
+    {
+        ss << Races::GetRaceName(race) << " goal " << i;
+
+        std::vector<DFBB_BuildOrderSearchResults> results(numConfigs);
+        try
+        {
+            for (size_t c(0); c < numConfigs; ++c)
+            {
+                DFBB_BuildOrderSmartSearch search(race);
+                search.setState(startState);
+                search.setGoal(goals[i]);
+                search.setTimeLimit(timeLimit);
+                search.setChildOrder(orders[c]);
+                search.setUseIterativeDeepening(deepening[c]);
+                search.search();
+                results[c] = search.getResults();
+            }
+        }
+        catch (const BOSSException &)
+        {
+            ss << "   skipped\n";
+            continue;
+        }
+
+        // the best plan any of the searches found, or the naive one
+        int best = results[0].upperBound - 1;
+        int solvedMakespan = 0;
+        for (size_t c(0); c < numConfigs; ++c)
+        {
+            best = std::min(best, results[c].solutionFound ? results[c].upperBound : best);
+
+            if (results[c].solved && results[c].solutionFound)
+            {
+                mismatches += (solvedMakespan && results[c].upperBound != solvedMakespan) ? 1 : 0;
+                solvedMakespan = results[c].upperBound;
+            }
+        }
+
+        const int startFrame = startState.getCurrentFrame();
+        const int closeEnough = startFrame + (int)((best - startFrame) * 1.05);
+        ++numSearched;
+
+        for (size_t c(0); c < numConfigs; ++c)
+        {
+            const std::vector<std::pair<double, int>> & improvements = results[c].improvements;
+
+            // a search that never gets there counts the whole time limit,
+            // one that finished without beating the naive plan took as long as it took to show that
+            double first = results[c].solved ? results[c].timeElapsed : timeLimit;
+            double close = first;
+            if (!improvements.empty())
+            {
+                first = improvements.front().first;
+            }
+            numFirst[c] += first < timeLimit ? 1 : 0;
+            for (size_t s(0); s < improvements.size(); ++s)
+            {
+                if (improvements[s].second <= closeEnough)
+                {
+                    close = improvements[s].first;
+                    break;
+                }
+            }
+            numClose[c] += close < timeLimit ? 1 : 0;
+
+            firstTime[c] += first;
+            closeTime[c] += close;
+            numSolved[c] += results[c].solved ? 1 : 0;
+
+            ss << "   " << names[c] << " " << (results[c].solutionFound ? results[c].upperBound : results[c].upperBound - 1) << " frames "
+               << first << "/" << close << "ms" << (results[c].solved ? "" : " (timed out)");
+        }
+
+        ss << "\n";
+    }
+
+    for (size_t c(0); c < numConfigs; ++c)
+    {
+        ss << names[c] << ": " << numSolved[c] << "/" << numSearched << " solved, first plan " << numFirst[c] << " times, "
+           << firstTime[c] << "ms, within 5% " << numClose[c] << " times, " << closeTime[c] << "ms\n";
+    }
+
+    ss << mismatches << " solved goals with different makespans\n";
+
+    std::cout << ss.str();
+}
+
+// Large goals, each the union of three random goals, searched by DFBB and by the beam search.
+// Compares the best plan each has found after a few frames' worth of time and at the time limit.
+void BuildOrderTester::BenchmarkBeam(const RaceID race, const size_t numTests, const int timeLimit)
+{
+    GameState startState(race);
+    startState.setStartingState();
+    startState.addCompletedAction(ActionTypes::GetWorker(race), 5);
+    startState.addCompletedAction(ActionTypes::GetSupplyProvider(race));
+
+    srand(race + 1);
+    std::vector<BuildOrderSearchGoal> goals;
+    for (size_t i(0); i < numTests; ++i)
+    {
+        BuildOrderSearchGoal goal(race);
+        for (size_t g(0); g < 3; ++g)
+        {
+            const BuildOrderSearchGoal part = GetRandomGoal(race);
+            for (const ActionType & action : ActionTypes::GetAllActionTypes(race))
+            {
+                goal.setGoal(action, std::max(goal.getGoal(action), part.getGoal(action)));
+            }
+        }
+
+        // a required number of supply providers would cap them, and large goals need more
+        goal.setGoal(ActionTypes::GetSupplyProvider(race), 0);
+        goals.push_back(goal);
+    }
+
+    const SearchAlgorithm algorithms[] = { SearchAlgorithms::DFBB, SearchAlgorithms::Beam };
+    const char * names[] = { "dfbb", "beam" };
+    const int earlyTime = 100;
+
+    double early[2] = { 0, 0 };
+    double final[2] = { 0, 0 };
+    double naive = 0;
+    size_t numSearched = 0;
+    std::stringstream ss;
+
+    for (size_t i(0); i < goals.size(); ++i)
+    {
+        ss << Races::GetRaceName(race) << " goal " << i;
+
+        DFBB_BuildOrderSearchResults results[2];
+        int naiveFinish = 0;
+        try
+        {
+            for (size_t s(0); s < 2; ++s)
+            {
+                DFBB_BuildOrderSmartSearch search(race);
+                search.setState(startState);
+                search.setGoal(goals[i]);
+                search.setTimeLimit(timeLimit);
+                search.setChildOrder(ChildOrders::ClosestToGoal);
+                search.setSearchAlgorithm(algorithms[s]);
+                search.search();
+                results[s] = search.getResults();
+
+                const DFBB_BuildOrderSearchParameters & params = search.getParameters();
+                naiveFinish = Tools::GetUpperBound(params.initialState, params.goal);
+
+                GameState finalState(startState);
+                BOSS_ASSERT(!results[s].solutionFound || (results[s].buildOrder.doActions(finalState) && goals[i].isAchievedBy(finalState)),
+                    "The %s build order doesn't reach the goal", names[s]);
+            }
+        }
+        catch (const BOSSException &)
+        {
+            ss << "   skipped\n";
+            continue;
+        }
+
+        // frames from the start to the end of the plan, the naive one until something better is found
+        const int startFrame = startState.getCurrentFrame();
+        ss << "   naive " << (naiveFinish - startFrame);
+        naive += naiveFinish - startFrame;
+        ++numSearched;
+
+        for (size_t s(0); s < 2; ++s)
+        {
+            int earlyFinish = naiveFinish;
+            int finalFinish = naiveFinish;
+            for (const auto & improvement : results[s].improvements)
+            {
+                earlyFinish = improvement.first <= earlyTime ? improvement.second : earlyFinish;
+                finalFinish = improvement.second;
+            }
+
+            early[s] += earlyFinish - startFrame;
+            final[s] += finalFinish - startFrame;
+
+            ss << "   " << names[s] << " " << (earlyFinish - startFrame) << "/" << (finalFinish - startFrame)
+               << " frames " << results[s].nodesExpanded << " nodes" << (results[s].solved ? "" : results[s].finished ? " (not proven)" : " (timed out)");
+        }
+
+        ss << "\n";
+    }
+
+    ss << "makespan frames of " << numSearched << " goals, naive " << naive << "\n";
+    for (size_t s(0); s < 2; ++s)
+    {
+        ss << names[s] << ": after " << earlyTime << "ms " << early[s] << ", after " << timeLimit << "ms " << final[s] << "\n";
+    }
+
+    std::cout << ss.str();
+}
+
+// Time DFBB_BuildOrderStackSearch::generateLegalActions and Tools::CalculatePrerequisitesRequiredToBuild,
+// on the states along the naive build orders of random goals. These are the main users of ActionSet and PrerequisiteSet.
+void BuildOrderTester::BenchmarkLegalActions(const RaceID race, const size_t numGoals, const size_t iterations)
+{
+    GameState startState(race);
+    startState.setStartingState();
+    startState.addCompletedAction(ActionTypes::GetWorker(race), 5);
+    startState.addCompletedAction(ActionTypes::GetSupplyProvider(race));
+
+    srand(race + 1);
+
+    double legalActionsNs = 0;
+    double prerequisitesNs = 0;
+    size_t numStates = 0;
+    size_t numSkipped = 0;
+
+    for (size_t g(0); g < numGoals; ++g)
+    {
+        BuildOrderSearchGoal goal = GetRandomGoal(race);
+
+        std::vector<GameState> states;
+        double goalLegalActionsNs = 0;
+        try
+        {
+            NaiveBuildOrderSearch naiveSearch(startState, goal);
+            const BuildOrder & naiveBuildOrder = naiveSearch.solve();
+
+            GameState state(startState);
+            states.push_back(state);
+            for (size_t i(0); i < naiveBuildOrder.size(); ++i)
+            {
+                state.doAction(naiveBuildOrder[i]);
+                states.push_back(state);
+            }
+
+            DFBB_BuildOrderSmartSearch smartSearch(race);
+            smartSearch.setState(startState);
+            smartSearch.setGoal(goal);
+
+            DFBB_BuildOrderStackSearch stackSearch(smartSearch.getParameters());
+            goalLegalActionsNs = stackSearch.benchmarkLegalActions(states, iterations) * states.size();
+        }
+        catch (const BOSSException &)
+        {
+            // the naive search can't plan some random goals, and some states along the naive build order
+            // aren't ones the search would get to
+            ++numSkipped;
+            continue;
+        }
+
+        legalActionsNs += goalLegalActionsNs;
+
+        // what the lower bound and the naive search ask for: everything in the goal we don't have
+        PrerequisiteSet wanted;
+        for (size_t a(0); a < ActionTypes::GetAllActionTypes(race).size(); ++a)
+        {
+            const ActionType & actionType = ActionTypes::GetActionType(race, a);
+            if (goal.getGoal(actionType) > 0)
+            {
+                wanted.addUnique(actionType);
+            }
+        }
+
+        size_t numRequired = 0;
+        Timer timer;
+        timer.start();
+        for (size_t i(0); i < iterations; ++i)
+        {
+            for (size_t s(0); s < states.size(); ++s)
+            {
+                PrerequisiteSet requiredToBuild;
+                Tools::CalculatePrerequisitesRequiredToBuild(states[s], wanted, requiredToBuild);
+                numRequired += requiredToBuild.size();
+            }
+        }
+        prerequisitesNs += timer.getElapsedTimeInMilliSec() * 1000000 / iterations;
+
+        numStates += states.size();
+    }
+
+    std::cout << Races::GetRaceName(race) << ": " << numStates << " states, " << numSkipped << " goals skipped, "
+              << "generateLegalActions " << (numStates ? legalActionsNs / numStates : 0) << "ns, "
+              << "CalculatePrerequisitesRequiredToBuild " << (numStates ? prerequisitesNs / numStates : 0) << "ns\n";
+}
@@ -12,5 +12,11 @@ namespace BuildOrderTester
     void DoRandomTests(const RaceID race, const size_t numTests);
 
     void TestRandomBuilds(const RaceID race, const size_t numTests);
+    void BenchmarkDFBB(const RaceID race, const size_t numTests, const int timeLimit);
+    void BenchmarkParallelDFBB(const RaceID race, const size_t numTests, const int timeLimit, const size_t maxThreads);
+    void BenchmarkLegalActions(const RaceID race, const size_t numGoals, const size_t iterations);
+    void BenchmarkChildOrder(const RaceID race, const size_t numTests, const int timeLimit);
+    void BenchmarkBeam(const RaceID race, const size_t numTests, const int timeLimit);
+    void BenchmarkWarmStart(const RaceID race, const size_t numGames, const size_t numSearches, const int timeLimit);
 }
 }
\ No newline at end of file
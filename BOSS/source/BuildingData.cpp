@@ -104,7 +104,6 @@ void BuildingStatus::fastForward(const FrameCountType frames)
     // if we fastforward more than the current time remaining, we will complete the action
     bool willComplete = _timeRemaining <= frames;
     int timeWasRemaining = _timeRemaining;
-    const std::string & name = _type.getName();
 
     if ((_timeRemaining > 0) && willComplete)
     {
@@ -136,7 +135,7 @@ BuildingData::BuildingData()
 {
 }
 
-const size_t & BuildingData::size() const
+size_t BuildingData::size() const
 {
     return _buildings.size();
 }
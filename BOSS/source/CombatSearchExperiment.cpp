@@ -75,6 +75,20 @@ CombatSearchExperiment::CombatSearchExperiment(const std::string & name, const r
         _params.setAlwaysMakeWorkers(val["AlwaysMakeWorkers"].GetBool());
     }
 
+    if (val.HasMember("DominancePruning"))
+    {
+        BOSS_ASSERT(val["DominancePruning"].IsBool(), "DominancePruning should be a bool");
+
+        _params.setUseDominancePruning(val["DominancePruning"].GetBool());
+    }
+
+    if (val.HasMember("Threads"))
+    {
+        BOSS_ASSERT(val["Threads"].IsInt() && val["Threads"].GetInt() > 0, "Threads should be a positive int");
+
+        _params.setNumThreads(val["Threads"].GetInt());
+    }
+
     if (val.HasMember("OpeningBuildOrder"))
     {
         BOSS_ASSERT(val["OpeningBuildOrder"].IsString(), "OpeningBuildOrder should be a string");
@@ -102,35 +116,44 @@ void CombatSearchExperiment::run()
     static std::string stars = "************************************************";
     for (size_t i(0); i < _searchTypes.size(); ++i)
     {
-        std::shared_ptr<CombatSearch> combatSearch;
-        std::string resultsFile = "gnuplot/" + _name;
+        std::string resultsFile = "gnuplot/" + _name + "_" + _searchTypes[i];
 
         std::cout << "\n" << stars << "\n* Running Experiment: " << _name << " [" << _searchTypes[i] << "]\n" << stars << "\n";
 
-        if (_searchTypes[i].compare("Integral") == 0)
-        {
-            combatSearch = std::shared_ptr<CombatSearch>(new CombatSearch_Integral(_params));
-            resultsFile += "_Integral"; 
-        }
-        else if (_searchTypes[i].compare("Bucket") == 0)
-        {
-            combatSearch = std::shared_ptr<CombatSearch>(new CombatSearch_Bucket(_params));
-            resultsFile += "_Bucket"; 
-        }
-        else if (_searchTypes[i].compare("BestResponse") == 0)
-        {
-            combatSearch = std::shared_ptr<CombatSearch>(new CombatSearch_BestResponse(_params));
-            resultsFile += "_BestResponse"; 
-        }
-        else
-        {
-            BOSS_ASSERT(false, "CombatSearch type not found: %s", _searchTypes[i].c_str());
-        }
-
+        std::shared_ptr<CombatSearch> combatSearch = makeSearch(_searchTypes[i]);
         combatSearch->search();
         combatSearch->printResults();
         combatSearch->writeResultsFile(resultsFile);
         const CombatSearchResults & results = combatSearch->getResults();
         std::cout << "\nSearched " << results.nodesExpanded << " nodes in " << results.timeElapsed << "ms @ " << (1000.0*results.nodesExpanded/results.timeElapsed) << " nodes/sec\n\n";
     }
+}
+
+std::shared_ptr<CombatSearch> CombatSearchExperiment::makeSearch(const std::string & searchType) const
+{
+    if (searchType.compare("Integral") == 0)
+    {
+        return std::shared_ptr<CombatSearch>(new CombatSearch_Integral(_params));
+    }
+    else if (searchType.compare("Bucket") == 0)
+    {
+        return std::shared_ptr<CombatSearch>(new CombatSearch_Bucket(_params));
+    }
+    else if (searchType.compare("BestResponse") == 0)
+    {
+        return std::shared_ptr<CombatSearch>(new CombatSearch_BestResponse(_params));
+    }
+
+    BOSS_ASSERT(false, "CombatSearch type not found: %s", searchType.c_str());
+    return std::shared_ptr<CombatSearch>();
+}
+
+const std::string & CombatSearchExperiment::getName() const
+{
+    return _name;
+}
+
+const std::vector<std::string> & CombatSearchExperiment::getSearchTypes() const
+{
+    return _searchTypes;
 }
\ No newline at end of file
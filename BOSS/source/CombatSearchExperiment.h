@@ -25,5 +25,11 @@ public:
     CombatSearchExperiment(const std::string & name, const rapidjson::Value & experimentVal);
 
     void run();
+
+    // a new search of one of the experiment's search types, "Integral", "Bucket" or "BestResponse"
+    std::shared_ptr<CombatSearch> makeSearch(const std::string & searchType) const;
+
+    const std::string & getName() const;
+    const std::vector<std::string> & getSearchTypes() const;
 };
 }
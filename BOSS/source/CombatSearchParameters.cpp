@@ -20,6 +20,8 @@ CombatSearchParameters::CombatSearchParameters()
     , _repetitionValues              (Constants::MAX_ACTIONS, 1)
     , _repetitionThresholds          (Constants::MAX_ACTIONS, 0)
     , _printNewBest                  (false)
+    , _useDominancePruning           (true)
+    , _numThreads                    (1)
 {
     
 }
@@ -124,6 +126,26 @@ FrameCountType CombatSearchParameters::getFrameTimeLimit() const
     return _frameTimeLimit;
 }
 
+void CombatSearchParameters::setUseDominancePruning(const bool flag)
+{
+    _useDominancePruning = flag;
+}
+
+const bool CombatSearchParameters::getUseDominancePruning() const
+{
+    return _useDominancePruning;
+}
+
+void CombatSearchParameters::setNumThreads(const size_t threads)
+{
+    _numThreads = threads;
+}
+
+size_t CombatSearchParameters::getNumThreads() const
+{
+    return _numThreads;
+}
+
 
 
 void CombatSearchParameters::print()
@@ -137,6 +159,7 @@ void CombatSearchParameters::print()
     printf("%s", _useResourceLowerBoundHeuristic ?    "\tUSE      Resource Lower Bound\n" : "");
     printf("%s", _useAlwaysMakeWorkers ?              "\tUSE      Always Make Workers\n" : "");
     printf("%s", _useSupplyBounding ?                 "\tUSE      Supply Bounding\n" : "");
+    printf("%s", _useDominancePruning ?               "\tUSE      Dominance Pruning\n" : "");
     printf("\n");
 
     //for (int a = 0; a < ACTIONS.size(); ++a)
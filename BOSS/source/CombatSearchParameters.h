@@ -102,6 +102,19 @@ class CombatSearchParameters
     FrameCountType          _frameTimeLimit;
     bool                    _printNewBest;
 
+    //      Flag which determines whether or not the integral search prunes dominated states
+    //      A state is not expanded if a state at about the same frame with at least its army
+    //          integral, resources and units was already expanded. See CombatSearch_DominanceTable.
+    //
+    //      true:  dominated states are pruned
+    //      false: every state is expanded
+    bool                    _useDominancePruning;
+
+    //      Number of threads used by the integral search
+    //      The top of the tree is expanded until there are a few subtrees per thread, and the
+    //          threads take the subtrees in turn. They share the dominance table.
+    size_t                  _numThreads;
+
 
 
 public:
@@ -138,6 +151,12 @@ public:
 
     void                setAlwaysMakeWorkers(const bool flag);
     const bool          getAlwaysMakeWorkers() const;
+
+    void                setUseDominancePruning(const bool flag);
+    const bool          getUseDominancePruning() const;
+
+    void                setNumThreads(const size_t threads);
+    size_t              getNumThreads() const;
 	
 	void print();
 };
@@ -0,0 +1,143 @@
+#include "CombatSearch_DominanceTable.h"
+
+using namespace BOSS;
+
+CombatSearch_DominanceTable::Entry::Entry(const GameState & state, const double i)
+    : frame(state.getCurrentFrame())
+    , minerals(state.getMinerals())
+    , gas(state.getGas())
+    , mineralsPerFrame(state.getMineralsPerFrame())
+    , gasPerFrame(state.getGasPerFrame())
+    , integral(i)
+{
+    const UnitData & unitData = state.getUnitData();
+
+    units = Zobrist::Key(Zobrist::Workers, unitData.getNumMineralWorkers(), unitData.getNumGasWorkers());
+    for (size_t a(0); a < ActionTypes::GetAllActionTypes(state.getRace()).size(); ++a)
+    {
+        const ActionType & action = ActionTypes::GetActionType(state.getRace(), a);
+        if (unitData.getNumTotal(action) > 0)
+        {
+            units += Zobrist::Key(Zobrist::Completed, a, unitData.getNumTotal(action) << 8 | unitData.getNumCompleted(action));
+        }
+    }
+
+    units += Zobrist::Key(Zobrist::Larva, state.getHatcheryData().numLarva());
+
+    // a building is busy until what it is making is done, so these are its times too
+    for (UnitCountType p(0); p < unitData.getNumActionsInProgress(); ++p)
+    {
+        timings.push_back(std::make_pair((int)unitData.getActionInProgressByIndex(p).ID(), (int)unitData.getActionInProgressFinishTimeByIndex(p)));
+    }
+    std::sort(timings.begin(), timings.end());
+}
+
+CombatSearch_DominanceTable::CombatSearch_DominanceTable(const RaceID race, const FrameCountType frameLimit, const FrameCountType bucketFrames, const size_t bucketSize)
+    : _bucketFrames(bucketFrames)
+    , _bucketSize(bucketSize)
+    , _race(race)
+{
+    for (FrameCountType f(0); f <= frameLimit / bucketFrames; ++f)
+    {
+        _buckets.push_back(std::unique_ptr<Bucket>(new Bucket()));
+    }
+}
+
+bool CombatSearch_DominanceTable::dominates(const Entry & entry, const Entry & other) const
+{
+    if ((entry.units != other.units) 
+        || (entry.frame > other.frame) 
+        || (entry.integral < other.integral) 
+        || (entry.timings.size() != other.timings.size()))
+    {
+        return false;
+    }
+
+    // a refinery finishing before the other state's frame takes mineral workers away
+    bool sameMineralIncome = true;
+    for (size_t i(0); i < entry.timings.size(); ++i)
+    {
+        if ((entry.timings[i].first != other.timings[i].first) || (entry.timings[i].second > other.timings[i].second))
+        {
+            return false;
+        }
+
+        if ((entry.timings[i].second <= other.frame) && ActionTypes::GetActionType(_race, ActionID(entry.timings[i].first)).isRefinery())
+        {
+            sameMineralIncome = false;
+        }
+    }
+
+    // the resources this state has by the other state's frame, at least
+    const FrameCountType frames = other.frame - entry.frame;
+    const ResourceCountType minerals = entry.minerals + (sameMineralIncome ? (int)(entry.mineralsPerFrame * frames) : 0);
+    const ResourceCountType gas = entry.gas + (int)(entry.gasPerFrame * frames);
+
+    return (minerals >= other.minerals) && (gas >= other.gas);
+}
+
+bool CombatSearch_DominanceTable::isDominated(Bucket & bucket, const Entry & entry) const
+{
+    for (size_t i(0); i < bucket.entries.size(); ++i)
+    {
+        if (dominates(bucket.entries[i], entry))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool CombatSearch_DominanceTable::isDominated(const GameState & state, const double integral)
+{
+    const size_t index = state.getCurrentFrame() / _bucketFrames;
+    if (index >= _buckets.size())
+    {
+        return false;
+    }
+
+    Entry entry(state, integral);
+
+    // states from the end of the bucket before can dominate this one too
+    if (index > 0)
+    {
+        Bucket & previous = *_buckets[index - 1];
+        std::lock_guard<std::mutex> lock(previous.mutex);
+
+        if (isDominated(previous, entry))
+        {
+            return true;
+        }
+    }
+
+    Bucket & bucket = *_buckets[index];
+    std::lock_guard<std::mutex> lock(bucket.mutex);
+
+    if (isDominated(bucket, entry))
+    {
+        return true;
+    }
+
+    // a state this one dominates is no use any more
+    for (size_t i(0); i < bucket.entries.size(); ++i)
+    {
+        if (dominates(entry, bucket.entries[i]))
+        {
+            bucket.entries[i] = entry;
+            return false;
+        }
+    }
+
+    if (bucket.entries.size() < _bucketSize)
+    {
+        bucket.entries.push_back(entry);
+    }
+    else
+    {
+        bucket.entries[bucket.next] = entry;
+        bucket.next = (bucket.next + 1) % _bucketSize;
+    }
+
+    return false;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Common.h"
+#include "GameState.h"
+#include "TranspositionTable.h"
+
+#include <algorithm>
+#include <mutex>
+#include <memory>
+
+namespace BOSS
+{
+
+// States the integral combat search has already expanded, kept by frame bucket.
+// A state is dominated by an earlier one from its bucket or the one before that has the same units
+// and worker jobs, everything in progress finishing no later, at least its army integral, and by
+// its frame at least its resources. Whatever the dominated state can still build, the other one
+// could build as soon, so its subtree can't be better and is skipped.
+// Eval::StateDominates isn't enough for this: it only compares resources and unit counts, and a
+// building started a little later leaves more minerals but finishes later.
+// Each bucket keeps a few states and has its own lock, so the threads of a search share the table.
+class CombatSearch_DominanceTable
+{
+    class Entry
+    {
+    public:
+
+        FrameCountType                      frame;
+        ResourceCountType                   minerals;
+        ResourceCountType                   gas;
+        size_t                              mineralsPerFrame;
+        size_t                              gasPerFrame;
+        double                              integral;   // army integral up to the state's frame
+        HashType                            units;      // hash of the unit counts and worker jobs
+        std::vector<std::pair<int, int>>    timings;    // (action, finish frame) of each action in progress, sorted
+
+        Entry(const GameState & state, const double integral);
+    };
+
+    class Bucket
+    {
+    public:
+
+        std::vector<Entry>  entries;
+        size_t              next;       // entry replaced when the bucket is full
+        std::mutex          mutex;
+
+        Bucket()
+            : next(0)
+        {
+        
+        }
+    };
+
+    std::vector<std::unique_ptr<Bucket>>    _buckets;
+    FrameCountType                          _bucketFrames;
+    size_t                                  _bucketSize;
+    RaceID                                  _race;
+
+    bool                                    dominates(const Entry & entry, const Entry & other) const;
+    bool                                    isDominated(Bucket & bucket, const Entry & entry) const;
+
+public:
+
+    CombatSearch_DominanceTable(const RaceID race, const FrameCountType frameLimit, const FrameCountType bucketFrames = 8, const size_t bucketSize = 32);
+
+    // is the state dominated by one already in the table? If not, it goes in the table,
+    // in place of a state it dominates if there is one
+    bool isDominated(const GameState & state, const double integral);
+};
+
+}
@@ -1,7 +1,37 @@
 #include "CombatSearch_Integral.h"
 
+#include <thread>
+#include <atomic>
+
 using namespace BOSS;
 
+namespace
+{
+    // a subtree left for the threads of a parallel search
+    class IntegralWork
+    {
+    public:
+
+        GameState                   state;
+        size_t                      depth;
+        BuildOrder                  buildOrder;
+        CombatSearch_IntegralData   integral;
+
+        IntegralWork(const GameState & s, const size_t d, const BuildOrder & b, const CombatSearch_IntegralData & i)
+            : state(s)
+            , depth(d)
+            , buildOrder(b)
+            , integral(i)
+        {
+        
+        }
+    };
+
+    // the top of the tree is expanded until there are this many subtrees per thread,
+    // so that a thread that gets a big one doesn't leave the others idle for long
+    const size_t WorkPerThread = 16;
+}
+
 CombatSearch_Integral::CombatSearch_Integral(const CombatSearchParameters p)
 {
     _params = p;
@@ -9,7 +39,41 @@ CombatSearch_Integral::CombatSearch_Integral(const CombatSearchParameters p)
     BOSS_ASSERT(_params.getInitialState().getRace() != Races::None, "Combat search initial state is invalid");
 }
 
-void CombatSearch_Integral::doSearch(const GameState & state, size_t depth)
+void CombatSearch_Integral::search()
+{
+    if (_params.getUseDominancePruning())
+    {
+        _dominance = std::make_shared<CombatSearch_DominanceTable>(_params.getInitialState().getRace(), _params.getFrameTimeLimit());
+    }
+
+    if (_params.getNumThreads() <= 1)
+    {
+        CombatSearch::search();
+    }
+    else
+    {
+        _searchTimer.start();
+
+        // apply the opening build order to the initial state
+        GameState initialState(_params.getInitialState());
+        _buildOrder = _params.getOpeningBuildOrder();
+        _buildOrder.doActions(initialState);
+
+        searchParallel(initialState);
+
+        _results.solved = !_results.timedOut;
+        _results.timeElapsed = _searchTimer.getElapsedTimeInMilliSec();
+    }
+
+    _results.highestEval = _integral.getBestIntegralValue();
+}
+
+bool CombatSearch_Integral::isDominated(const GameState & state) const
+{
+    return _dominance && _dominance->isDominated(state, _integral.getCurrentIntegral(state));
+}
+
+void CombatSearch_Integral::recurse(const GameState & state, size_t depth)
 {
     if (timeLimitReached())
     {
@@ -18,7 +82,7 @@ void CombatSearch_Integral::doSearch(const GameState & state, size_t depth)
 
     updateResults(state);
 
-    if (isTerminalNode(state, depth))
+    if (isTerminalNode(state, depth) || isDominated(state))
     {
         return;
     }
@@ -35,13 +99,131 @@ void CombatSearch_Integral::doSearch(const GameState & state, size_t depth)
         _buildOrder.add(legalActions[index]);
         _integral.update(state, _buildOrder);
         
-        doSearch(child,depth+1);
+        recurse(child,depth+1);
 
         _buildOrder.pop_back();
         _integral.pop();
     }
 }
 
+// Expand the top of the tree breadth first, keeping the subtrees in the order the serial search
+// visits them, then let the threads search the subtrees. Each subtree keeps its own best build
+// order, and they are merged in that order, so ties go the same way as in the serial search.
+void CombatSearch_Integral::searchParallel(const GameState & state)
+{
+    const size_t numThreads = _params.getNumThreads();
+
+    std::vector<IntegralWork> work(1, IntegralWork(state, 0, _buildOrder, _integral));
+    while (!work.empty() && work.size() < numThreads * WorkPerThread)
+    {
+        std::vector<IntegralWork> children;
+        for (auto & parent : work)
+        {
+            _integral.merge(parent.integral);
+
+            // counted in nodesExpanded here, the same as recurse counts the nodes below the top
+            updateResults(parent.state);
+
+            if (isTerminalNode(parent.state, parent.depth) || (_dominance && _dominance->isDominated(parent.state, parent.integral.getCurrentIntegral(parent.state))))
+            {
+                continue;
+            }
+
+            ActionSet legalActions;
+            generateLegalActions(parent.state, legalActions, _params);
+
+            for (UnitCountType a(0); a < legalActions.size(); ++a)
+            {
+                const UnitCountType index = legalActions.size()-1-a;
+
+                children.push_back(IntegralWork(parent.state, parent.depth + 1, parent.buildOrder, parent.integral));
+                IntegralWork & child = children.back();
+                child.state.doAction(legalActions[index]);
+                child.buildOrder.add(legalActions[index]);
+                child.integral.setPrintNewBest(false);
+                child.integral.update(parent.state, child.buildOrder);
+            }
+        }
+
+        work.swap(children);
+    }
+
+    std::vector<CombatSearch_IntegralData> best(work.size());
+    std::vector<unsigned long long> nodesExpanded(numThreads, 0);
+    std::atomic<size_t> nextWork(0);
+    std::atomic<bool> timedOut(false);
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    auto runThread = [&](const size_t thread)
+    {
+        CombatSearch_Integral search(_params);
+        search._dominance = _dominance;
+        search._searchTimer = _searchTimer;
+
+        try
+        {
+            for (size_t w(nextWork++); w < work.size() && !timedOut; w = nextWork++)
+            {
+                search._buildOrder = work[w].buildOrder;
+                search._integral = work[w].integral;
+
+                try
+                {
+                    search.recurse(work[w].state, work[w].depth);
+                }
+                catch (int e)
+                {
+                    if (e == BOSS_COMBATSEARCH_TIMEOUT)
+                    {
+                        timedOut = true;
+                    }
+                }
+
+                best[w] = search._integral;
+            }
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            error = error ? error : std::current_exception();
+            timedOut = true;
+        }
+
+        nodesExpanded[thread] = search._results.nodesExpanded;
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t t(1); t < numThreads; ++t)
+    {
+        threads.push_back(std::thread(runThread, t));
+    }
+
+    runThread(0);
+
+    for (auto & thread : threads)
+    {
+        thread.join();
+    }
+
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+
+    for (size_t w(0); w < best.size(); ++w)
+    {
+        _integral.merge(best[w]);
+    }
+
+    for (size_t t(0); t < numThreads; ++t)
+    {
+        _results.nodesExpanded += nodesExpanded[t];
+    }
+
+    _results.timedOut = timedOut;
+}
+
 void CombatSearch_Integral::printResults()
 {
     _integral.print();
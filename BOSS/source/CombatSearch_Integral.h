@@ -8,6 +8,9 @@
 #include "CombatSearchParameters.h"
 #include "CombatSearchResults.h"
 #include "CombatSearch_IntegralData.h"
+#include "CombatSearch_DominanceTable.h"
+
+#include <memory>
 
 namespace BOSS
 {
@@ -16,12 +19,18 @@ class CombatSearch_Integral : public CombatSearch
 {
     CombatSearch_IntegralData   _integral;
 
-	virtual void                doSearch(const GameState & s, size_t depth);
+    std::shared_ptr<CombatSearch_DominanceTable>    _dominance;     // null if dominance pruning is off
+
+	virtual void                recurse(const GameState & s, size_t depth);
+
+    void                        searchParallel(const GameState & s);
+    bool                        isDominated(const GameState & s) const;
 
 public:
 	
 	CombatSearch_Integral(const CombatSearchParameters p = CombatSearchParameters());
 	
+    virtual void search();
     virtual void printResults();
     virtual void writeResultsFile(const std::string & filename);
 };
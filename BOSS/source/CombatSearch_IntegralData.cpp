@@ -4,6 +4,7 @@ using namespace BOSS;
 
 CombatSearch_IntegralData::CombatSearch_IntegralData()
     : _bestIntegralValue(0)
+    , _printNewBest(true)
 {
     _integralStack.push_back(IntegralData(0,0,0));
 }
@@ -16,21 +17,54 @@ void CombatSearch_IntegralData::update(const GameState & state, const BuildOrder
     IntegralData entry(value, _integralStack.back().integral + valueToAdd, state.getCurrentFrame());
     _integralStack.push_back(entry);
 
-    // we have found a new best if:
-    // 1. the new army integral is higher than the previous best
-    // 2. the new army integral is the same as the old best but the build order is 'better'
-    if (    (_integralStack.back().integral >  _bestIntegralValue) 
-        || ((_integralStack.back().integral == _bestIntegralValue) && Eval::BuildOrderBetter(buildOrder, _bestIntegralBuildOrder)))
+    if (isBetter(_integralStack.back().integral, buildOrder))
     {
         _bestIntegralValue = _integralStack.back().integral;
         _bestIntegralStack = _integralStack;
         _bestIntegralBuildOrder = buildOrder;
 
         // print the newly found best to console
-        printIntegralData(_integralStack.size()-1);
+        if (_printNewBest)
+        {
+            printIntegralData(_integralStack.size()-1);
+        }
     }
 }
 
+// we have found a new best if:
+// 1. the new army integral is higher than the previous best
+// 2. the new army integral is the same as the old best but the build order is 'better'
+bool CombatSearch_IntegralData::isBetter(const double integral, const BuildOrder & buildOrder) const
+{
+    return (integral > _bestIntegralValue) 
+        || ((integral == _bestIntegralValue) && Eval::BuildOrderBetter(buildOrder, _bestIntegralBuildOrder));
+}
+
+double CombatSearch_IntegralData::getCurrentIntegral(const GameState & state) const
+{
+    return _integralStack.back().integral + _integralStack.back().eval * (state.getCurrentFrame() - _integralStack.back().timeAdded);
+}
+
+void CombatSearch_IntegralData::merge(const CombatSearch_IntegralData & other)
+{
+    if (!other._bestIntegralStack.empty() && isBetter(other._bestIntegralValue, other._bestIntegralBuildOrder))
+    {
+        _bestIntegralValue = other._bestIntegralValue;
+        _bestIntegralStack = other._bestIntegralStack;
+        _bestIntegralBuildOrder = other._bestIntegralBuildOrder;
+
+        if (_printNewBest)
+        {
+            printIntegralData(_bestIntegralStack.size()-1);
+        }
+    }
+}
+
+void CombatSearch_IntegralData::setPrintNewBest(const bool print)
+{
+    _printNewBest = print;
+}
+
 void CombatSearch_IntegralData::pop()
 {
     _integralStack.pop_back();
@@ -56,4 +90,9 @@ void CombatSearch_IntegralData::print() const
 const BuildOrder & CombatSearch_IntegralData::getBestBuildOrder() const
 {
     return _bestIntegralBuildOrder;
+}
+
+double CombatSearch_IntegralData::getBestIntegralValue() const
+{
+    return _bestIntegralValue;
 }
\ No newline at end of file
@@ -40,6 +40,10 @@ class CombatSearch_IntegralData
     double                          _bestIntegralValue;
     BuildOrder                      _bestIntegralBuildOrder;
 
+    bool                            _printNewBest;
+
+    bool isBetter(const double integral, const BuildOrder & buildOrder) const;
+
 public:
 
     CombatSearch_IntegralData();
@@ -47,10 +51,18 @@ public:
     void update(const GameState & state, const BuildOrder & buildOrder);
     void pop();
 
+    // the army integral up to the frame of a state after the last one updated
+    double getCurrentIntegral(const GameState & state) const;
+
+    // take the best build order of another search of the same tree, if it is better
+    void merge(const CombatSearch_IntegralData & other);
+    void setPrintNewBest(const bool print);
+
     void printIntegralData(const size_t index) const;
     void print() const;
 
     const BuildOrder & getBestBuildOrder() const;
+    double getBestIntegralValue() const;
 };
 
 }
@@ -12,7 +12,18 @@ DFBB_BuildOrderSearchParameters::DFBB_BuildOrderSearchParameters(const RaceID &
     , supplyBoundingThreshold(1)
     , useLandmarkLowerBoundHeuristic(true)
     , useResourceLowerBoundHeuristic(true)
+    , useTranspositionTable(false)
+    , transpositionTableSize(1 << 15)
+    , numThreads(1)
+    , childOrder(ChildOrders::ActionIDOrder)
+    , useIterativeDeepening(false)
+    , deepeningStep(0.05)
+    , searchAlgorithm(SearchAlgorithms::DFBB)
+    , beamWidth(8)
+    , maxBeamWidth(2048)
+    , beamWeight(1.0)
     , searchTimeLimit(0)
+    , stopFlag(nullptr)
     , initialUpperBound(0)
     , repetitionValues(Constants::MAX_ACTIONS, 1)
     , repetitionThresholds(Constants::MAX_ACTIONS, 0)
@@ -37,7 +48,7 @@ void DFBB_BuildOrderSearchParameters::setRepetitionThreshold(const ActionType &
     repetitionThresholds[a.ID()] = thresh; 
 }
 
-const UnitCountType & DFBB_BuildOrderSearchParameters::getRepetitions(const ActionType & a)
+const UnitCountType & DFBB_BuildOrderSearchParameters::getRepetitions(const ActionType & a) const
 { 
     BOSS_ASSERT(a.ID() >= 0 && a.ID() < repetitionValues.size(), "Action type not valid");
     BOSS_ASSERT(a.getRace() == race, "Action type race doesn't match this parameter object");
@@ -45,7 +56,7 @@ const UnitCountType & DFBB_BuildOrderSearchParameters::getRepetitions(const Acti
     return repetitionValues[a.ID()]; 
 }
 
-const UnitCountType & DFBB_BuildOrderSearchParameters::getRepetitionThreshold(const ActionType & a)				
+const UnitCountType & DFBB_BuildOrderSearchParameters::getRepetitionThreshold(const ActionType & a) const				
 { 
     BOSS_ASSERT(a.ID() >= 0 && a.ID() < repetitionThresholds.size(), "Action type not valid");
     BOSS_ASSERT(a.getRace() == race, "Action type race doesn't match this parameter object");
@@ -67,6 +78,9 @@ std::string DFBB_BuildOrderSearchParameters::toString() const
     ss << (useResourceLowerBoundHeuristic ?    "\tUSE      Resource Lower Bound\n" : "");
     ss << (useAlwaysMakeWorkers ?              "\tUSE      Always Make Workers\n" : "");
     ss << (useSupplyBounding ?                 "\tUSE      Supply Bounding\n" : "");
+    ss << (useTranspositionTable ?             "\tUSE      Transposition Table\n" : "");
+    ss << (useIterativeDeepening ?             "\tUSE      Iterative Deepening\n" : "");
+    ss << (searchAlgorithm == SearchAlgorithms::Beam ? "\tUSE      Beam Search\n" : "");
     ss << ("\n");
 
     for (ActionID a(0); a < repetitionValues.size(); ++a)
@@ -5,9 +5,23 @@
 #include "GameState.h"
 #include "DFBB_BuildOrderSearchSaveState.h"
 
+#include <atomic>
+
 namespace BOSS
 {
 
+namespace ChildOrders
+{
+    enum { ActionIDOrder, EarliestFirst, ClosestToGoal, History, NumChildOrders };
+}
+typedef int ChildOrder;
+
+namespace SearchAlgorithms
+{
+    enum { DFBB, Beam, NumSearchAlgorithms };
+}
+typedef int SearchAlgorithm;
+
 class DFBB_BuildOrderSearchParameters
 {
 
@@ -71,13 +85,71 @@ public:
     bool useLandmarkLowerBoundHeuristic;
     bool useResourceLowerBoundHeuristic;
 
+    //      Flag which determines whether or not we use a transposition table in our search
+    //      Different orders of the same actions often reach the same state. With a transposition
+    //          table, a state is not expanded again if the same state with at least as many
+    //          resources was already expanded. transpositionTableSize is the number of buckets
+    //          in the table, two states each.
+    //
+    //      true:  the transposition table is used
+    //      false: the transposition table is not used
+    bool useTranspositionTable;
+    size_t transpositionTableSize;
+
+    //      Number of threads used by the search
+    //      With more than one thread, each thread searches its own subtree. A thread that
+    //          runs out of work takes half of the unsearched children of the shallowest node
+    //          of another thread. All threads prune with the same upper bound.
+    size_t numThreads;
+
+    //      Order in which the children of each node are searched
+    //      Every order searches the same tree, so a search that finishes finds a plan with the
+    //          same makespan whatever the order. The order changes how soon good plans are
+    //          found, which is what matters when the search times out.
+    //
+    //      ActionIDOrder:  the order of the relevant actions
+    //      EarliestFirst:  actions that can start soonest first
+    //      ClosestToGoal:  actions after which the lower bound on the goal's finish time is lowest first
+    //      History:        actions that were at the same place in the plans found so far first
+    ChildOrder childOrder;
+
+    //      Flag which determines whether or not the search deepens the makespan
+    //      The search is first done with an upper bound a deepeningStep fraction above the
+    //          lower bound of the initial state. Each time it finishes without a plan, the bound
+    //          is raised by another step and the search starts over. The first plan found is
+    //          then within about one step of optimal, and that search goes on to the optimal
+    //          plan as usual. The searches that find nothing are the cost.
+    //
+    //      true:  the makespan is deepened
+    //      false: the search starts with the upper bound
+    bool useIterativeDeepening;
+    double deepeningStep;
+
+    //      Search algorithm used by DFBB_BuildOrderSmartSearch
+    //      The beam search (BeamBuildOrderSearch) keeps only the beamWidth states of each depth
+    //          that look closest to the goal, ranked by the frame plus beamWeight times the lower
+    //          bound to the goal. Each time it runs out of states it starts over with twice the
+    //          width, up to maxBeamWidth, which bounds its memory. It finds good plans for large
+    //          goals quickly, but it only proves a plan optimal if no width was ever too small.
+    //
+    //      DFBB:   depth first branch and bound, the settings above
+    //      Beam:   beam search, the transposition table, threads, child order and deepening are not used
+    SearchAlgorithm searchAlgorithm;
+    size_t beamWidth;
+    size_t maxBeamWidth;
+    double beamWeight;
+
     //      Search time limit measured in milliseconds
     //      If searchTimeLimit is set to a value greater than zero, the search will effectively
-    //          time out and the best solution so far will be used in the results. This is
-    //          accomplished by throwing an exception if the time limit is hit. Time is checked
-    //          once every 1000 nodes expanded, as checking the time is slow.
+    //          time out and the best solution so far will be used in the results. The search
+    //          stops where it is and can be resumed later. Time is checked once every 200 nodes
+    //          expanded, as checking the time is slow.
     double searchTimeLimit;
 
+    //      Flag which stops the search when another thread sets it
+    //      It is checked along with the time limit, and the search stops the same way.
+    const std::atomic<bool> * stopFlag;
+
     //      Initial upper bound for the DFBB search
     //      If this value is set to zero, DFBB search will automatically determine an
     //          appropriate upper bound using an upper bound heuristic. If it is non-zero,
@@ -100,9 +172,9 @@ public:
     void setRepetitions(const ActionType & a,const UnitCountType & repetitions);
     void setRepetitionThreshold(const ActionType & a,const UnitCountType & thresh);
 
-    const UnitCountType & getRepetitions(const ActionType & a);
+    const UnitCountType & getRepetitions(const ActionType & a) const;
     const UnitCountType & getMaxActions(const ActionType & a);
-    const UnitCountType & getRepetitionThreshold(const ActionType & a);
+    const UnitCountType & getRepetitionThreshold(const ActionType & a) const;
 
     std::string toString() const;
 };
@@ -6,9 +6,13 @@ DFBB_BuildOrderSearchResults::DFBB_BuildOrderSearchResults()
     : solved(false)
     , timedOut(false)
     , solutionFound(false)
+    , finished(false)
     , upperBound(0)
     , nodesExpanded(0)
+    , transpositionCutoffs(0)
     , timeElapsed(0)
+    , upperBoundTime(0)
+    , upperBoundCached(false)
 {
 }
 
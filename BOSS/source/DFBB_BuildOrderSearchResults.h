@@ -17,12 +17,18 @@ public:
 	bool 				        solved;			// whether ot not a solution was found
     bool    			        timedOut;		// did the search time-out?
     bool                        solutionFound;  // did we find any solution
+    bool                        finished;       // the search won't look any further, solved or not
 	
 	int					        upperBound;		// upper bound of first node
 	
 	unsigned long long 	        nodesExpanded;	// number of nodes expanded in the search
+	unsigned long long 	        transpositionCutoffs;	// nodes not expanded because the state was in the transposition table
 	
 	double 				        timeElapsed;	// time elapsed in milliseconds
+    double                      upperBoundTime; // milliseconds spent on the initial upper bound, included in timeElapsed
+    bool                        upperBoundCached;   // the naive plan of the upper bound came from NaiveBuildOrderCache
+
+    std::vector<std::pair<double, int>> improvements;   // time in milliseconds and finish frame of each new best solution
 
     GameState                   finalState;
 	
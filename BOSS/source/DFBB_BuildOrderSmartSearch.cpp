@@ -6,8 +6,16 @@ DFBB_BuildOrderSmartSearch::DFBB_BuildOrderSmartSearch(const RaceID race)
     : _race(race)
     , _params(race)
     , _goal(race)
-    , _stackSearch(race)
     , _searchTimeLimit(30)
+    , _useTranspositionTable(false)
+    , _numThreads(1)
+    , _stopFlag(nullptr)
+    , _initialUpperBound(0)
+    , _childOrder(ChildOrders::ActionIDOrder)
+    , _useIterativeDeepening(false)
+    , _searchAlgorithm(SearchAlgorithms::DFBB)
+    , _stackSearch(race)
+    , _beamSearch(race)
 {
 }
 
@@ -15,11 +23,21 @@ void DFBB_BuildOrderSmartSearch::doSearch()
 {
     BOSS_ASSERT(_initialState.getRace() != Races::None, "Must set initial state before performing search");
 
+    const bool beam = _searchAlgorithm == SearchAlgorithms::Beam;
+
     // if we are resuming a search
-    if (_stackSearch.getResults().timedOut)
+    if (beam ? _beamSearch.getResults().timedOut : _stackSearch.getResults().timedOut)
     {
-        _stackSearch.setTimeLimit(_searchTimeLimit);
-        _stackSearch.search();
+        if (beam)
+        {
+            _beamSearch.setTimeLimit(_searchTimeLimit);
+            _beamSearch.search();
+        }
+        else
+        {
+            _stackSearch.setTimeLimit(_searchTimeLimit);
+            _stackSearch.search();
+        }
     }
     else
     {
@@ -33,13 +51,28 @@ void DFBB_BuildOrderSmartSearch::doSearch()
         _params.supplyBoundingThreshold     = 1.5;
         _params.relevantActions             = _relevantActions;
         _params.searchTimeLimit             = _searchTimeLimit;
+        _params.useTranspositionTable       = _useTranspositionTable;
+        _params.numThreads                  = _numThreads;
+        _params.stopFlag                    = _stopFlag;
+        _params.initialUpperBound           = _initialUpperBound;
+        _params.childOrder                  = _childOrder;
+        _params.useIterativeDeepening       = _useIterativeDeepening;
+        _params.searchAlgorithm             = _searchAlgorithm;
 
         // BWAPI::Broodwar->printf("Constructing new search object time limit is %lf", _params.searchTimeLimit);
-        _stackSearch = DFBB_BuildOrderStackSearch(_params);
-        _stackSearch.search();
+        if (beam)
+        {
+            _beamSearch = BeamBuildOrderSearch(_params);
+            _beamSearch.search();
+        }
+        else
+        {
+            _stackSearch = DFBB_BuildOrderStackSearch(_params);
+            _stackSearch.search();
+        }
     }
 
-    _results = _stackSearch.getResults();
+    _results = beam ? _beamSearch.getResults() : _stackSearch.getResults();
 
     if (_results.solved && !_results.solutionFound)
     {
@@ -307,6 +340,41 @@ void DFBB_BuildOrderSmartSearch::setTimeLimit(int n)
     _searchTimeLimit = n;
 }
 
+void DFBB_BuildOrderSmartSearch::setUseTranspositionTable(bool use)
+{
+    _useTranspositionTable = use;
+}
+
+void DFBB_BuildOrderSmartSearch::setNumThreads(size_t n)
+{
+    _numThreads = n > 0 ? n : 1;
+}
+
+void DFBB_BuildOrderSmartSearch::setStopFlag(const std::atomic<bool> * stopFlag)
+{
+    _stopFlag = stopFlag;
+}
+
+void DFBB_BuildOrderSmartSearch::setInitialUpperBound(int upperBound)
+{
+    _initialUpperBound = upperBound;
+}
+
+void DFBB_BuildOrderSmartSearch::setChildOrder(ChildOrder order)
+{
+    _childOrder = order;
+}
+
+void DFBB_BuildOrderSmartSearch::setUseIterativeDeepening(bool use)
+{
+    _useIterativeDeepening = use;
+}
+
+void DFBB_BuildOrderSmartSearch::setSearchAlgorithm(SearchAlgorithm algorithm)
+{
+    _searchAlgorithm = algorithm;
+}
+
 void DFBB_BuildOrderSmartSearch::search()
 {
     doSearch();
@@ -327,6 +395,8 @@ const DFBB_BuildOrderSearchParameters & DFBB_BuildOrderSmartSearch::getParameter
     _params.useIncreasingRepetitions 	= true;
     _params.useAlwaysMakeWorkers 		= true;
     _params.useSupplyBounding 			= true;
+    _params.supplyBoundingThreshold     = 1.5;
+    _params.relevantActions             = _relevantActions;
 
     return _params;
 }
@@ -3,6 +3,7 @@
 #include "Common.h"
 #include "GameState.h"
 #include "DFBB_BuildOrderStackSearch.h"
+#include "BeamBuildOrderSearch.h"
 #include "Timer.hpp"
 
 namespace BOSS
@@ -19,10 +20,18 @@ class DFBB_BuildOrderSmartSearch
 	GameState					        _initialState;
 	
 	int 							    _searchTimeLimit;
+    bool                                _useTranspositionTable;
+    size_t                              _numThreads;
+    const std::atomic<bool> *           _stopFlag;
+    int                                 _initialUpperBound;
+    ChildOrder                          _childOrder;
+    bool                                _useIterativeDeepening;
+    SearchAlgorithm                     _searchAlgorithm;
 
 	Timer							    _searchTimer;
 
     DFBB_BuildOrderStackSearch          _stackSearch;
+    BeamBuildOrderSearch                _beamSearch;
 
     DFBB_BuildOrderSearchResults        _results;
 	
@@ -47,6 +56,21 @@ public:
 	void setState(const GameState & state);
 	void print();
 	void setTimeLimit(int n);
+    void setUseTranspositionTable(bool use);
+    void setNumThreads(size_t n);
+
+    // the search stops, as if timed out, when another thread sets the flag
+    void setStopFlag(const std::atomic<bool> * stopFlag);
+
+    // the finish frame of a plan known to reach the goal, used instead of the naive search's
+    void setInitialUpperBound(int upperBound);
+
+    // see DFBB_BuildOrderSearchParameters, neither changes the makespan of a finished search
+    void setChildOrder(ChildOrder order);
+    void setUseIterativeDeepening(bool use);
+
+    // DFBB, or the beam search for goals too large for DFBB to finish in time
+    void setSearchAlgorithm(SearchAlgorithm algorithm);
 	
 	void search();
 
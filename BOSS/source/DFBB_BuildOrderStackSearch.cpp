@@ -4,10 +4,13 @@ using namespace BOSS;
 
 DFBB_BuildOrderStackSearch::DFBB_BuildOrderStackSearch(const DFBB_BuildOrderSearchParameters & p)
     : _params(p)
+    , _stack(100, StackData())
     , _depth(0)
     , _firstSearch(true)
     , _wasInterrupted(false)
-    , _stack(100, StackData())
+    , _fullUpperBound(0)
+    , _deepeningBound(0)
+    , _deepeningPass(0)
 {
     
 }
@@ -26,35 +29,77 @@ void DFBB_BuildOrderStackSearch::search()
     {
         if (_firstSearch)
         {
-            _results.upperBound = _params.initialUpperBound ? _params.initialUpperBound : Tools::GetUpperBound(_params.initialState, _params.goal);
+            _results.upperBound = _params.initialUpperBound ? _params.initialUpperBound : Tools::GetUpperBound(_params.initialState, _params.goal, &_results.upperBoundCached);
+            _results.upperBoundTime = _searchTimer.getElapsedTimeInMilliSec();
             
             // add one frame to the upper bound so our strictly lesser than check still works if we have an exact upper bound
             _results.upperBound += 1;
 
             _stack[0].state = _params.initialState;
             _firstSearch = false;
+
+            if (_params.useTranspositionTable)
+            {
+                _transpositionTable.resize(_params.transpositionTableSize);
+            }
+
+            _lowerBoundTable.init(_params.goal, _params.initialState.getRace(), LOWER_BOUND_TABLE_SIZE);
             //BWAPI::Broodwar->printf("Upper bound is %d", _results.upperBound);
             std::cout << "Upper bound is: " << _results.upperBound << std::endl;
-        }
 
-        try 
-        {
-            // search on the initial state
-            DFBB();
+            if (_params.childOrder == ChildOrders::History)
+            {
+                _history.assign(HISTORY_TABLE_POSITIONS * Constants::MAX_ACTION_TYPES, 0);
+            }
 
-            _results.timedOut = false;
+            // the first deepening search is bounded by the lower bound itself
+            if (_params.useIterativeDeepening)
+            {
+                _fullUpperBound = _results.upperBound;
+                _results.upperBound = getDeepeningBound();
+            }
         }
-        catch (int e) 
+        else if (_deepeningBound)
+        {
+            _results.upperBound = _deepeningBound;
+            _deepeningBound = 0;
+        }
+
+        // search on the initial state, or continue an interrupted search where it stopped
+        while (true)
         {
-            if (e == DFBB_TIMEOUT_EXCEPTION)
+            _wasInterrupted = false;
+            if (_params.numThreads > 1)
+            {
+                searchParallel();
+            }
+            else
+            {
+                DFBB();
+            }
+
+            // a deepening search that finished without a solution proves nothing finishes before its bound
+            if (!_params.useIterativeDeepening || _wasInterrupted || _results.solutionFound || _results.upperBound >= _fullUpperBound)
             {
-                //BWAPI::Broodwar->printf("I timed out!");
-                _results.timedOut = true;
+                break;
             }
+
+            _results.upperBound = getDeepeningBound();
+            startDeepeningPass();
+        }
+
+        // until a solution is found the bound is only the deepening one, report the real one
+        if (_params.useIterativeDeepening && _wasInterrupted && !_results.solutionFound)
+        {
+            _deepeningBound = _results.upperBound;
+            _results.upperBound = _fullUpperBound;
         }
+
+        _results.timedOut = _wasInterrupted;
         
         double ms = _searchTimer.getElapsedTimeInMilliSec();
         _results.solved = !_results.timedOut;
+        _results.finished = _results.solved;
         _results.timeElapsed = ms;
     }
 }
@@ -64,48 +109,98 @@ const DFBB_BuildOrderSearchResults & DFBB_BuildOrderStackSearch::getResults() co
     return _results;
 }
 
+// The upper bound of the next deepening search: deepeningStep more of the initial state's
+// lower bound than the last one, plus the one frame every upper bound gets.
+int DFBB_BuildOrderStackSearch::getDeepeningBound()
+{
+    const FrameCountType frame = _params.initialState.getCurrentFrame();
+    const FrameCountType lowerBound = _lowerBoundTable.getLowerBound(_params.initialState, _params.goal);
+
+    int bound = frame + (int)(lowerBound * (1 + _params.deepeningStep * _deepeningPass)) + 1;
+    if (_deepeningPass > 0)
+    {
+        bound = std::max(bound, _results.upperBound + 1);
+    }
+    ++_deepeningPass;
+
+    return std::min(bound, _fullUpperBound);
+}
+
+// Search from the initial state again, with the new bound.
+// The transposition tables are cleared, since every state in them was stored with a lower bound.
+void DFBB_BuildOrderStackSearch::startDeepeningPass()
+{
+    _depth = 0;
+    _stack[0].state = _params.initialState;
+    _transpositionTable.clear();
+
+    for (auto & worker : _workers)
+    {
+        worker->transpositionTable.clear();
+    }
+
+    if (!_workers.empty())
+    {
+        DFBB_Worker & first = *_workers[0];
+        first.depth = 0;
+        first.stack[0].state = _params.initialState;
+        first.prefix.clear();
+        first.buildOrder.clear();
+        first.resumeInLoop = false;
+        first.hasWork = true;
+    }
+}
+
 void DFBB_BuildOrderStackSearch::generateLegalActions(const GameState & state, ActionSet & legalActions)
+{
+    GenerateLegalActions(_params, state, legalActions);
+}
+
+// The children of a state: the relevant actions that are legal and still wanted by the goal,
+// less the ones the supply bounding and always make workers settings rule out.
+void DFBB_BuildOrderStackSearch::GenerateLegalActions(const DFBB_BuildOrderSearchParameters & params, const GameState & state, ActionSet & legalActions)
 {
     legalActions.clear();
-    BuildOrderSearchGoal & goal = _params.goal;
+    const BuildOrderSearchGoal & goal = params.goal;
     const ActionType & worker = ActionTypes::GetWorker(state.getRace());
     
     // add all legal relevant actions that are in the goal
-    for (size_t a(0); a < _params.relevantActions.size(); ++a)
+    for (size_t a(0); a < params.relevantActions.size(); ++a)
     {
-        const ActionType & actionType = _params.relevantActions[a];
-        const std::string & actionName = actionType.getName();
+        const ActionType & actionType = params.relevantActions[a];
         const size_t numTotal = state.getUnitData().getNumTotal(actionType);
 
-        if (state.isLegal(actionType))
+        // the goal checks are cheap, so they go before isLegal
+
+        // if there's none of this action in the goal it's not legal
+        if (!goal.getGoal(actionType) && !goal.getGoalMax(actionType))
         {
-            // if there's none of this action in the goal it's not legal
-            if (!goal.getGoal(actionType) && !goal.getGoalMax(actionType))
-            {
-                continue;
-            }
+            continue;
+        }
 
-            // if we already have more than the goal it's not legal
-            if (goal.getGoal(actionType) && (numTotal >= goal.getGoal(actionType)))
-            {
-                continue;
-            }
+        // if we already have more than the goal it's not legal
+        if (goal.getGoal(actionType) && (numTotal >= goal.getGoal(actionType)))
+        {
+            continue;
+        }
 
-            // if we already have more than the goal max it's not legal
-            if (goal.getGoalMax(actionType) && (numTotal >= goal.getGoalMax(actionType)))
-            {
-                continue;
-            }
-            
-            legalActions.add(_params.relevantActions[a]);
+        // if we already have more than the goal max it's not legal
+        if (goal.getGoalMax(actionType) && (numTotal >= goal.getGoalMax(actionType)))
+        {
+            continue;
+        }
+
+        if (state.isLegal(actionType))
+        {
+            legalActions.add(params.relevantActions[a]);
         }
     }
 
     // if we enabled the supply bounding flag
-    if (_params.useSupplyBounding)
+    if (params.useSupplyBounding)
     {
         UnitCountType supplySurplus = state.getUnitData().getMaxSupply() + state.getUnitData().getSupplyInProgress() - state.getUnitData().getCurrentSupply();
-        UnitCountType threshold = (UnitCountType)(ActionTypes::GetSupplyProvider(state.getRace()).supplyProvided() * _params.supplyBoundingThreshold);
+        UnitCountType threshold = (UnitCountType)(ActionTypes::GetSupplyProvider(state.getRace()).supplyProvided() * params.supplyBoundingThreshold);
 
         if (supplySurplus >= threshold)
         {
@@ -114,7 +209,7 @@ void DFBB_BuildOrderStackSearch::generateLegalActions(const GameState & state, A
     }
     
     // if we enabled the always make workers flag, and workers are legal
-    if (_params.useAlwaysMakeWorkers && legalActions.contains(worker))
+    if (params.useAlwaysMakeWorkers && legalActions.contains(worker))
     {
         bool actionLegalBeforeWorker = false;
         ActionSet legalEqualWorker;
@@ -147,26 +242,124 @@ void DFBB_BuildOrderStackSearch::generateLegalActions(const GameState & state, A
     }
 }
 
+// Put the legal actions of a state in the order of _params.childOrder.
+// position is the number of actions taken to reach the state, for the history order.
+// The closest to goal order keeps the children it builds, so the search doesn't build them again.
+void DFBB_BuildOrderStackSearch::orderLegalActions(StackData & frame, const size_t position, const int upperBound, const std::vector<int> & history, LowerBoundTable & lowerBoundTable)
+{
+    const GameState & state = frame.state;
+    ActionSet & legalActions = frame.legalActions;
+    frame.children.clear();
+
+    if (_params.childOrder == ChildOrders::ActionIDOrder || legalActions.size() < 2)
+    {
+        return;
+    }
+
+    int keys[Constants::MAX_ACTION_TYPES];
+    const size_t row = std::min(position, (size_t)HISTORY_TABLE_POSITIONS - 1) * Constants::MAX_ACTION_TYPES;
+
+    for (size_t a(0); a < legalActions.size(); ++a)
+    {
+        const ActionType & action = legalActions[a];
+
+        if (_params.childOrder == ChildOrders::EarliestFirst)
+        {
+            keys[a] = state.whenCanPerform(action);
+        }
+        else if (_params.childOrder == ChildOrders::ClosestToGoal)
+        {
+            // a child the search will prune anyway isn't worth building, the upper bound only goes down
+            const int finishTime = state.whenCanPerform(action) + action.buildTime();
+            if (std::max(finishTime, (int)frame.lowerBound) > upperBound)
+            {
+                frame.childIndex[action.ID()] = -1;
+                keys[a] = finishTime;
+                continue;
+            }
+
+            frame.childIndex[action.ID()] = (int)frame.children.size();
+            frame.children.push_back(state);
+            GameState & child = frame.children.back();
+            child.doAction(action);
+
+            const int lowerBound = child.getCurrentFrame() + lowerBoundTable.getLowerBound(child, _params.goal);
+            keys[a] = std::max((int)child.getLastActionFinishTime(), lowerBound);
+        }
+        else
+        {
+            keys[a] = -history[row + action.ID()];
+        }
+    }
+
+    legalActions.sortByKey(keys);
+}
+
+void DFBB_BuildOrderStackSearch::addToHistory(std::vector<int> & history, const BuildOrder & buildOrder) const
+{
+    if (history.empty())
+    {
+        return;
+    }
+
+    for (size_t i(0); i < buildOrder.size(); ++i)
+    {
+        const size_t row = std::min(i, (size_t)HISTORY_TABLE_POSITIONS - 1) * Constants::MAX_ACTION_TYPES;
+        history[row + buildOrder[i].ID()]++;
+    }
+}
+
+double DFBB_BuildOrderStackSearch::benchmarkLegalActions(const std::vector<GameState> & states, const size_t iterations)
+{
+    ActionSet legalActions;
+    size_t numLegal = 0;
+
+    Timer timer;
+    timer.start();
+    for (size_t i(0); i < iterations; ++i)
+    {
+        for (size_t s(0); s < states.size(); ++s)
+        {
+            generateLegalActions(states[s], legalActions);
+            numLegal += legalActions.size();
+        }
+    }
+    double ms = timer.getElapsedTimeInMilliSec();
+
+    // use the result, so the calls aren't optimized away
+    if (numLegal == 0)
+    {
+        std::cout << "no legal actions" << std::endl;
+    }
+
+    return iterations * states.size() > 0 ? ms * 1000000 / (iterations * states.size()) : 0;
+}
+
 UnitCountType DFBB_BuildOrderStackSearch::getRepetitions(const GameState & state, const ActionType & a)
+{
+    return GetRepetitions(_params, state, a);
+}
+
+UnitCountType DFBB_BuildOrderStackSearch::GetRepetitions(const DFBB_BuildOrderSearchParameters & params, const GameState & state, const ActionType & a)
 {
     // set the repetitions if we are using repetitions, otherwise set to 1
-    int repeat = _params.useRepetitions ? _params.getRepetitions(a) : 1;
+    int repeat = params.useRepetitions ? params.getRepetitions(a) : 1;
 
     // if we are using increasing repetitions
-    if (_params.useIncreasingRepetitions)
+    if (params.useIncreasingRepetitions)
     {
         // if we don't have the threshold amount of units, use a repetition value of 1
-        repeat = state.getUnitData().getNumTotal(a) >= _params.getRepetitionThreshold(a) ? repeat : 1;
+        repeat = state.getUnitData().getNumTotal(a) >= params.getRepetitionThreshold(a) ? repeat : 1;
     }
 
     // make sure we don't repeat to more than we need for this unit type
-    if (_params.goal.getGoal(a))
+    if (params.goal.getGoal(a))
     {
-        repeat = std::min(repeat, _params.goal.getGoal(a) - state.getUnitData().getNumTotal(a));
+        repeat = std::min(repeat, params.goal.getGoal(a) - state.getUnitData().getNumTotal(a));
     }
-    else if (_params.goal.getGoalMax(a))
+    else if (params.goal.getGoalMax(a))
     {
-        repeat = std::min(repeat, _params.goal.getGoalMax(a) - state.getUnitData().getNumTotal(a));
+        repeat = std::min(repeat, params.goal.getGoalMax(a) - state.getUnitData().getNumTotal(a));
     }
     
     return repeat;
@@ -174,7 +367,12 @@ UnitCountType DFBB_BuildOrderStackSearch::getRepetitions(const GameState & state
 
 bool DFBB_BuildOrderStackSearch::isTimeOut()
 {
-    return (_params.searchTimeLimit && (_results.nodesExpanded % 200 == 0) && (_searchTimer.getElapsedTimeInMilliSec() > _params.searchTimeLimit));
+    if (_results.nodesExpanded % 200 != 0)
+    {
+        return false;
+    }
+
+    return (_params.stopFlag && *_params.stopFlag) || (_params.searchTimeLimit && (_searchTimer.getElapsedTimeInMilliSec() > _params.searchTimeLimit));
 }
 
 void DFBB_BuildOrderStackSearch::updateResults(const GameState & state)
@@ -189,6 +387,8 @@ void DFBB_BuildOrderStackSearch::updateResults(const GameState & state)
         _results.solutionFound = true;
         _results.finalState = state;
         _results.buildOrder = _buildOrder;
+        _results.improvements.push_back(std::make_pair(_results.timeElapsed, finishTime));
+        addToHistory(_history, _buildOrder);
 
         _results.printResults(true);
     }
@@ -201,6 +401,7 @@ void DFBB_BuildOrderStackSearch::updateResults(const GameState & state)
 #define LEGAL_ACTINS    _stack[_depth].legalActions
 #define REPETITIONS     _stack[_depth].repetitionValue
 #define COMPLETED_REPS  _stack[_depth].completedRepetitions
+#define LOWER_BOUND     _stack[_depth].lowerBound
 
 #define DFBB_CALL_RETURN  if (_depth == 0) { return; } else { --_depth; goto SEARCH_RETURN; }
 #define DFBB_CALL_RECURSE { ++_depth; goto SEARCH_BEGIN; }
@@ -209,26 +410,49 @@ void DFBB_BuildOrderStackSearch::updateResults(const GameState & state)
 void DFBB_BuildOrderStackSearch::DFBB()
 {
     FrameCountType actionFinishTime = 0;
-    FrameCountType heuristicTime = 0;
     FrameCountType maxHeuristic = 0;
+    const GameState * builtChild = nullptr;
 
 SEARCH_BEGIN:
 
     _results.nodesExpanded++;
 
+    // the stack stays as it is, so the next call to DFBB() continues from this node
     if (isTimeOut())
     {
-        throw DFBB_TIMEOUT_EXCEPTION;
+        _wasInterrupted = true;
+        return;
+    }
+
+    // if an equal or better state was already expanded, anything below this one was already found
+    // a state is stored after the time out check, so a resumed search doesn't prune its own node
+    if (!_transpositionTable.isEmpty())
+    {
+        const HashType hash = STATE.getHash();
+        if (_transpositionTable.isDominated(hash, STATE, _results.upperBound))
+        {
+            _results.transpositionCutoffs++;
+            DFBB_CALL_RETURN;
+        }
+
+        _transpositionTable.store(hash, STATE, _results.upperBound, _depth);
+    }
+
+    // the bound is the same for every child, and if it is already too late no child can be better
+    LOWER_BOUND = STATE.getCurrentFrame() + _lowerBoundTable.getLowerBound(STATE, _params.goal);
+    if (LOWER_BOUND > _results.upperBound)
+    {
+        DFBB_CALL_RETURN;
     }
 
     generateLegalActions(STATE, LEGAL_ACTINS);
+    orderLegalActions(_stack[_depth], _buildOrder.size(), _results.upperBound, _history, _lowerBoundTable);
     for (CHILD_NUM = 0; CHILD_NUM < LEGAL_ACTINS.size(); ++CHILD_NUM)
     {
         ACTION_TYPE = LEGAL_ACTINS[CHILD_NUM];
 
         actionFinishTime = STATE.whenCanPerform(ACTION_TYPE) + ACTION_TYPE.buildTime();
-        heuristicTime    = STATE.getCurrentFrame() + Tools::GetLowerBound(STATE, _params.goal);
-        maxHeuristic     = (actionFinishTime > heuristicTime) ? actionFinishTime : heuristicTime;
+        maxHeuristic     = (actionFinishTime > LOWER_BOUND) ? actionFinishTime : LOWER_BOUND;
 
         if (maxHeuristic > _results.upperBound)
         {
@@ -238,9 +462,16 @@ SEARCH_BEGIN:
         REPETITIONS = getRepetitions(STATE, ACTION_TYPE);
         BOSS_ASSERT(REPETITIONS > 0, "Can't have zero repetitions!");
                 
-        // do the action as many times as legal to to 'repeat'
-        CHILD_STATE = STATE;
+        // do the action as many times as legal to to 'repeat', the first time may have been done when ordering
+        builtChild = _stack[_depth].getChild(ACTION_TYPE);
+        CHILD_STATE = builtChild ? *builtChild : STATE;
         COMPLETED_REPS = 0;
+        if (builtChild)
+        {
+            _buildOrder.add(ACTION_TYPE);
+            ++COMPLETED_REPS;
+        }
+
         for (; COMPLETED_REPS < REPETITIONS; ++COMPLETED_REPS)
         {
             if (CHILD_STATE.isLegal(ACTION_TYPE))
@@ -272,4 +503,371 @@ SEARCH_RETURN:
     }
 
     DFBB_CALL_RETURN;
-}
\ No newline at end of file
+}
+
+// Run the search on _params.numThreads threads, this one included.
+// The first call gives the whole tree to the first worker; the others start out stealing.
+// After a time out the workers keep their stacks, and the next call carries on from there.
+void DFBB_BuildOrderStackSearch::searchParallel()
+{
+    if (_workers.empty())
+    {
+        _parallel = std::make_shared<DFBB_ParallelData>();
+
+        for (size_t i(0); i < _params.numThreads; ++i)
+        {
+            _workers.push_back(std::make_shared<DFBB_Worker>(_stack.size()));
+
+            if (_params.useTranspositionTable)
+            {
+                _workers[i]->transpositionTable.resize(_params.transpositionTableSize);
+            }
+
+            _workers[i]->lowerBoundTable.init(_params.goal, _params.initialState.getRace(), LOWER_BOUND_TABLE_SIZE);
+
+            if (_params.childOrder == ChildOrders::History)
+            {
+                _workers[i]->history.assign(HISTORY_TABLE_POSITIONS * Constants::MAX_ACTION_TYPES, 0);
+            }
+        }
+
+        _workers[0]->stack[0].state = _params.initialState;
+        _workers[0]->hasWork = true;
+    }
+
+    size_t idleWorkers = 0;
+    for (auto & worker : _workers)
+    {
+        worker->timer = _searchTimer;
+        idleWorkers += worker->hasWork ? 0 : 1;
+    }
+
+    _parallel->upperBound = _results.upperBound;
+    _parallel->stop = false;
+    _parallel->timedOut = false;
+    _parallel->idleWorkers = idleWorkers;
+    
+    std::vector<std::thread> threads;
+    for (size_t i(1); i < _workers.size(); ++i)
+    {
+        threads.push_back(std::thread(&DFBB_BuildOrderStackSearch::runWorker, this, i));
+    }
+
+    runWorker(0);
+
+    for (auto & thread : threads)
+    {
+        thread.join();
+    }
+
+    _results.nodesExpanded = 0;
+    _results.transpositionCutoffs = 0;
+    for (auto & worker : _workers)
+    {
+        _results.nodesExpanded += worker->nodesExpanded;
+        _results.transpositionCutoffs += worker->transpositionCutoffs;
+    }
+
+    if (_parallel->error)
+    {
+        std::rethrow_exception(_parallel->error);
+    }
+
+    _wasInterrupted = _parallel->timedOut;
+}
+
+void DFBB_BuildOrderStackSearch::runWorker(const size_t index)
+{
+    DFBB_Worker & worker = *_workers[index];
+
+    try
+    {
+        while (!_parallel->stop)
+        {
+            if (worker.hasWork)
+            {
+                DFBB(worker);
+
+                // stopped in the middle of the subtree
+                if (worker.hasWork)
+                {
+                    break;
+                }
+
+                ++_parallel->idleWorkers;
+            }
+
+            if (!steal(index))
+            {
+                // nobody has anything left to steal, the search is over
+                if (_parallel->idleWorkers == _workers.size())
+                {
+                    break;
+                }
+
+                std::this_thread::yield();
+            }
+        }
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock(_parallel->resultsMutex);
+
+        if (!_parallel->error)
+        {
+            _parallel->error = std::current_exception();
+        }
+
+        _parallel->stop = true;
+    }
+}
+
+// Take half of the unsearched children of the shallowest node another worker is on.
+// Shallow nodes have the biggest subtrees, so steals are rare.
+bool DFBB_BuildOrderStackSearch::steal(const size_t index)
+{
+    DFBB_Worker & thief = *_workers[index];
+
+    for (size_t i(1); i < _workers.size(); ++i)
+    {
+        DFBB_Worker & victim = *_workers[(index + i) % _workers.size()];
+        std::lock_guard<std::mutex> victimLock(victim.mutex);
+
+        if (!victim.hasWork)
+        {
+            continue;
+        }
+
+        for (size_t d(0); d <= victim.depth; ++d)
+        {
+            const StackData & frame = victim.stack[d];
+
+            // the child at currentChildIndex is being searched, the ones after it are free
+            if (victim.childEnd[d] <= frame.currentChildIndex + 1)
+            {
+                continue;
+            }
+
+            const size_t take = (victim.childEnd[d] - frame.currentChildIndex) / 2;
+            const size_t begin = victim.childEnd[d] - take;
+
+            std::lock_guard<std::mutex> thiefLock(thief.mutex);
+
+            thief.stack[0].state = frame.state;
+            thief.stack[0].legalActions = frame.legalActions;
+            thief.stack[0].lowerBound = frame.lowerBound;
+            thief.stack[0].children = frame.children;
+            std::copy(frame.childIndex, frame.childIndex + Constants::MAX_ACTION_TYPES, thief.stack[0].childIndex);
+            thief.stack[0].currentChildIndex = begin;
+            thief.childEnd[0] = victim.childEnd[d];
+            victim.childEnd[d] = begin;
+
+            // the frames above this one hold the actions taken to get here
+            thief.prefix = victim.prefix;
+            for (size_t f(0); f < d; ++f)
+            {
+                thief.prefix.add(victim.stack[f].currentActionType, victim.stack[f].completedRepetitions);
+            }
+            thief.buildOrder = thief.prefix;
+
+            thief.depth = 0;
+            thief.resumeInLoop = true;
+            thief.hasWork = true;
+            --_parallel->idleWorkers;
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool DFBB_BuildOrderStackSearch::isTimeOut(DFBB_Worker & worker)
+{
+    if (worker.nodesExpanded % 200 != 0)
+    {
+        return false;
+    }
+
+    return (_params.stopFlag && *_params.stopFlag) || (_params.searchTimeLimit && (worker.timer.getElapsedTimeInMilliSec() > _params.searchTimeLimit));
+}
+
+void DFBB_BuildOrderStackSearch::updateResults(DFBB_Worker & worker, const GameState & state)
+{
+    FrameCountType finishTime = state.getLastActionFinishTime();
+
+    if (finishTime >= _parallel->upperBound)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_parallel->resultsMutex);
+
+    // new best solution
+    if (finishTime < _results.upperBound)
+    {
+        _results.timeElapsed = worker.timer.getElapsedTimeInMilliSec();
+        _results.upperBound = finishTime;
+        _results.solutionFound = true;
+        _results.finalState = state;
+        _results.buildOrder = worker.buildOrder;
+        _results.improvements.push_back(std::make_pair(_results.timeElapsed, finishTime));
+        _parallel->upperBound = finishTime;
+        addToHistory(worker.history, worker.buildOrder);
+
+        _results.printResults(true);
+    }
+}
+
+#define W_ACTION_TYPE       worker.stack[worker.depth].currentActionType
+#define W_STATE             worker.stack[worker.depth].state
+#define W_CHILD_STATE       worker.stack[worker.depth+1].state
+#define W_CHILD_NUM         worker.stack[worker.depth].currentChildIndex
+#define W_CHILD_END         worker.childEnd[worker.depth]
+#define W_LEGAL_ACTIONS     worker.stack[worker.depth].legalActions
+#define W_REPETITIONS       worker.stack[worker.depth].repetitionValue
+#define W_COMPLETED_REPS    worker.stack[worker.depth].completedRepetitions
+#define W_LOWER_BOUND       worker.stack[worker.depth].lowerBound
+
+// The same search as DFBB() on the worker's own stack, for the parallel search.
+// The child ranges and the depth change under the worker's lock, since other workers steal from them.
+// Returns when the worker's subtree is done, or with hasWork still set if the search stopped.
+void DFBB_BuildOrderStackSearch::DFBB(DFBB_Worker & worker)
+{
+    FrameCountType actionFinishTime = 0;
+    FrameCountType maxHeuristic = 0;
+    const GameState * builtChild = nullptr;
+
+    if (worker.resumeInLoop)
+    {
+        worker.resumeInLoop = false;
+        goto WORKER_LOOP;
+    }
+
+WORKER_BEGIN:
+
+    worker.nodesExpanded++;
+
+    if (isTimeOut(worker))
+    {
+        _parallel->timedOut = true;
+        _parallel->stop = true;
+    }
+
+    if (_parallel->stop)
+    {
+        return;
+    }
+
+    if (!worker.transpositionTable.isEmpty())
+    {
+        const HashType hash = W_STATE.getHash();
+        if (worker.transpositionTable.isDominated(hash, W_STATE, _parallel->upperBound))
+        {
+            worker.transpositionCutoffs++;
+            goto WORKER_POP;
+        }
+
+        worker.transpositionTable.store(hash, W_STATE, _parallel->upperBound, worker.depth);
+    }
+
+    W_LOWER_BOUND = W_STATE.getCurrentFrame() + worker.lowerBoundTable.getLowerBound(W_STATE, _params.goal);
+    if (W_LOWER_BOUND > _parallel->upperBound)
+    {
+        goto WORKER_POP;
+    }
+
+    generateLegalActions(W_STATE, W_LEGAL_ACTIONS);
+    orderLegalActions(worker.stack[worker.depth], worker.buildOrder.size(), _parallel->upperBound, worker.history, worker.lowerBoundTable);
+
+    worker.mutex.lock();
+    W_CHILD_NUM = 0;
+    W_CHILD_END = W_LEGAL_ACTIONS.size();
+    worker.mutex.unlock();
+
+WORKER_LOOP:
+
+    worker.mutex.lock();
+    if (W_CHILD_NUM >= W_CHILD_END)
+    {
+        worker.mutex.unlock();
+        goto WORKER_POP;
+    }
+    W_ACTION_TYPE = W_LEGAL_ACTIONS[W_CHILD_NUM];
+    worker.mutex.unlock();
+
+    actionFinishTime = W_STATE.whenCanPerform(W_ACTION_TYPE) + W_ACTION_TYPE.buildTime();
+    maxHeuristic     = (actionFinishTime > W_LOWER_BOUND) ? actionFinishTime : W_LOWER_BOUND;
+
+    if (maxHeuristic > _parallel->upperBound)
+    {
+        goto WORKER_NEXT;
+    }
+
+    W_REPETITIONS = getRepetitions(W_STATE, W_ACTION_TYPE);
+    BOSS_ASSERT(W_REPETITIONS > 0, "Can't have zero repetitions!");
+
+    // do the action as many times as legal to to 'repeat', the first time may have been done when ordering
+    builtChild = worker.stack[worker.depth].getChild(W_ACTION_TYPE);
+    W_CHILD_STATE = builtChild ? *builtChild : W_STATE;
+    W_COMPLETED_REPS = 0;
+    if (builtChild)
+    {
+        worker.buildOrder.add(W_ACTION_TYPE);
+        ++W_COMPLETED_REPS;
+    }
+
+    for (; W_COMPLETED_REPS < W_REPETITIONS; ++W_COMPLETED_REPS)
+    {
+        if (W_CHILD_STATE.isLegal(W_ACTION_TYPE))
+        {
+            worker.buildOrder.add(W_ACTION_TYPE);
+            W_CHILD_STATE.doAction(W_ACTION_TYPE);
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    if (_params.goal.isAchievedBy(W_CHILD_STATE))
+    {
+        updateResults(worker, W_CHILD_STATE);
+    }
+    else
+    {
+        worker.mutex.lock();
+        ++worker.depth;
+        W_CHILD_NUM = 0;
+        W_CHILD_END = 0;
+        worker.mutex.unlock();
+        goto WORKER_BEGIN;
+    }
+
+WORKER_RETURN:
+
+    for (size_t r(0); r < W_COMPLETED_REPS; ++r)
+    {
+        worker.buildOrder.pop_back();
+    }
+
+WORKER_NEXT:
+
+    worker.mutex.lock();
+    ++W_CHILD_NUM;
+    worker.mutex.unlock();
+    goto WORKER_LOOP;
+
+WORKER_POP:
+
+    worker.mutex.lock();
+    if (worker.depth == 0)
+    {
+        worker.hasWork = false;
+        worker.mutex.unlock();
+        return;
+    }
+    --worker.depth;
+    worker.mutex.unlock();
+    goto WORKER_RETURN;
+}
@@ -7,8 +7,16 @@
 #include "Timer.hpp"
 #include "Tools.h"
 #include "BuildOrder.h"
+#include "TranspositionTable.h"
+#include "LowerBoundTable.h"
 
-#define DFBB_TIMEOUT_EXCEPTION 1
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <memory>
+
+#define LOWER_BOUND_TABLE_SIZE 4096
+#define HISTORY_TABLE_POSITIONS 64
 
 namespace BOSS
 {
@@ -23,11 +31,78 @@ public:
     ActionType          currentActionType;
     UnitCountType       repetitionValue;
     UnitCountType       completedRepetitions;
+    FrameCountType      lowerBound;             // earliest frame the goal could be met from this state
+    std::vector<GameState> children;            // the children the closest to goal order was computed from
+    int                 childIndex[Constants::MAX_ACTION_TYPES];   // index in children by action ID, -1 if not built
     
     StackData()
         : currentChildIndex(0)
         , repetitionValue(1)
         , completedRepetitions(0)
+        , lowerBound(0)
+    {
+    
+    }
+
+    // the state after doing the action once, if it was already built when ordering the children
+    const GameState * getChild(const ActionType & action) const
+    {
+        return (!children.empty() && childIndex[action.ID()] >= 0) ? &children[childIndex[action.ID()]] : nullptr;
+    }
+};
+
+// One thread of the parallel search. Its stack starts at the root of the subtree it is searching,
+// and idle workers steal the unsearched children of the shallowest frames of busy workers.
+class DFBB_Worker
+{
+public:
+
+    std::vector<StackData>              stack;
+    std::vector<size_t>                 childEnd;       // children [currentChildIndex, childEnd) of each frame are this worker's
+    size_t                              depth;
+    bool                                hasWork;        // a subtree is being searched, or was when the search timed out
+    bool                                resumeInLoop;   // the root frame's legal actions were stolen, don't generate them
+    BuildOrder                          prefix;         // actions from the initial state to the root of the subtree
+    BuildOrder                          buildOrder;     // prefix followed by the actions of the current path
+    Timer                               timer;
+    TranspositionTable                  transpositionTable;
+    LowerBoundTable                     lowerBoundTable;
+    std::vector<int>                    history;        // the history child order of this worker's own solutions
+    unsigned long long                  nodesExpanded;
+    unsigned long long                  transpositionCutoffs;
+
+    std::mutex                          mutex;          // guards depth, hasWork and the child ranges
+
+    DFBB_Worker(const size_t stackSize)
+        : stack(stackSize, StackData())
+        , childEnd(stackSize, 0)
+        , depth(0)
+        , hasWork(false)
+        , resumeInLoop(false)
+        , nodesExpanded(0)
+        , transpositionCutoffs(0)
+    {
+    
+    }
+};
+
+// What the workers of a parallel search share
+class DFBB_ParallelData
+{
+public:
+
+    std::atomic<int>                    upperBound;
+    std::atomic<bool>                   stop;
+    std::atomic<bool>                   timedOut;
+    std::atomic<size_t>                 idleWorkers;
+    std::mutex                          resultsMutex;
+    std::exception_ptr                  error;
+
+    DFBB_ParallelData()
+        : upperBound(0)
+        , stop(false)
+        , timedOut(false)
+        , idleWorkers(0)
     {
     
     }
@@ -42,12 +117,30 @@ class DFBB_BuildOrderStackSearch
     BuildOrder                          _buildOrder;
 
     std::vector<StackData>              _stack;
+    TranspositionTable                  _transpositionTable;
+    LowerBoundTable                     _lowerBoundTable;
+
+    // how often each action was at each position of the solutions found so far,
+    // HISTORY_TABLE_POSITIONS rows of one count per action ID, the last row for all later positions
+    std::vector<int>                    _history;
+
+    std::vector<std::shared_ptr<DFBB_Worker>> _workers;
+    std::shared_ptr<DFBB_ParallelData>  _parallel;
     size_t                              _depth;
 
     bool                                _firstSearch;
 
     bool                                _wasInterrupted;
+
+    int                                 _fullUpperBound;        // upper bound of the whole search, when deepening
+    int                                 _deepeningBound;        // bound of a deepening search that was interrupted, 0 if none
+    int                                 _deepeningPass;
     
+    void                                orderLegalActions(StackData & frame, const size_t position, const int upperBound, const std::vector<int> & history, LowerBoundTable & lowerBoundTable);
+    void                                addToHistory(std::vector<int> & history, const BuildOrder & buildOrder) const;
+    int                                 getDeepeningBound();
+    void                                startDeepeningPass();
+
     void                                updateResults(const GameState & state);
     bool                                isTimeOut();
     void                                calculateRecursivePrerequisites(const ActionType & action, ActionSet & all);
@@ -56,6 +149,13 @@ class DFBB_BuildOrderStackSearch
     UnitCountType                       getRepetitions(const GameState & state, const ActionType & a);
     ActionSet                           calculateRelevantActions();
 
+    void                                searchParallel();
+    void                                runWorker(const size_t index);
+    bool                                steal(const size_t index);
+    bool                                isTimeOut(DFBB_Worker & worker);
+    void                                updateResults(DFBB_Worker & worker, const GameState & state);
+    void                                DFBB(DFBB_Worker & worker);
+
 public:
 	
 	DFBB_BuildOrderStackSearch(const DFBB_BuildOrderSearchParameters & p);
@@ -65,6 +165,13 @@ public:
     const DFBB_BuildOrderSearchResults & getResults() const;
 	
 	void DFBB();
+
+    // the children of a state and how many times to repeat each, shared with BeamBuildOrderSearch
+    static void GenerateLegalActions(const DFBB_BuildOrderSearchParameters & params, const GameState & state, ActionSet & legalActions);
+    static UnitCountType GetRepetitions(const DFBB_BuildOrderSearchParameters & params, const GameState & state, const ActionType & a);
+
+    // generate the legal actions of each state this many times, returns the mean nanoseconds per state
+    double benchmarkLegalActions(const std::vector<GameState> & states, const size_t iterations);
 	
 	
 };
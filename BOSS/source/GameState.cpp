@@ -1,27 +1,28 @@
 #include "GameState.h"
+#include "TranspositionTable.h"
 
 using namespace BOSS;
 
 
 GameState::GameState(const RaceID r)
-    : _race                 (r)
-    , _units                (r)
-    , _currentFrame         (0)
+    : _currentFrame         (0)
     , _lastActionFrame      (0)
     , _minerals             (0)
     , _gas                  (0)
+    , _race                 (r)
+    , _units                (r)
 {
     
 }
 
 #ifdef _MSC_VER
 GameState::GameState(BWAPI::GameWrapper & game, BWAPI::PlayerInterface * self, const std::vector<BWAPI::UnitType> & buildingsQueued)
-    : _race                 (Races::GetRaceID(self->getRace()))
-    , _currentFrame         (game->getFrameCount())
+    : _currentFrame         (game->getFrameCount())
     , _lastActionFrame      (0)
-    , _units                (Races::GetRaceID(self->getRace()))
     , _minerals             (self->minerals() * Constants::RESOURCE_SCALE)
     , _gas                  (self->gas() * Constants::RESOURCE_SCALE)
+    , _race                 (Races::GetRaceID(self->getRace()))
+    , _units                (Races::GetRaceID(self->getRace()))
 { 
     // we will count the worker jobs as we add units
     UnitCountType mineralWorkerCount    = 0;
@@ -227,6 +228,7 @@ void GameState::setStartingState()
     }
 
     _units.setCurrentSupply(8);
+    _readyTimes.clear();
 }
 
 const RaceID GameState::getRace() const
@@ -336,31 +338,21 @@ bool GameState::isLegal(const ActionType & action) const
 }
 
 // do an action, action must be legal for this not to break
-std::vector<ActionType> GameState::doAction(const ActionType & action)
+void GameState::doAction(const ActionType & action, std::vector<ActionType> * actionsFinished)
 {
     BOSS_ASSERT(action.getRace() == _race, "Race of action does not match race of the state");
 
-    _actionsPerformed.push_back(ActionPerformed());
-    _actionsPerformed[_actionsPerformed.size()-1].actionType = action;
-
-    BOSS_ASSERT(isLegal(action), "Trying to perform an illegal action: %s %s", action.getName().c_str(), getActionsPerformedString().c_str());
+    BOSS_ASSERT(isLegal(action), "Trying to perform an illegal action: %s at frame %d", action.getName().c_str(), (int)_currentFrame);
     
     // set the actionPerformed
     _actionPerformed = action;
     _actionPerformedK = 1;
 
-    FrameCountType workerReadyTime = whenWorkerReady(action);
     FrameCountType ffTime = whenCanPerform(action);
 
-    const std::string & name = action.getName();
-
     BOSS_ASSERT(ffTime >= 0 && ffTime < 1000000, "FFTime is very strange: %d", ffTime);
 
-    auto actionsFinished = fastForward(ffTime);
-
-    _actionsPerformed[_actionsPerformed.size()-1].actionQueuedFrame = _currentFrame;
-    _actionsPerformed[_actionsPerformed.size()-1].gasWhenQueued = _gas;
-    _actionsPerformed[_actionsPerformed.size()-1].mineralsWhenQueued = _minerals;
+    fastForward(ffTime, actionsFinished);
 
     // how much time has elapsed since the last action was queued?
     FrameCountType elapsed(_currentFrame - _lastActionFrame);
@@ -415,11 +407,11 @@ std::vector<ActionType> GameState::doAction(const ActionType & action)
         }
      }
 
-	return actionsFinished;
+    _readyTimes.clear();
 }
 
 // fast forwards the current state to time toFrame
-std::vector<ActionType> GameState::fastForward(const FrameCountType toFrame)
+void GameState::fastForward(const FrameCountType toFrame, std::vector<ActionType> * actionsFinished)
 {
     // fast forward the building timers to the current frame
     FrameCountType previousFrame = _currentFrame;
@@ -431,8 +423,6 @@ std::vector<ActionType> GameState::fastForward(const FrameCountType toFrame)
     ResourceCountType   moreGas             = 0;
     ResourceCountType   moreMinerals        = 0;
 
-
-	std::vector<ActionType> actionsFinished;
     // while we still have units in progress
     while ((_units.getNumActionsInProgress() > 0) && (_units.getNextActionFinishTime() <= toFrame))
     {
@@ -448,7 +438,12 @@ std::vector<ActionType> GameState::fastForward(const FrameCountType toFrame)
         lastActionFinished 	= _units.getNextActionFinishTime();
 
         // finish the action, which updates mineral and gas rates if required
-		actionsFinished.push_back(_units.finishNextActionInProgress());
+        const ActionType finished = _units.finishNextActionInProgress();
+
+        if (actionsFinished)
+        {
+            actionsFinished->push_back(finished);
+        }
     }
 
     // update resources from the last action finished to toFrame
@@ -468,13 +463,17 @@ std::vector<ActionType> GameState::fastForward(const FrameCountType toFrame)
         _units.getHatcheryData().fastForward(previousFrame, toFrame);
     }
 
-	return actionsFinished;
+    _readyTimes.clear();
 }
 
 // returns the time at which all resources to perform an action will be available
 const FrameCountType GameState::whenCanPerform(const ActionType & action) const
 {
-    const std::string & name = action.getName();
+    // the search asks this for each legal action, again for each child and again in doAction
+    if (_readyTimes.contains(action.ID()))
+    {
+        return _readyTimes.get(action.ID());
+    }
 
     // the resource times we care about
     FrameCountType mineralTime  (_currentFrame); 	// minerals
@@ -511,6 +510,8 @@ const FrameCountType GameState::whenCanPerform(const ActionType & action) const
     maxVal = (prereqTime >  maxVal) ? prereqTime    : maxVal;
     maxVal = (workerTime >  maxVal) ? workerTime    : maxVal;
 
+    _readyTimes.set(action.ID(), maxVal);
+
     // return the time
     return maxVal;
 }
@@ -617,11 +618,6 @@ const FrameCountType GameState::whenSupplyReady(const ActionType & action) const
 
 const FrameCountType GameState::whenPrerequisitesReady(const ActionType & action) const
 {
-    if (action == ActionTypes::GetActionType("Protoss_Dark_Templar"))
-    {
-        int a = 6;
-    }
-
     FrameCountType preReqReadyTime = _currentFrame;
 
     // if a building builds this action
@@ -634,13 +630,7 @@ const FrameCountType GameState::whenPrerequisitesReady(const ActionType & action
     else
     {
         // if requirement in progress (and not already made), set when it will be finished
-        PrerequisiteSet reqInProgress = _units.getPrerequistesInProgress(action);
-
-        // if it's not empty, check when they will be done
-        if (!reqInProgress.isEmpty())
-        {
-            preReqReadyTime = _units.getFinishTime(reqInProgress);
-        }
+        preReqReadyTime = std::max(preReqReadyTime, _units.getPrerequisitesFinishTime(action));
     }
 
     return preReqReadyTime;
@@ -673,21 +663,11 @@ const FrameCountType GameState::whenBuildingPrereqReady(const ActionType & actio
     // this will give us when the building will be free to build this action
     buildingAvailableTime = std::min(constructedBuildingFreeTime, buildingInProgressFinishTime);
 
-    // get all prerequisites currently in progress but do not have any completed
-    PrerequisiteSet prereqInProgress = _units.getPrerequistesInProgress(action);
-
-    // remove the specific builder from this list since we calculated that earlier
-    prereqInProgress.remove(builder);
+    // the prerequisites in progress with none completed, less the builder since we calculated that earlier
+    FrameCountType C = _units.getPrerequisitesFinishTime(action, builder);
 
-    //// if we actually have some prerequisites in progress other than the building
-    if (!prereqInProgress.isEmpty())
-    {
-        // get the max time the earliest of each type will be finished in
-        FrameCountType C = _units.getFinishTime(prereqInProgress);
-
-        // take the maximum of this value and when the building was available
-        buildingAvailableTime = (C > buildingAvailableTime) ? C : buildingAvailableTime;
-    }
+    // take the maximum of this value and when the building was available
+    buildingAvailableTime = (C > buildingAvailableTime) ? C : buildingAvailableTime;
     
     return buildingAvailableTime;
 }
@@ -899,6 +879,13 @@ const FrameCountType GameState::getCurrentFrame() const
     return _currentFrame;
 }
 
+// Zobrist hash of everything that decides what can be done from this state, except the
+// resources. The transposition table compares those separately, so richer states prune too.
+const HashType GameState::getHash() const
+{
+    return Zobrist::Key(Zobrist::Frame, _currentFrame) + _units.getHash();
+}
+
 const FrameCountType GameState::getLastActionFinishTime() const
 {
     return _units.getLastActionFinishTime();
@@ -998,11 +985,13 @@ const HatcheryData & GameState::getHatcheryData() const
 void GameState::setMinerals(const ResourceCountType & minerals)
 {
     _minerals = minerals * Constants::RESOURCE_SCALE;
+    _readyTimes.clear();
 }
 
 void GameState::setGas(const ResourceCountType & gas)
 {
     _gas = gas * Constants::RESOURCE_SCALE;
+    _readyTimes.clear();
 }
 
 void GameState::addCompletedAction(const ActionType & action, const size_t num)
@@ -1012,6 +1001,8 @@ void GameState::addCompletedAction(const ActionType & action, const size_t num)
         _units.addCompletedAction(action, false);
         _units.setCurrentSupply(_units.getCurrentSupply() + action.supplyRequired());
     }
+
+    _readyTimes.clear();
 }
 
 void GameState::removeCompletedAction(const ActionType & action, const size_t num)
@@ -1021,6 +1012,8 @@ void GameState::removeCompletedAction(const ActionType & action, const size_t nu
 		_units.setCurrentSupply(_units.getCurrentSupply() - action.supplyRequired());
 		_units.removeCompletedAction(action);
 	}
+
+    _readyTimes.clear();
 }
 
 const std::string GameState::toString() const
@@ -1079,18 +1072,6 @@ const std::string GameState::toString() const
     return ss.str();
 }
 
-const std::string GameState::getActionsPerformedString() const
-{
-    std::stringstream ss;
-    ss << std::endl;
-    for (size_t a(0); a<_actionsPerformed.size(); ++a)
-    {
-        ss << (int)_actionsPerformed[a].actionQueuedFrame << " " << (int)_actionsPerformed[a].mineralsWhenQueued << " " << (int)_actionsPerformed[a].gasWhenQueued << " " << _actionsPerformed[a].actionType.getName() << std::endl;
-    }
-
-    return ss.str();
-}
-
 std::string GameState::whyIsNotLegal(const ActionType & action) const
 {
     std::stringstream ss;
@@ -17,38 +17,45 @@ namespace BOSS
 typedef std::pair<ResourceCountType, ResourceCountType>     ResourcePair;
 typedef std::pair<FrameCountType, FrameCountType>           FramePair;
 
-class ActionPerformed
+// whenCanPerform's answer for each action, kept until the state changes.
+// A copy starts out empty, so a child never sees its parent's times and copying never reads them.
+class ReadyTimes
 {
+    static_assert(Constants::MAX_ACTIONS <= 64, "ReadyTimes keeps a bit per action ID");
+
+    unsigned long long          _known;                     // a bit per action ID
+    FrameCountType              _times[Constants::MAX_ACTIONS];
+
 public:
-    ActionType          actionType;
-    FrameCountType      actionQueuedFrame;
-    ResourceCountType   mineralsWhenQueued;
-    ResourceCountType   gasWhenQueued;
-
-    ActionPerformed()
-        : actionQueuedFrame(0)
-        , mineralsWhenQueued(0)
-        , gasWhenQueued(0)
-    {
-    
-    }
+
+    ReadyTimes() : _known(0) { }
+    ReadyTimes(const ReadyTimes &) : _known(0) { }
+    ReadyTimes & operator = (const ReadyTimes &) { _known = 0; return *this; }
+
+    void clear()                                                { _known = 0; }
+    bool contains(const ActionID id) const                      { return (_known >> id) & 1; }
+    FrameCountType get(const ActionID id) const                 { return _times[id]; }
+    void set(const ActionID id, const FrameCountType time)      { _times[id] = time; _known |= 1ull << id; }
 };
 
+// A GameState has no heap members, so copying one for a child node in a search doesn't allocate.
+// The actions that led to a state are kept by the search, in its BuildOrder.
+// The small fields are first, so they share a cache line with the unit counts at the start of UnitData.
 class GameState 
 {
-    UnitData                    _units;  
-    RaceID                      _race;
-
-    ActionType                  _actionPerformed; 		    // the action which generated this state
-    size_t                      _actionPerformedK;
-
     FrameCountType              _currentFrame;
     FrameCountType              _lastActionFrame;		    // the current frame of the game
 
     ResourceCountType           _minerals; 			        // current mineral count
     ResourceCountType           _gas;						// current gas count
 
-    std::vector<ActionPerformed>   _actionsPerformed;
+    RaceID                      _race;
+    ActionType                  _actionPerformed; 		    // the action which generated this state
+    UnitCountType               _actionPerformedK;
+
+    UnitData                    _units;  
+
+    mutable ReadyTimes          _readyTimes;                // cleared by everything that changes the state
 
     const FrameCountType        raceSpecificWhenReady(const ActionType & a) const;
     void                        fixZergUnitMasks();
@@ -71,13 +78,15 @@ public:
     GameState(BWAPI::GameWrapper & game, BWAPI::PlayerInterface * player, const std::vector<BWAPI::UnitType> & buildingsQueued);
 #endif
 
-	std::vector<ActionType>     doAction(const ActionType & action);
-    std::vector<ActionType>     fastForward(const FrameCountType toFrame) ;
+    // actions that finish while moving forward in time are added to actionsFinished, if given
+	void                        doAction(const ActionType & action, std::vector<ActionType> * actionsFinished = nullptr);
+    void                        fastForward(const FrameCountType toFrame, std::vector<ActionType> * actionsFinished = nullptr);
     void                        finishNextActionInProgress();
 
     const FrameCountType        getCurrentFrame()                                                       const;
     const FrameCountType        whenCanPerform(const ActionType & action)                               const;
     const FrameCountType        getLastActionFinishTime()                                               const;
+    const HashType              getHash()                                                               const;
 
     void                        getAllLegalActions(ActionSet & actions)                                 const;
     std::string                 whyIsNotLegal(const ActionType & action)                                const;
@@ -103,7 +112,6 @@ public:
     const ResourceCountType     getFinishTimeGas()              const;
 
     const std::string           toString()                      const;
-    const std::string           getActionsPerformedString()     const;
     const BuildingData &        getBuildingData()               const;
     const HatcheryData &        getHatcheryData()               const;
 
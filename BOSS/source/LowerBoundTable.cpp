@@ -0,0 +1,100 @@
+#include "LowerBoundTable.h"
+#include "Tools.h"
+
+using namespace BOSS;
+
+LowerBoundTable::LowerBoundTable()
+    : _keySize(0)
+    , _mask(0)
+{
+
+}
+
+void LowerBoundTable::addRelevant(const ActionType & action)
+{
+    if (std::find(_relevant.begin(), _relevant.end(), action) != _relevant.end())
+    {
+        return;
+    }
+
+    _relevant.push_back(action);
+
+    const PrerequisiteSet & prerequisites = action.getPrerequisites();
+    for (size_t p(0); p < prerequisites.size(); ++p)
+    {
+        addRelevant(prerequisites.getActionType(p));
+    }
+}
+
+void LowerBoundTable::init(const BuildOrderSearchGoal & goal, const RaceID race, const size_t entries)
+{
+    _relevant.clear();
+    for (size_t a(0); a < ActionTypes::GetAllActionTypes(race).size(); ++a)
+    {
+        const ActionType & actionType = ActionTypes::GetActionType(race, a);
+        if (goal.getGoal(actionType) > 0)
+        {
+            addRelevant(actionType);
+        }
+    }
+
+    _goal.clear();
+    for (const ActionType & actionType : _relevant)
+    {
+        _goal.push_back(goal.getGoal(actionType));
+    }
+
+    size_t size = 1;
+    while (size * 2 <= entries)
+    {
+        size *= 2;
+    }
+
+    _keySize = _relevant.size();
+    _keys.assign(size * _keySize, 0);
+    _bounds.assign(size, -1);
+    _key.assign(_keySize, 0);
+    _mask = size - 1;
+}
+
+bool LowerBoundTable::isEmpty() const
+{
+    return _bounds.empty();
+}
+
+FrameCountType LowerBoundTable::getLowerBound(const GameState & state, const BuildOrderSearchGoal & goal)
+{
+    if (_bounds.empty())
+    {
+        return Tools::GetLowerBound(state, goal);
+    }
+
+    const UnitData & units = state.getUnitData();
+    HashType hash = 0xcbf29ce484222325ULL;
+
+    for (size_t r(0); r < _keySize; ++r)
+    {
+        const ActionType & actionType = _relevant[r];
+        const bool wanted = _goal[r] > units.getNumTotal(actionType);
+        const bool completed = units.getNumCompleted(actionType) > 0;
+        const bool inProgress = !completed && units.getNumInProgress(actionType) > 0;
+        const int untilFinished = inProgress ? units.getFinishTime(actionType) - state.getCurrentFrame() : 0;
+
+        _key[r] = (wanted ? 1 : 0) | (completed ? 2 : 0) | (inProgress ? 4 : 0) | (untilFinished << 3);
+        hash = (hash ^ (HashType)_key[r]) * 0x100000001b3ULL;
+    }
+
+    const size_t index = (size_t)(hash ^ (hash >> 32)) & _mask;
+    int * entryKey = _keySize ? &_keys[index * _keySize] : nullptr;
+
+    if (_bounds[index] >= 0 && std::equal(_key.begin(), _key.end(), entryKey))
+    {
+        return _bounds[index];
+    }
+
+    const FrameCountType lowerBound = Tools::GetLowerBound(state, goal);
+    std::copy(_key.begin(), _key.end(), entryKey);
+    _bounds[index] = lowerBound;
+
+    return lowerBound;
+}
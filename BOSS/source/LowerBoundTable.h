@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Common.h"
+#include "GameState.h"
+#include "BuildOrderSearchGoal.h"
+
+namespace BOSS
+{
+
+// Memo of Tools::GetLowerBound for the goal of one search.
+// The bound only depends on which goal actions are still wanted and, for the goal actions and
+// their prerequisites, on whether one is completed or in progress and how long until the next
+// one finishes. States that agree on these get the same bound, so the table keys on them.
+// Entries keep their whole key, so a hit returns exactly the bound GetLowerBound would.
+class LowerBoundTable
+{
+    std::vector<ActionType>     _relevant;      // goal actions and all their prerequisites
+    std::vector<UnitCountType>  _goal;          // goal count of each relevant action
+    size_t                      _keySize;
+
+    std::vector<int>            _keys;          // _keySize values per entry
+    std::vector<FrameCountType> _bounds;        // -1 if the entry is empty
+    std::vector<int>            _key;           // key of the last state looked up
+    size_t                      _mask;
+
+    void                        addRelevant(const ActionType & action);
+
+public:
+
+    LowerBoundTable();
+
+    // number of entries, rounded down to a power of two
+    void init(const BuildOrderSearchGoal & goal, const RaceID race, const size_t entries);
+    bool isEmpty() const;
+
+    FrameCountType getLowerBound(const GameState & state, const BuildOrderSearchGoal & goal);
+};
+
+}
@@ -0,0 +1,327 @@
+#include "NaiveBuildOrderCache.h"
+#include "NaiveBuildOrderSearch.h"
+#include "Tools.h"
+
+using namespace BOSS;
+
+namespace
+{
+    // FNV-1a over 64 bit values
+    HashType HashCombine(HashType hash, const HashType value)
+    {
+        return (hash ^ value) * 1099511628211ULL;
+    }
+
+    const HashType HashStart = 14695981039346656037ULL;
+}
+
+NaiveBuildOrderCache::Stats::Stats()
+    : hits(0)
+    , patches(0)
+    , misses(0)
+{
+
+}
+
+NaiveBuildOrderCache::NaiveBuildOrderCache()
+    : _capacity(64)
+    , _incremental(true)
+{
+
+}
+
+NaiveBuildOrderCache & NaiveBuildOrderCache::Instance()
+{
+    static NaiveBuildOrderCache instance;
+    return instance;
+}
+
+void NaiveBuildOrderCache::setCapacity(size_t capacity)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    _capacity = capacity;
+    while (_entries.size() > _capacity)
+    {
+        auto state = _byState.find(_entries.back().stateKey);
+        if (state != _byState.end() && state->second == std::prev(_entries.end()))
+        {
+            _byState.erase(state);
+        }
+
+        _byKey.erase(HashCombine(_entries.back().stateKey, _entries.back().goalKey));
+        _entries.pop_back();
+    }
+}
+
+void NaiveBuildOrderCache::setIncremental(bool incremental)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _incremental = incremental;
+}
+
+void NaiveBuildOrderCache::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    _entries.clear();
+    _byKey.clear();
+    _byState.clear();
+    _stats = Stats();
+}
+
+NaiveBuildOrderCache::Stats NaiveBuildOrderCache::getStats() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+}
+
+BuildOrder NaiveBuildOrderCache::getBuildOrder(const GameState & state, const BuildOrderSearchGoal & goal, FrameCountType & finishTime, bool * cached)
+{
+    const RaceID race = state.getRace();
+    std::vector<UnitCountType> goalCounts(ActionTypes::GetAllActionTypes(race).size());
+    for (size_t a(0); a < goalCounts.size(); ++a)
+    {
+        goalCounts[a] = goal.getGoal(ActionTypes::GetActionType(race, a));
+    }
+
+    Entry entry;
+    entry.stateKey = StateKey(state);
+    entry.goalKey = GoalKey(goalCounts);
+    entry.goalCounts = goalCounts;
+
+    // the search and the replays run without the lock, other threads may use the cache meanwhile
+    Entry found;
+    if (find(entry.stateKey, entry.goalKey, goalCounts, found))
+    {
+        const bool sameGoal = found.goalKey == entry.goalKey && found.goalCounts == goalCounts;
+        finishTime = 0;
+
+        try
+        {
+            if (sameGoal)
+            {
+                entry.buildOrder = found.buildOrder;
+            }
+
+            if (sameGoal || Patch(state, found, goalCounts, entry.buildOrder))
+            {
+                finishTime = Tools::GetUpperBound(state, goal, entry.buildOrder);
+            }
+        }
+        catch (const BOSSException &)
+        {
+            // plan it from scratch below
+        }
+
+        if (finishTime > 0)
+        {
+            add(entry);
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            ++(sameGoal ? _stats.hits : _stats.patches);
+
+            if (cached)
+            {
+                *cached = true;
+            }
+
+            return entry.buildOrder;
+        }
+    }
+
+    NaiveBuildOrderSearch naiveSearch(state, goal);
+    entry.buildOrder = naiveSearch.solve();
+    finishTime = entry.buildOrder.getCompletionTime(state);
+    add(entry);
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        ++_stats.misses;
+    }
+
+    if (cached)
+    {
+        *cached = false;
+    }
+
+    return entry.buildOrder;
+}
+
+// The entry for this state and goal, or in the incremental mode the latest for this state.
+bool NaiveBuildOrderCache::find(const HashType stateKey, const HashType goalKey, const std::vector<UnitCountType> & goalCounts, Entry & entry)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto exact = _byKey.find(HashCombine(stateKey, goalKey));
+    if (exact != _byKey.end() && exact->second->goalCounts == goalCounts)
+    {
+        _entries.splice(_entries.begin(), _entries, exact->second);
+        entry = *exact->second;
+        return true;
+    }
+
+    auto sameState = _byState.find(stateKey);
+    if (_incremental && sameState != _byState.end() && sameState->second->goalCounts.size() == goalCounts.size())
+    {
+        entry = *sameState->second;
+        return true;
+    }
+
+    return false;
+}
+
+// Add an entry as the most recently used, replacing one with the same key.
+void NaiveBuildOrderCache::add(const Entry & entry)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (_capacity == 0)
+    {
+        return;
+    }
+
+    const HashType key = HashCombine(entry.stateKey, entry.goalKey);
+    auto old = _byKey.find(key);
+    if (old != _byKey.end())
+    {
+        _entries.erase(old->second);
+        _byKey.erase(old);
+    }
+
+    _entries.push_front(entry);
+    _byKey[key] = _entries.begin();
+    _byState[entry.stateKey] = _entries.begin();
+
+    if (_entries.size() > _capacity)
+    {
+        auto state = _byState.find(_entries.back().stateKey);
+        if (state != _byState.end() && state->second == std::prev(_entries.end()))
+        {
+            _byState.erase(state);
+        }
+
+        _byKey.erase(HashCombine(_entries.back().stateKey, _entries.back().goalKey));
+        _entries.pop_back();
+    }
+}
+
+// The zobrist hash covers the frame and the units, the rest is what else the naive plan depends on.
+HashType NaiveBuildOrderCache::StateKey(const GameState & state)
+{
+    HashType key = HashCombine(HashStart, state.getHash());
+    key = HashCombine(key, (HashType)state.getRace());
+    key = HashCombine(key, (HashType)state.getMinerals());
+    key = HashCombine(key, (HashType)state.getGas());
+    key = HashCombine(key, (HashType)state.getNumMineralWorkers());
+    key = HashCombine(key, (HashType)state.getNumGasWorkers());
+    return HashCombine(key, (HashType)state.getNumBuildingWorkers());
+}
+
+HashType NaiveBuildOrderCache::GoalKey(const std::vector<UnitCountType> & goalCounts)
+{
+    HashType key = HashStart;
+    for (const UnitCountType count : goalCounts)
+    {
+        key = HashCombine(key, (HashType)count);
+    }
+
+    return key;
+}
+
+// The entry's plan changed for the new goal counts, or false if the goals differ in more than the
+// counts of units made by buildings. The plan isn't checked against the goal here.
+bool NaiveBuildOrderCache::Patch(const GameState & state, const Entry & entry, const std::vector<UnitCountType> & goalCounts, BuildOrder & buildOrder)
+{
+    const RaceID race = state.getRace();
+    std::vector<int> remove(goalCounts.size(), 0);
+    BuildOrder append;
+
+    for (size_t a(0); a < goalCounts.size(); ++a)
+    {
+        if (goalCounts[a] == entry.goalCounts[a])
+        {
+            continue;
+        }
+
+        // workers, buildings, morphs and addons change what else the naive search adds
+        const ActionType & action = ActionTypes::GetActionType(race, a);
+        if (action.isWorker() || action.isBuilding() || action.isMorphed() || action.whatBuildsActionType().isWorker())
+        {
+            return false;
+        }
+
+        // and so do units that are morphed into something in either goal
+        for (size_t m(0); m < goalCounts.size(); ++m)
+        {
+            const ActionType & morph = ActionTypes::GetActionType(race, m);
+            if ((goalCounts[m] > 0 || entry.goalCounts[m] > 0) && morph.isMorphed() && morph.whatBuildsActionType() == action)
+            {
+                return false;
+            }
+        }
+
+        const int have = state.getUnitData().getNumTotal(action);
+        const int change = std::max(0, goalCounts[a] - have) - std::max(0, entry.goalCounts[a] - have);
+        if (change > 0)
+        {
+            append.add(action, change);
+        }
+        else if ((int)entry.buildOrder.getTypeCount(action) < -change)
+        {
+            return false;
+        }
+        else
+        {
+            remove[a] = -change;
+        }
+    }
+
+    // drop the last units of each type whose count went down
+    std::vector<int> keep(goalCounts.size());
+    for (size_t a(0); a < keep.size(); ++a)
+    {
+        keep[a] = (int)entry.buildOrder.getTypeCount(ActionTypes::GetActionType(race, a)) - remove[a];
+    }
+
+    BuildOrder patched;
+    for (size_t i(0); i < entry.buildOrder.size(); ++i)
+    {
+        if (keep[entry.buildOrder[i].ID()]-- > 0)
+        {
+            patched.add(entry.buildOrder[i]);
+        }
+    }
+
+    patched.add(append);
+
+    // insert supply providers where the plan needs more supply, as NaiveBuildOrderSearch does
+    const ActionType & supplyProvider = ActionTypes::GetSupplyProvider(race);
+    GameState currentState(state);
+    buildOrder.clear();
+    for (size_t i(0); i < patched.size(); ++i)
+    {
+        const ActionType & action = patched[i];
+        while (!action.isMorphed() && !action.isSupplyProvider() &&
+               action.supplyRequired() > (currentState.getUnitData().getMaxSupply() + currentState.getUnitData().getSupplyInProgress() - currentState.getUnitData().getCurrentSupply()))
+        {
+            if (!currentState.isLegal(supplyProvider))
+            {
+                return false;
+            }
+
+            buildOrder.add(supplyProvider);
+            currentState.doAction(supplyProvider);
+        }
+
+        if (!currentState.isLegal(action))
+        {
+            return false;
+        }
+
+        buildOrder.add(action);
+        currentState.doAction(action);
+    }
+
+    return true;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Common.h"
+#include "GameState.h"
+#include "BuildOrderSearchGoal.h"
+#include "BuildOrder.h"
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace BOSS
+{
+
+// The naive plans of recent searches, used by Tools::GetUpperBound so that a search of a state and goal
+// seen before doesn't redo the naive search. Plans are looked up by a fingerprint of the state and the
+// goal's counts, and the least recently used plan is dropped when the cache is full.
+// If the state was seen with another goal, and the goals differ only in the counts of units made by a
+// building, the incremental mode patches that goal's plan: units are removed from its end or added
+// at its end, with supply providers as needed, instead of planning from scratch.
+// A plan from the cache is always replayed from the state before it is used, so a fingerprint
+// that matches a different state only costs the replay. Shared by all threads.
+class NaiveBuildOrderCache
+{
+public:
+
+    class Stats
+    {
+    public:
+
+        unsigned long long  hits;
+        unsigned long long  patches;
+        unsigned long long  misses;     // planned by the naive search
+
+        Stats();
+    };
+
+private:
+
+    class Entry
+    {
+    public:
+
+        HashType                    stateKey;
+        HashType                    goalKey;
+        std::vector<UnitCountType>  goalCounts;     // by action ID
+        BuildOrder                  buildOrder;
+    };
+
+    typedef std::list<Entry>::iterator EntryIterator;
+
+    mutable std::mutex                                  _mutex;
+    std::list<Entry>                                    _entries;       // most recently used first
+    std::unordered_map<HashType, EntryIterator>         _byKey;         // state and goal
+    std::unordered_map<HashType, EntryIterator>         _byState;       // the most recent entry of each state
+    size_t                                              _capacity;
+    bool                                                _incremental;
+    Stats                                               _stats;
+
+    NaiveBuildOrderCache();
+
+    bool                        find(const HashType stateKey, const HashType goalKey, const std::vector<UnitCountType> & goalCounts, Entry & entry);
+    void                        add(const Entry & entry);
+
+    static HashType             StateKey(const GameState & state);
+    static HashType             GoalKey(const std::vector<UnitCountType> & goalCounts);
+    static bool                 Patch(const GameState & state, const Entry & entry, const std::vector<UnitCountType> & goalCounts, BuildOrder & buildOrder);
+
+public:
+
+    static NaiveBuildOrderCache & Instance();
+
+    // The naive plan for the goal and the frame it finishes. cached, if given, is set to whether the
+    // plan came from the cache, as it is or patched.
+    BuildOrder                  getBuildOrder(const GameState & state, const BuildOrderSearchGoal & goal, FrameCountType & finishTime, bool * cached = nullptr);
+
+    // 0 turns the cache off
+    void                        setCapacity(size_t capacity);
+    void                        setIncremental(bool incremental);
+    void                        clear();
+    Stats                       getStats() const;
+};
+
+}
@@ -25,8 +25,21 @@ const UnitCountType & ActionCountPair::getCount() const
 }
 
 PrerequisiteSet::PrerequisiteSet()
+    : _race(Races::None)
 {
+    std::fill(_mask, _mask + MaskWords, 0);
+}
 
+void PrerequisiteSet::setBit(const ActionID id, const bool value)
+{
+    if (value)
+    {
+        _mask[id >> 6] |= 1ULL << (id & 63);
+    }
+    else
+    {
+        _mask[id >> 6] &= ~(1ULL << (id & 63));
+    }
 }
 
 const size_t PrerequisiteSet::size() const
@@ -41,15 +54,7 @@ const bool PrerequisiteSet::isEmpty() const
 
 const bool PrerequisiteSet::contains(const ActionType & action) const
 {
-    for (size_t i(0); i<_actionCounts.size(); ++i)
-    {
-        if (getActionType(i) == action)
-        {
-            return true;
-        }
-    }
-
-    return false;
+    return action.getRace() == _race && ((_mask[action.ID() >> 6] >> (action.ID() & 63)) & 1);
 }
 
 const ActionType & PrerequisiteSet::getActionType(const UnitCountType index) const
@@ -64,15 +69,21 @@ const UnitCountType & PrerequisiteSet::getActionTypeCount(const UnitCountType in
     
 void PrerequisiteSet::add(const ActionType & action, const UnitCountType count)
 {
+    BOSS_ASSERT(isEmpty() || action.getRace() == _race, "All actions in a PrerequisiteSet must be of the same race");
+
+    if (contains(action))
+    {
+        return;
+    }
+
+    _race = action.getRace();
+    setBit(action.ID(), true);
     _actionCounts.push_back(ActionCountPair(action, count));
 }
 
 void PrerequisiteSet::addUnique(const ActionType & action, const UnitCountType count)
 {
-    if (!contains(action))
-    {
-        add(action, count);
-    }
+    add(action, count);
 }
 
 void PrerequisiteSet::addUnique(const PrerequisiteSet & set)
@@ -85,6 +96,13 @@ void PrerequisiteSet::addUnique(const PrerequisiteSet & set)
 
 void PrerequisiteSet::remove(const ActionType & action)
 {
+    if (!contains(action))
+    {
+        return;
+    }
+
+    setBit(action.ID(), false);
+
     for (size_t i(0); i<_actionCounts.size(); ++i)
     {
         if (_actionCounts[i].getAction() == action)
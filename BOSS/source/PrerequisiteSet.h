@@ -24,9 +24,18 @@ public:
     const UnitCountType & getCount() const;
 };
 
+// A set of actions of one race, each with a count. Like ActionSet, membership is a bit per
+// action ID, and the actions are also kept in a list that iterates in the order they were added.
+// remove() swaps the last action into the removed one's place, as it always has.
 class PrerequisiteSet
 {
-	Vec<ActionCountPair, Constants::MAX_ACTION_TYPES> _actionCounts;
+    static const size_t MaskWords = (Constants::MAX_ACTION_TYPES + 63) / 64;
+
+    unsigned long long                                  _mask[MaskWords];
+    RaceID                                              _race;
+	Vec<ActionCountPair, Constants::MAX_ACTION_TYPES>   _actionCounts;
+
+    void setBit(const ActionID id, const bool value);
 
 public:
 
@@ -38,6 +47,7 @@ public:
     const ActionType & getActionType(const UnitCountType index) const;
     const UnitCountType & getActionTypeCount(const UnitCountType index) const;
     
+    // adding an action that is already in the set does nothing, add() and addUnique() are the same
     void add(const ActionType & action, const UnitCountType count = 1);
     void addUnique(const ActionType & action, const UnitCountType count = 1);
     void addUnique(const PrerequisiteSet & set);
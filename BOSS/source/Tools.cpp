@@ -1,6 +1,7 @@
 #include "Tools.h"
 #include "BuildOrderSearchGoal.h"
 #include "NaiveBuildOrderSearch.h"
+#include "NaiveBuildOrderCache.h"
 
 using namespace BOSS;
 
@@ -332,15 +333,117 @@ void Tools::InsertActionIntoBuildOrder(BuildOrder & result, const BuildOrder & b
     }
 }
 
-FrameCountType Tools::GetUpperBound(const GameState & state, const BuildOrderSearchGoal & goal)
+// The finish frame of the naive plan, see NaiveBuildOrderCache.
+FrameCountType Tools::GetUpperBound(const GameState & state, const BuildOrderSearchGoal & goal, bool * cached)
 {
-    NaiveBuildOrderSearch naiveSearch(state, goal);
-    const BuildOrder & naiveBuildOrder = naiveSearch.solve();
-    FrameCountType upperBound = naiveBuildOrder.getCompletionTime(state);
+    FrameCountType upperBound = 0;
+    NaiveBuildOrderCache::Instance().getBuildOrder(state, goal, upperBound, cached);
 
     return upperBound;
 }
 
+// The finish frame of a plan that is known to be legal, such as the rest of an earlier search's plan.
+// Returns 0 if the plan is not legal from the state or doesn't reach the goal.
+FrameCountType Tools::GetUpperBound(const GameState & state, const BuildOrderSearchGoal & goal, const BuildOrder & plan)
+{
+    GameState finalState(state);
+    if (!plan.doActions(finalState))
+    {
+        return 0;
+    }
+
+    BuildOrderSearchGoal finalGoal(goal);
+    return finalGoal.isAchievedBy(finalState) ? finalState.getLastActionFinishTime() : 0;
+}
+
+// The part of a plan, searched from planState, that hasn't been started yet in state.
+// For each action type, as many of its earliest actions are dropped as were started since planState.
+BuildOrder Tools::GetRemainingBuildOrder(const BuildOrder & plan, const GameState & planState, const GameState & state)
+{
+    std::vector<int> started(ActionTypes::GetAllActionTypes(state.getRace()).size(), 0);
+    for (size_t a(0); a < started.size(); ++a)
+    {
+        const ActionType & actionType = ActionTypes::GetActionType(state.getRace(), a);
+        started[a] = state.getUnitData().getNumTotal(actionType) - planState.getUnitData().getNumTotal(actionType);
+    }
+
+    BuildOrder remaining;
+    for (size_t i(0); i < plan.size(); ++i)
+    {
+        if (started[plan[i].ID()]-- <= 0)
+        {
+            remaining.add(plan[i]);
+        }
+    }
+
+    return remaining;
+}
+
+// A plan to start a new search with, from the rest of an earlier search's plan.
+// If the rest doesn't reach the goal, the naive search finishes it, and the naive plan from
+// the state is used instead if it finishes sooner. Empty if the rest of the plan isn't legal.
+BuildOrder Tools::GetWarmStartBuildOrder(const BuildOrder & plan, const GameState & planState, const GameState & state, const BuildOrderSearchGoal & goal)
+{
+    BuildOrder warmStart = GetRemainingBuildOrder(plan, planState, state);
+
+    GameState finalState(state);
+    if (!warmStart.doActions(finalState))
+    {
+        return BuildOrder();
+    }
+
+    BuildOrderSearchGoal finalGoal(goal);
+    if (finalGoal.isAchievedBy(finalState))
+    {
+        return warmStart;
+    }
+
+    NaiveBuildOrderSearch finishSearch(finalState, goal);
+    warmStart.add(finishSearch.solve());
+
+    FrameCountType naiveFinish = 0;
+    const BuildOrder naiveBuildOrder = NaiveBuildOrderCache::Instance().getBuildOrder(state, goal, naiveFinish);
+
+    FrameCountType warmStartFinish = GetUpperBound(state, goal, warmStart);
+    if (warmStartFinish == 0 || naiveFinish <= warmStartFinish)
+    {
+        return naiveBuildOrder;
+    }
+
+    return warmStart;
+}
+
+// The resources left once each action of a plan has started and been paid for, then when the last action finishes.
+// The plan must be legal from the state.
+std::vector<Tools::ResourcePoint> Tools::GetResourceCurve(const GameState & state, const BuildOrder & plan)
+{
+    std::vector<ResourcePoint> curve;
+    curve.reserve(plan.size() + 1);
+
+    GameState currentState(state);
+    auto addPoint = [&]()
+    {
+        const ResourcePoint point = { currentState.getCurrentFrame(),
+                                      currentState.getMinerals() / (ResourceCountType)Constants::RESOURCE_SCALE,
+                                      currentState.getGas() / (ResourceCountType)Constants::RESOURCE_SCALE,
+                                      currentState.getUnitData().getCurrentSupply(),
+                                      currentState.getUnitData().getMaxSupply() };
+        curve.push_back(point);
+    };
+
+    for (size_t i(0); i < plan.size(); ++i)
+    {
+        BOSS_ASSERT(currentState.isLegal(plan[i]), "Build order was not legal");
+        currentState.doAction(plan[i]);
+        addPoint();
+    }
+
+    currentState.fastForward(std::max(currentState.getCurrentFrame(), currentState.getLastActionFinishTime()));
+    addPoint();
+
+    return curve;
+}
+
 FrameCountType Tools::GetLowerBound(const GameState & state, const BuildOrderSearchGoal & goal)
 {
     PrerequisiteSet wanted;
@@ -9,7 +9,23 @@ namespace BOSS
 {
 namespace Tools
 {
-    FrameCountType              GetUpperBound(const GameState & state, const BuildOrderSearchGoal & goal);
+    // A point of a plan's resource curve. Minerals and gas are in game units, not the state's scaled ones.
+    class ResourcePoint
+    {
+    public:
+
+        FrameCountType          frame;
+        ResourceCountType       minerals;
+        ResourceCountType       gas;
+        SupplyCountType         supplyUsed;
+        SupplyCountType         supplyMax;
+    };
+
+    FrameCountType              GetUpperBound(const GameState & state, const BuildOrderSearchGoal & goal, bool * cached = nullptr);
+    FrameCountType              GetUpperBound(const GameState & state, const BuildOrderSearchGoal & goal, const BuildOrder & plan);
+    BuildOrder                  GetRemainingBuildOrder(const BuildOrder & plan, const GameState & planState, const GameState & state);
+    BuildOrder                  GetWarmStartBuildOrder(const BuildOrder & plan, const GameState & planState, const GameState & state, const BuildOrderSearchGoal & goal);
+    std::vector<ResourcePoint>  GetResourceCurve(const GameState & state, const BuildOrder & plan);
     FrameCountType              GetLowerBound(const GameState & state, const BuildOrderSearchGoal & goal);
     FrameCountType              CalculatePrerequisitesLowerBound(const GameState & state, const PrerequisiteSet & needed, FrameCountType timeSoFar, int depth = 0);
     void                        InsertActionIntoBuildOrder(BuildOrder & result, const BuildOrder & buildOrder, const GameState & initialState, const ActionType & action);
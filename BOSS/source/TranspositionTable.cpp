@@ -0,0 +1,86 @@
+#include "TranspositionTable.h"
+
+using namespace BOSS;
+
+namespace
+{
+    // splitmix64 finalizer
+    HashType Mix(HashType x)
+    {
+        x ^= x >> 30; x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27; x *= 0x94d049bb133111ebULL;
+        x ^= x >> 31;
+        return x;
+    }
+}
+
+HashType Zobrist::Key(const size_t feature, const size_t a, const size_t b)
+{
+    return Mix(Mix(Mix(feature + 0x9e3779b97f4a7c15ULL) ^ a) ^ b);
+}
+
+TranspositionTable::TranspositionTable()
+    : _mask(0)
+{
+
+}
+
+void TranspositionTable::resize(const size_t buckets)
+{
+    size_t size = 1;
+    while (size * 2 <= buckets)
+    {
+        size *= 2;
+    }
+
+    _entries.assign(size * 2, Entry());
+    _mask = size - 1;
+}
+
+void TranspositionTable::clear()
+{
+    std::fill(_entries.begin(), _entries.end(), Entry());
+}
+
+bool TranspositionTable::isEmpty() const
+{
+    return _entries.empty();
+}
+
+bool TranspositionTable::isDominated(const HashType hash, const GameState & state, const int upperBound) const
+{
+    if (_entries.empty())
+    {
+        return false;
+    }
+
+    const Entry * bucket = &_entries[(hash & _mask) * 2];
+    for (size_t i(0); i < 2; ++i)
+    {
+        const Entry & entry = bucket[i];
+        if (entry.upperBound > 0 && entry.hash == hash && entry.upperBound >= upperBound &&
+            entry.minerals >= state.getMinerals() && entry.gas >= state.getGas())
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void TranspositionTable::store(const HashType hash, const GameState & state, const int upperBound, const size_t depth)
+{
+    if (_entries.empty())
+    {
+        return;
+    }
+
+    Entry * bucket = &_entries[(hash & _mask) * 2];
+    Entry & entry = (bucket[0].upperBound == 0 || bucket[0].hash == hash || depth <= bucket[0].depth) ? bucket[0] : bucket[1];
+
+    entry.hash          = hash;
+    entry.minerals      = state.getMinerals();
+    entry.gas           = state.getGas();
+    entry.upperBound    = upperBound;
+    entry.depth         = depth;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Common.h"
+#include "GameState.h"
+
+namespace BOSS
+{
+
+namespace Zobrist
+{
+    enum Feature { Frame, Completed, InProgress, Building, Larva, Workers, Supply };
+
+    // The key of one feature of a state, for example (Completed, action, count).
+    // A state's hash is the sum of the keys of its features. Keys are computed by a mixing
+    // function rather than looked up in a table, since frames have no useful bound.
+    // Summing instead of xoring keeps two equal features from cancelling out.
+    HashType Key(const size_t feature, const size_t a, const size_t b = 0);
+}
+
+// Fixed size table of states the DFBB search has already expanded.
+// Each bucket has two entries: the first keeps the state closest to the root (replace by depth),
+// the second is replaced every time, so that deep states near the leaves are remembered too.
+class TranspositionTable
+{
+    class Entry
+    {
+    public:
+
+        HashType            hash;
+        ResourceCountType   minerals;
+        ResourceCountType   gas;
+        int                 upperBound;     // upper bound of the search when the state was expanded, 0 if empty
+        size_t              depth;
+
+        Entry()
+            : hash(0)
+            , minerals(0)
+            , gas(0)
+            , upperBound(0)
+            , depth(0)
+        {
+
+        }
+    };
+
+    std::vector<Entry>      _entries;
+    size_t                  _mask;
+
+public:
+
+    TranspositionTable();
+
+    // number of buckets, rounded down to a power of two
+    void resize(const size_t buckets);
+    void clear();
+    bool isEmpty() const;
+
+    // has a state with this hash and at least these resources already been expanded,
+    // while the upper bound was no lower than now?
+    bool isDominated(const HashType hash, const GameState & state, const int upperBound) const;
+    void store(const HashType hash, const GameState & state, const int upperBound, const size_t depth);
+};
+
+}
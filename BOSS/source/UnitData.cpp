@@ -1,4 +1,5 @@
 #include "UnitData.h"
+#include "TranspositionTable.h"
 
 using namespace BOSS;
 
@@ -407,6 +408,25 @@ const FrameCountType UnitData::getFinishTime(const ActionType & action) const
     return _progress.nextActionFinishTime(action);
 }
 
+// When the prerequisites of the action that are only in progress will all be finished, 0 if there are none.
+// The same as getFinishTime(getPrerequistesInProgress(action)) less except, without building the set.
+const FrameCountType UnitData::getPrerequisitesFinishTime(const ActionType & action, const ActionType & except) const
+{
+    const PrerequisiteSet & required = action.getPrerequisites();
+    FrameCountType finishTime = 0;
+
+    for (size_t a(0); a < required.size(); ++a)
+    {
+        const ActionType & actionType = required.getActionType(a);
+        if (actionType != except && getNumInProgress(actionType) > 0 && getNumCompleted(actionType) == 0)
+        {
+            finishTime = std::max(finishTime, _progress.nextActionFinishTime(actionType));
+        }
+    }
+
+    return finishTime;
+}
+
 const PrerequisiteSet UnitData::getPrerequistesInProgress(const ActionType & action) const
 {
     PrerequisiteSet inProgress;
@@ -423,6 +443,45 @@ const PrerequisiteSet UnitData::getPrerequistesInProgress(const ActionType & act
     return inProgress;
 }
 
+// Zobrist hash of the units, actions in progress, buildings and larva.
+// Buildings and hatcheries are hashed as multisets, so their order doesn't matter.
+const HashType UnitData::getHash() const
+{
+    // ActionTypes::None shares its ID with a real action
+    auto key = [](const ActionType & a) { return a.getRace() == Races::None ? 0 : a.ID() + 1; };
+
+    HashType hash = 0;
+
+    for (size_t a(0); a < _numUnits.size(); ++a)
+    {
+        if (_numUnits[a] > 0)
+        {
+            hash += Zobrist::Key(Zobrist::Completed, a, _numUnits[a]);
+        }
+    }
+
+    for (UnitCountType i(0); i < _progress.size(); ++i)
+    {
+        hash += Zobrist::Key(Zobrist::InProgress, _progress.getAction(i).ID(), _progress.getTime(i));
+    }
+
+    for (size_t i(0); i < _buildings.size(); ++i)
+    {
+        const BuildingStatus & building = _buildings.getBuilding(i);
+        hash += Zobrist::Key(Zobrist::Building, key(building._type) | key(building._isConstructing) << 8 | key(building._addon) << 16, building._timeRemaining);
+    }
+
+    for (UnitCountType i(0); i < _hatcheryData.size(); ++i)
+    {
+        hash += Zobrist::Key(Zobrist::Larva, _hatcheryData.getHatchery(i).numLarva());
+    }
+
+    hash += Zobrist::Key(Zobrist::Workers, _mineralWorkers | _gasWorkers << 16, _buildingWorkers);
+    hash += Zobrist::Key(Zobrist::Supply, _currentSupply, _maxSupply);
+
+    return hash;
+}
+
 const BuildingData & UnitData::getBuildingData() const
 {
     return _buildings;
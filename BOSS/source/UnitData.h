@@ -10,6 +10,7 @@
 namespace BOSS
 {
 
+// The counts the search reads at every node come first, the building details last.
 class UnitData
 {
     RaceID                              _race;
@@ -55,6 +56,7 @@ public:
     const FrameCountType    getNextBuildingFinishTime() const;
     const FrameCountType    getFinishTime(const ActionType & action) const;
     const FrameCountType    getFinishTime(const PrerequisiteSet & set) const;
+    const FrameCountType    getPrerequisitesFinishTime(const ActionType & action, const ActionType & except = ActionTypes::None) const;
     const FrameCountType    getFinishTimeByIndex(const UnitCountType & index) const;
     const FrameCountType    getNextActionFinishTime() const;
     const FrameCountType    getLastActionFinishTime() const;
@@ -62,6 +64,8 @@ public:
 
     const FrameCountType    getWhenBuildingCanBuild(const ActionType & action) const;
 
+    const HashType          getHash() const;
+
     const SupplyCountType   getCurrentSupply() const;
     const SupplyCountType   getMaxSupply() const;
     
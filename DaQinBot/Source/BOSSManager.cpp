@@ -4,6 +4,9 @@
 
 using namespace UAlbertaBot;
 
+// the search thread reports its progress after each slice of this many milliseconds
+const int SearchSliceMs = 50;
+
 BOSSManager & BOSSManager::Instance() 
 {
 	static BOSSManager instance;
@@ -15,16 +18,51 @@ BOSSManager::BOSSManager()
     , _previousSearchFinishFrame(0)
     , _searchInProgress(false)
     , _previousStatus("No Searches")
+    , _stopSearch(false)
+    , _report(nullptr)
+    , _hasInitialPlan(false)
+    , _beamSearch(false)
+    , _stopGoalComparison(false)
+    , _goalComparisonDone(false)
+    , _goalComparisonFailed(false)
+    , _fastestComparedGoal(-1)
+{
+}
+
+BOSSManager::~BOSSManager()
 {
+    stopSearch();
+    stopGoalComparison();
 }
 
 void BOSSManager::reset()
 {
+    stopSearch();
+
+    // the plan has been handed over, keep it to warm start the next search
+    if (!_previousBuildOrder.empty())
+    {
+        _lastPlan = _previousBuildOrder;
+        _lastPlanState = _searchState;
+    }
+
     _previousSearchResults = BOSS::DFBB_BuildOrderSearchResults();
     _searchInProgress = false;
     _previousBuildOrder.clear();
 }
 
+// stop the search thread if it is running, and drop whatever it reported
+void BOSSManager::stopSearch()
+{
+    if (_searchThread.joinable())
+    {
+        _stopSearch = true;
+        _searchThread.join();
+    }
+
+    delete _report.exchange(nullptr);
+}
+
 // start a new search for a new goal
 void BOSSManager::startNewSearch(const std::vector<MetaPair> & goalUnits)
 {
@@ -53,14 +91,68 @@ void BOSSManager::startNewSearch(const std::vector<MetaPair> & goalUnits)
 
         BOSS::GameState initialState(BWAPI::Broodwar, BWAPI::Broodwar->self(), BuildingManager::Instance().buildingTypesQueued());
 
+        stopSearch();
+
+        // we may have solved this search, or one close to it, in an earlier game
+        BOSSSearchCache::Instance().read();
+        _hasInitialPlan = BOSSSearchCache::Instance().lookup(initialState, goal, _initialPlan);
+        _initialPlanSource = _hasInitialPlan ? "cache" : "naive";
+        _searchState = initialState;
+        _searchGoal = goal;
+
+        if (_hasInitialPlan && _initialPlan.optimal)
+        {
+            _searchInProgress = false;
+            _previousSearchStartFrame = BWAPI::Broodwar->getFrameCount();
+            _previousSearchFinishFrame = _previousSearchStartFrame;
+            _totalPreviousSearchTime = 0;
+            _previousGoalUnits = goalUnits;
+            _previousBuildOrder = _initialPlan.buildOrder;
+            _previousStatus = std::string("\x07") + "BOSS Cached Solution\n";
+            return;
+        }
+
+        // the search keeps its own copy of the state, so it doesn't need BWAPI
         _smartSearch = SearchPtr(new BOSS::DFBB_BuildOrderSmartSearch(initialState.getRace()));
-        _smartSearch->setGoal(GetGoal(goalUnits));
+        _smartSearch->setGoal(goal);
         _smartSearch->setState(initialState);
+        _smartSearch->setTimeLimit(SearchSliceMs);
+        _smartSearch->setStopFlag(&_stopSearch);
+
+        // different orders of the same actions often reach the same state, don't search it again
+        _smartSearch->setUseTranspositionTable(true);
+
+        // the search is usually stopped before it finishes, so search the children that look closest to the goal first
+        _smartSearch->setChildOrder(BOSS::ChildOrders::ClosestToGoal);
+
+        // DFBB rarely gets far into large goals before the next one comes, beam search finds a good plan sooner
+        _beamSearch = Config::Macro::BOSSBeamGoalSize > 0 && GetGoalSize(initialState, goal) > Config::Macro::BOSSBeamGoalSize;
+        if (_beamSearch)
+        {
+            _smartSearch->setSearchAlgorithm(BOSS::SearchAlgorithms::Beam);
+        }
+
+        // the rest of the last plan may be a better upper bound than the cached plan or the naive search's
+        BOSSSearchCache::Hit warmStart;
+        if (getWarmStartPlan(initialState, goal, warmStart) && (!_hasInitialPlan || warmStart.finishTime < _initialPlan.finishTime))
+        {
+            _initialPlan = warmStart;
+            _hasInitialPlan = true;
+            _initialPlanSource = "warm start";
+        }
+
+        if (_hasInitialPlan)
+        {
+            _smartSearch->setInitialUpperBound(_initialPlan.finishTime);
+        }
 
         _searchInProgress = true;
         _previousSearchStartFrame = BWAPI::Broodwar->getFrameCount();
         _totalPreviousSearchTime = 0;
         _previousGoalUnits = goalUnits;
+
+        _stopSearch = false;
+        _searchThread = std::thread(&BOSSManager::runSearch, this);
     }
     catch (const BOSS::BOSSException &)
     {
@@ -71,6 +163,142 @@ void BOSSManager::startNewSearch(const std::vector<MetaPair> & goalUnits)
     }
 }
 
+// search several candidate goals from the current state, sharing the budget
+void BOSSManager::startGoalComparison(const std::vector<std::vector<MetaPair>> & goals, int budgetMs)
+{
+    stopGoalComparison();
+
+    if (goals.empty())
+    {
+        return;
+    }
+
+    try
+    {
+        std::vector<BOSS::BuildOrderSearchGoal> searchGoals;
+        for (const std::vector<MetaPair> & goalUnits : goals)
+        {
+            searchGoals.push_back(GetGoal(goalUnits));
+        }
+
+        BOSS::GameState initialState(BWAPI::Broodwar, BWAPI::Broodwar->self(), BuildingManager::Instance().buildingTypesQueued());
+
+        // the comparison keeps its own copy of the state, so it doesn't need BWAPI
+        _goalComparison = GoalComparisonPtr(new BOSS::BuildOrderGoalComparison(initialState, searchGoals));
+        _goalComparison->setTimeLimit(budgetMs);
+        _goalComparison->setSliceTime(SearchSliceMs);
+        _goalComparison->setNumThreads(std::max(1, Config::Macro::BOSSGoalComparisonThreads));
+        _goalComparison->setStopFlag(&_stopGoalComparison);
+
+        // large goals get the beam search, as in startNewSearch
+        for (size_t g(0); g < searchGoals.size(); ++g)
+        {
+            if (Config::Macro::BOSSBeamGoalSize > 0 && GetGoalSize(initialState, searchGoals[g]) > Config::Macro::BOSSBeamGoalSize)
+            {
+                _goalComparison->getSearch(g).setSearchAlgorithm(BOSS::SearchAlgorithms::Beam);
+            }
+        }
+
+        _goalComparisonGoals = goals;
+        _stopGoalComparison = false;
+        _goalComparisonDone = false;
+        _goalComparisonFailed = false;
+        _goalComparisonThread = std::thread(&BOSSManager::runGoalComparison, this);
+    }
+    catch (const BOSS::BOSSException &)
+    {
+        _goalComparison.reset();
+
+		if (Config::Debug::DrawBuildOrderSearchInfo)
+		{
+			BWAPI::BroodwarPtr->printf("Exception in BOSS::GameState constructor");
+		}
+    }
+}
+
+// runs on the goal comparison thread
+void BOSSManager::runGoalComparison()
+{
+    try
+    {
+        _goalComparison->search();
+    }
+    catch (const BOSS::BOSSException &)
+    {
+        // the plans the comparison did make are still good
+    }
+    catch (...)
+    {
+        // anything else escaping the thread would end the program; the plans can't be trusted
+        _goalComparisonFailed = true;
+    }
+
+    _goalComparisonDone = true;
+}
+
+// take the plans of the goal comparison if it has finished
+void BOSSManager::pollGoalComparison()
+{
+    if (!_goalComparisonThread.joinable() || !_goalComparisonDone)
+    {
+        return;
+    }
+
+    _goalComparisonThread.join();
+
+    if (_goalComparisonFailed)
+    {
+        _comparedGoals.clear();
+        _comparedPlans.clear();
+        _fastestComparedGoal = -1;
+        _goalComparison.reset();
+
+        Log().Get() << "BOSS goal comparison failed";
+        return;
+    }
+
+    _comparedGoals = _goalComparisonGoals;
+    _comparedPlans = _goalComparison->getPlans();
+    _fastestComparedGoal = _goalComparison->getFastestGoal();
+    _goalComparison.reset();
+
+    Log().Get() << "BOSS goal comparison: " << _comparedPlans.size() << " goals, fastest " << _fastestComparedGoal;
+}
+
+// stop the goal comparison thread if it is running, and drop its plans
+void BOSSManager::stopGoalComparison()
+{
+    if (_goalComparisonThread.joinable())
+    {
+        _stopGoalComparison = true;
+        _goalComparisonThread.join();
+    }
+
+    _goalComparison.reset();
+}
+
+bool BOSSManager::isGoalComparisonInProgress()
+{
+    pollGoalComparison();
+
+    return _goalComparisonThread.joinable();
+}
+
+const std::vector<std::vector<MetaPair>> & BOSSManager::getComparedGoals() const
+{
+    return _comparedGoals;
+}
+
+const std::vector<BOSS::BuildOrderGoalComparison::Plan> & BOSSManager::getComparedPlans() const
+{
+    return _comparedPlans;
+}
+
+int BOSSManager::getFastestComparedGoal() const
+{
+    return _fastestComparedGoal;
+}
+
 void BOSSManager::drawSearchInformation(int x, int y) 
 {
 	if (!Config::Debug::DrawBuildOrderSearchInfo)
@@ -116,122 +344,221 @@ void BOSSManager::drawStateInformation(int x, int y)
     
 }
 
-// tell the search to keep going for however long we have this frame
-void BOSSManager::update(double timeLimit)
+// the searches run on their own threads, here we only check on them
+void BOSSManager::update()
 {
-    // if there's a search in progress, resume it
-    if (isSearchInProgress())
+    pollGoalComparison();
+
+    if (!isSearchInProgress())
     {
-        _previousStatus.clear();
+        return;
+    }
 
-        // give the search at least 5ms to search this frame
-        double realTimeLimit = timeLimit < 0 ? 5 : timeLimit;
-        _smartSearch->setTimeLimit((int)realTimeLimit);
-        bool caughtException = false;
+    // stop a search that has run for too long, it will report the best plan it has
+    if (BWAPI::Broodwar->getFrameCount() > (_previousSearchStartFrame + Config::Macro::BOSSFrameLimit))
+    {
+        _stopSearch = true;
+    }
 
-		try
-        {
-            // call the search to continue searching
-            // this will resume a search in progress or start a new search if not yet started
-			_smartSearch->search();
-		}
-		catch (const BOSS::BOSSException &)
-        {
-			if (Config::Debug::DrawBuildOrderSearchInfo)
-			{
-				BWAPI::Broodwar->drawTextScreen(0, 0, "Search didn't find a solution, resorting to Naive Build Order");
-			}
-            _previousStatus = "BOSSExeption";
-            caughtException = true;
-		}
+    pollSearch();
+}
 
-        _totalPreviousSearchTime += _smartSearch->getResults().timeElapsed;
+// runs on the search thread
+void BOSSManager::runSearch()
+{
+    double searchTime = 0;
+    int reportedUpperBound = 0;
 
-        // after the search finishes for this frame, check to see if we have a solution or if we hit the overall time limit
-        bool searchTimeOut = (BWAPI::Broodwar->getFrameCount() > (_previousSearchStartFrame + Config::Macro::BOSSFrameLimit));
-        bool previousSearchComplete = searchTimeOut || _smartSearch->getResults().solved || caughtException;
-        if (previousSearchComplete)
+    try
+    {
+        while (true)
         {
-            bool solved = _smartSearch->getResults().solved && _smartSearch->getResults().solutionFound;
+            // resumes the search where the last slice stopped, or starts it on the first slice
+            _smartSearch->search();
+
+            const BOSS::DFBB_BuildOrderSearchResults & results = _smartSearch->getResults();
+            searchTime += results.timeElapsed;
+
+            bool finished = results.finished || _stopSearch;
+            bool improved = results.solutionFound && (reportedUpperBound == 0 || results.upperBound < reportedUpperBound);
 
-            // if we've found a solution, let us know
-			if (Config::Debug::DrawBuildOrderSearchInfo && _smartSearch->getResults().solved)
+            if (finished || improved)
             {
-                BWAPI::Broodwar->printf("Build order SOLVED in %d nodes", (int)_smartSearch->getResults().nodesExpanded);
+                publish(new BOSSSearchReport{ results, searchTime, finished, false });
+                reportedUpperBound = results.upperBound;
             }
 
-            if (_smartSearch->getResults().solved)
+            if (finished)
             {
-                if (_smartSearch->getResults().solutionFound)
-                {
-                    _previousStatus = std::string("\x07") + "BOSS Solve Solution\n";
-                }
-                else
-                {
-                    _previousStatus = std::string("\x03") + "BOSS Solve NoSolution\n";
-                }
+                return;
             }
+        }
+    }
+    catch (const BOSS::BOSSException &)
+    {
+        publish(new BOSSSearchReport{ _smartSearch->getResults(), searchTime, true, true });
+    }
+    catch (...)
+    {
+        // anything else escaping the thread would end the program; fail the search the same way
+        publish(new BOSSSearchReport{ _smartSearch->getResults(), searchTime, true, true });
+    }
+}
 
-            // re-set all the search information to get read for the next search
-            _searchInProgress = false;
-            _previousSearchFinishFrame = BWAPI::Broodwar->getFrameCount();
-            _previousSearchResults = _smartSearch->getResults();
-            _savedSearchResults = _previousSearchResults;
-            _previousBuildOrder = _previousSearchResults.buildOrder;
+// hand a report to the game thread, replacing an older one it hasn't taken yet
+void BOSSManager::publish(BOSSSearchReport * report)
+{
+    delete _report.exchange(report);
+}
+
+// take the latest report from the search thread, if there is one
+void BOSSManager::pollSearch()
+{
+    std::unique_ptr<BOSSSearchReport> report(_report.exchange(nullptr));
+    if (!report)
+    {
+        return;
+    }
+
+    _savedSearchResults = report->results;
+    _totalPreviousSearchTime = report->searchTime;
+
+    if (report->finished)
+    {
+        _searchThread.join();
+        finishSearch(*report);
+    }
+}
+
+void BOSSManager::finishSearch(const BOSSSearchReport & report)
+{
+    const BOSS::DFBB_BuildOrderSearchResults & results = report.results;
+    bool caughtException = report.caughtException;
+    bool searchTimeOut = !results.finished && !caughtException;
+
+    _previousStatus.clear();
+
+    if (caughtException && Config::Debug::DrawBuildOrderSearchInfo)
+    {
+        BWAPI::Broodwar->printf("Search didn't find a solution, resorting to Naive Build Order");
+    }
+
+    bool solved = results.solved && results.solutionFound;
+
+    // if we've found a solution, let us know
+	if (Config::Debug::DrawBuildOrderSearchInfo && results.solved)
+    {
+        BWAPI::Broodwar->printf("Build order SOLVED in %d nodes", (int)results.nodesExpanded);
+    }
 
-            if (solved && _previousBuildOrder.size() == 0)
+    if (results.solved)
+    {
+        if (results.solutionFound)
+        {
+            _previousStatus = std::string("\x07") + "BOSS Solve Solution\n";
+        }
+        else
+        {
+            _previousStatus = std::string("\x03") + "BOSS Solve NoSolution\n";
+        }
+    }
+
+    // re-set all the search information to get read for the next search
+    _searchInProgress = false;
+    _previousSearchFinishFrame = BWAPI::Broodwar->getFrameCount();
+    _previousSearchResults = results;
+    _savedSearchResults = _previousSearchResults;
+    _previousBuildOrder = _previousSearchResults.buildOrder;
+
+    Log().Get() << "BOSS search: " << results.nodesExpanded << " nodes, " << report.searchTime << "ms, "
+        << (results.solved ? "solved" : "not solved") << (_beamSearch ? " by beam search" : "") << ", initial plan from " << _initialPlanSource;
+
+    // a search that started from a cached or warm start plan only reports plans at least as good,
+    // so if it has none that plan is the best we know, and optimal if the search finished
+    if (!results.solutionFound && _hasInitialPlan)
+    {
+        _previousBuildOrder = _initialPlan.buildOrder;
+        _previousStatus = std::string("\x07") + "BOSS Initial Plan\n";
+    }
+
+    if (!caughtException)
+    {
+        BOSSSearchCache::Instance().store(_searchState, _searchGoal, _previousBuildOrder, results.solved);
+    }
+
+    if (solved && _previousBuildOrder.size() == 0)
+    {
+        _previousStatus = std::string("\x07") + "BOSS Trivial Solve\n";
+    }
+
+    // if our search resulted in a build order of size 0 then something failed
+    if (!solved && _previousBuildOrder.size() == 0)
+    {
+        // log the debug information since this shouldn't happen if everything goes to plan
+        /*std::stringstream ss;
+        ss << _smartSearch->getParameters().toString() << "\n";
+        ss << "searchTimeOut: " << (searchTimeOut ? "true" : "false") << "\n";
+        ss << "caughtException: " << (caughtException ? "true" : "false") << "\n";
+        ss << "getResults().solved: " << (results.solved ? "true" : "false") << "\n";
+        ss << "getResults().solutionFound: " << (results.solutionFound ? "true" : "false") << "\n";
+        ss << "nodes: " << _savedSearchResults.nodesExpanded << "\n";
+        ss << "time: " << _savedSearchResults.timeElapsed << "\n";
+        Logger::LogOverwriteToFile("bwapi-data/AI/LastBadBuildOrder.txt", ss.str());*/
+        
+        // so try another naive build order search as a last resort
+        BOSS::NaiveBuildOrderSearch nbos(_smartSearch->getParameters().initialState, _smartSearch->getParameters().goal);
+
+		try
+        {
+            if (searchTimeOut)
             {
-                _previousStatus = std::string("\x07") + "BOSS Trivial Solve\n";
+                _previousStatus = std::string("\x02") + "BOSS Timeout\n";
             }
 
-            // if our search resulted in a build order of size 0 then something failed
-            if (!solved && _previousBuildOrder.size() == 0)
+            if (caughtException)
             {
-                // log the debug information since this shouldn't happen if everything goes to plan
-                /*std::stringstream ss;
-                ss << _smartSearch->getParameters().toString() << "\n";
-                ss << "searchTimeOut: " << (searchTimeOut ? "true" : "false") << "\n";
-                ss << "caughtException: " << (caughtException ? "true" : "false") << "\n";
-                ss << "getResults().solved: " << (_smartSearch->getResults().solved ? "true" : "false") << "\n";
-                ss << "getResults().solutionFound: " << (_smartSearch->getResults().solutionFound ? "true" : "false") << "\n";
-                ss << "nodes: " << _savedSearchResults.nodesExpanded << "\n";
-                ss << "time: " << _savedSearchResults.timeElapsed << "\n";
-                Logger::LogOverwriteToFile("bwapi-data/AI/LastBadBuildOrder.txt", ss.str());*/
-                
-                // so try another naive build order search as a last resort
-                BOSS::NaiveBuildOrderSearch nbos(_smartSearch->getParameters().initialState, _smartSearch->getParameters().goal);
-
-				try
-                {
-                    if (searchTimeOut)
-                    {
-                        _previousStatus = std::string("\x02") + "BOSS Timeout\n";
-                    }
-
-                    if (caughtException)
-                    {
-                        _previousStatus = std::string("\x02") + "BOSS Exception\n";
-                    }
-
-					_previousBuildOrder = nbos.solve();
-                    _previousStatus += "\x03NBOS Solution";
-
-					return;
-				}
-                // and if that search doesn't work then we're out of luck, no build orders for us
-				catch (const BOSS::BOSSException & exception)
-                {
-                    _previousStatus += "\x08Naive Exception";
-                    if (Config::Debug::DrawBuildOrderSearchInfo)
-                    {
-						UAB_ASSERT_WARNING(false, "BOSS Timeout Naive Search Exception: %s", exception.what());
-						BWAPI::Broodwar->drawTextScreen(0, 20, "No BuildOrder found, returning empty BuildOrder");
-                    }
-					_previousBuildOrder = BOSS::BuildOrder();
-					return;
-				}
+                _previousStatus = std::string("\x02") + "BOSS Exception\n";
             }
-        }
+
+			_previousBuildOrder = nbos.solve();
+            _previousStatus += "\x03NBOS Solution";
+
+			return;
+		}
+        // and if that search doesn't work then we're out of luck, no build orders for us
+		catch (const BOSS::BOSSException & exception)
+        {
+            _previousStatus += "\x08Naive Exception";
+            if (Config::Debug::DrawBuildOrderSearchInfo)
+            {
+				UAB_ASSERT_WARNING(false, "BOSS Timeout Naive Search Exception: %s", exception.what());
+				BWAPI::Broodwar->drawTextScreen(0, 20, "No BuildOrder found, returning empty BuildOrder");
+            }
+			_previousBuildOrder = BOSS::BuildOrder();
+			return;
+		}
+    }
+}
+
+// The rest of the last plan, finished by the naive search if it doesn't reach the goal.
+// The search can then prune with it from the first node, instead of with the naive plan.
+bool BOSSManager::getWarmStartPlan(const BOSS::GameState & state, const BOSS::BuildOrderSearchGoal & goal, BOSSSearchCache::Hit & plan)
+{
+    if (_lastPlan.empty() || _lastPlanState.getRace() != state.getRace())
+    {
+        return false;
+    }
+
+    try
+    {
+        plan.buildOrder = BOSS::Tools::GetWarmStartBuildOrder(_lastPlan, _lastPlanState, state, goal);
+        plan.finishTime = BOSS::Tools::GetUpperBound(state, goal, plan.buildOrder);
+        plan.optimal = false;
+        return !plan.buildOrder.empty() && plan.finishTime > 0;
+    }
+    catch (const BOSS::BOSSException &)
+    {
+        return false;
     }
 }
 
@@ -254,6 +581,21 @@ BOSS::BuildOrderSearchGoal BOSSManager::GetGoal(const std::vector<MetaPair> & go
 	return goal;
 }
 
+// the number of units and upgrades still to be started to reach the goal
+int BOSSManager::GetGoalSize(const BOSS::GameState & state, const BOSS::BuildOrderSearchGoal & goal)
+{
+	const BOSS::RaceID race = state.getRace();
+	int size = 0;
+
+	for (size_t a(0); a < BOSS::ActionTypes::GetAllActionTypes(race).size(); ++a)
+	{
+		const BOSS::ActionType & action = BOSS::ActionTypes::GetActionType(race, BOSS::ActionID(a));
+		size += std::max(0, (int)goal.getGoal(action) - (int)state.getUnitData().getNumTotal(action));
+	}
+
+	return size;
+}
+
 // gets the StarcraftState corresponding to the beginning of a Melee game
 BOSS::GameState BOSSManager::getStartState()
 {
@@ -306,6 +648,9 @@ std::vector<MacroAct> BOSSManager::GetMetaVector(const BOSS::BuildOrder & buildO
 
 BuildOrder BOSSManager::getBuildOrder()
 {
+    // the search may have finished since the last update
+    pollSearch();
+
     return BuildOrder(BWAPI::Broodwar->self()->getRace(), GetMetaVector(_previousBuildOrder));
 }
 
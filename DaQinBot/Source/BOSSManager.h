@@ -4,13 +4,31 @@
 #include "WorkerManager.h"
 #include "../../BOSS/source/BOSS.h"
 #include "StrategyManager.h"
+#include "BOSSSearchCache.h"
 #include <memory>
+#include <thread>
+#include <atomic>
 
 namespace UAlbertaBot
 {
     
 typedef std::shared_ptr<BOSS::DFBB_BuildOrderSmartSearch> SearchPtr;
+typedef std::shared_ptr<BOSS::BuildOrderGoalComparison> GoalComparisonPtr;
 
+// What the search thread hands over to the game thread.
+struct BOSSSearchReport
+{
+    BOSS::DFBB_BuildOrderSearchResults      results;
+    double                                  searchTime;         // total over all slices so far
+    bool                                    finished;           // the search thread is done
+    bool                                    caughtException;
+};
+
+// Build order searches run on their own thread, so the game thread doesn't spend its frame time on them.
+// The search thread owns _smartSearch from startNewSearch() until it finishes. It runs the search in
+// short slices and after each slice that improved the plan it swaps a new report into _report.
+// The game thread takes reports out of _report in update() and getBuildOrder(). Neither side waits
+// for the other, except for joining the thread once it has reported that it is finished.
 class BOSSManager
 {
     int                                     _previousSearchStartFrame;
@@ -23,42 +41,93 @@ class BOSSManager
 
     SearchPtr                               _smartSearch;
 
+    std::thread                             _searchThread;
+    std::atomic<bool>                       _stopSearch;
+    std::atomic<BOSSSearchReport *>         _report;            // latest report the game thread hasn't taken
+
     BOSS::DFBB_BuildOrderSearchResults      _previousSearchResults;
     BOSS::DFBB_BuildOrderSearchResults      _savedSearchResults;
     BOSS::BuildOrder                        _previousBuildOrder;
 
+    BOSS::GameState                         _searchState;       // what the current search started from, for the cache
+    BOSS::BuildOrderSearchGoal              _searchGoal;
+    BOSSSearchCache::Hit                    _initialPlan;       // the search's initial upper bound, if _hasInitialPlan
+    bool                                    _hasInitialPlan;
+    std::string                             _initialPlanSource;
+    bool                                    _beamSearch;        // the current search is a beam search, see Config::Macro::BOSSBeamGoalSize
+
+    BOSS::BuildOrder                        _lastPlan;          // the last plan handed over, kept for a warm start
+    BOSS::GameState                         _lastPlanState;     // what it was searched from
+
+    // A goal comparison runs on its own thread too, separate from the build order search.
+    // The game thread only looks at _goalComparison after the thread has set _goalComparisonDone and been joined.
+    GoalComparisonPtr                       _goalComparison;
+    std::thread                             _goalComparisonThread;
+    std::atomic<bool>                       _stopGoalComparison;
+    std::atomic<bool>                       _goalComparisonDone;
+    std::atomic<bool>                       _goalComparisonFailed;  // it threw something other than a BOSSException
+    std::vector<std::vector<MetaPair>>      _goalComparisonGoals;   // of the running comparison
+    std::vector<std::vector<MetaPair>>      _comparedGoals;         // of the last finished one
+    std::vector<BOSS::BuildOrderGoalComparison::Plan>   _comparedPlans;
+    int                                     _fastestComparedGoal;
+
 	BOSS::GameState				            getCurrentState();
 	BOSS::GameState				            getStartState();
 	
     // functions
 	BOSS::DFBB_BuildOrderSearchResults		search(const std::vector<MetaPair> & goalUnits);
 
-	void						            loadOpeningBook();
-
-	std::vector<std::vector<MacroAct>>      openingBook;
     const BOSS::RaceID                      getRace() const;
 
     void                                    logBadSearch();
+    bool                                    getWarmStartPlan(const BOSS::GameState & state, const BOSS::BuildOrderSearchGoal & goal, BOSSSearchCache::Hit & plan);
+
+    void                                    runSearch();
+    void                                    publish(BOSSSearchReport * report);
+    void                                    pollSearch();
+    void                                    finishSearch(const BOSSSearchReport & report);
+    void                                    stopSearch();
+
+    void                                    runGoalComparison();
+    void                                    pollGoalComparison();
 
 	BOSSManager();
+    ~BOSSManager();
 
 public:
 
 	static BOSSManager &	    Instance();
 
-	void						update(double timeLimit);
+	void						update();
     void                        reset();
 
     BuildOrder                  getBuildOrder();
     bool                        isSearchInProgress();
 
     void                        startNewSearch(const std::vector<MetaPair> & goalUnits);
+
+    // Plan several candidate goals at once, for the strategy to choose the one that is met soonest.
+    // They share budgetMs of search time, then the plans are available from getComparedPlans().
+    // Any comparison still running is stopped. Doesn't affect the build order search.
+    void                        startGoalComparison(const std::vector<std::vector<MetaPair>> & goals, int budgetMs);
+    bool                        isGoalComparisonInProgress();
+
+    // stop the comparison thread, if it is running, and drop its results
+    void                        stopGoalComparison();
+
+    // the goals and plans of the last finished comparison, in the same order
+    const std::vector<std::vector<MetaPair>> &                  getComparedGoals() const;
+    const std::vector<BOSS::BuildOrderGoalComparison::Plan> &   getComparedPlans() const;
+
+    // index of the goal whose plan meets it soonest, -1 if none has a plan
+    int                         getFastestComparedGoal() const;
     
 	void						drawSearchInformation(int x, int y);
     void						drawStateInformation(int x, int y);
 
     
 	static BOSS::BuildOrderSearchGoal       GetGoal(const std::vector<MetaPair> & goalUnits);	
+    static int                              GetGoalSize(const BOSS::GameState & state, const BOSS::BuildOrderSearchGoal & goal);
     static std::vector<MacroAct>			GetMetaVector(const BOSS::BuildOrder & buildOrder);
 	static BOSS::ActionType					GetActionType(const MacroAct & t);
 	static MacroAct					        GetMacroAct(const BOSS::ActionType & a);
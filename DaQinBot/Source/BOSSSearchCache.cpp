@@ -0,0 +1,313 @@
+#include "BOSSSearchCache.h"
+#include "Logger.h"
+#include <fstream>
+
+using namespace UAlbertaBot;
+
+namespace
+{
+	// Times and resources are rounded to this, so that nearly equal states share a key.
+	const int FrameBucket = 24;
+	const int ResourceBucket = 25 * BOSS::Constants::RESOURCE_SCALE;
+
+	// splitmix64, to spread each feature over the whole key
+	uint64_t Mix(uint64_t x)
+	{
+		x += 0x9E3779B97F4A7C15ULL;
+		x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+		return x ^ (x >> 31);
+	}
+
+	// Features are summed, so features of a set, like the actions in progress, can come in any order.
+	uint64_t Feature(uint64_t kind, uint64_t a, uint64_t b = 0, uint64_t c = 0)
+	{
+		return Mix(kind << 56 ^ a << 40 ^ b << 20 ^ c);
+	}
+
+	int Rounded(int value, int bucket)
+	{
+		return (value + bucket / 2) / bucket;
+	}
+}
+
+BOSSSearchCache & BOSSSearchCache::Instance()
+{
+	static BOSSSearchCache instance;
+	return instance;
+}
+
+BOSSSearchCache::BOSSSearchCache()
+	: _filename("DaQin_BOSS_cache.txt")
+	, _loaded(false)
+	, _dirty(false)
+{
+}
+
+// The race, the goal, and what we have or are making. Times and resources are left out.
+uint64_t BOSSSearchCache::NearKey(const BOSS::GameState & state, const BOSS::BuildOrderSearchGoal & goal)
+{
+	const BOSS::RaceID race = state.getRace();
+	const BOSS::UnitData & units = state.getUnitData();
+
+	uint64_t key = Feature(0, FormatVersion, race);
+
+	for (size_t a(0); a < BOSS::ActionTypes::GetAllActionTypes(race).size(); ++a)
+	{
+		const BOSS::ActionType & action = BOSS::ActionTypes::GetActionType(race, BOSS::ActionID(a));
+
+		if (goal.getGoal(action) > 0 || units.getNumTotal(action) > 0)
+		{
+			key += Feature(1, a, goal.getGoal(action), units.getNumCompleted(action) << 8 | units.getNumInProgress(action));
+		}
+	}
+
+	return key;
+}
+
+// The near key plus the rounded resources, worker jobs, and times until things finish.
+uint64_t BOSSSearchCache::Key(const BOSS::GameState & state, const BOSS::BuildOrderSearchGoal & goal)
+{
+	const BOSS::UnitData & units = state.getUnitData();
+	const int frame = state.getCurrentFrame();
+
+	uint64_t key = NearKey(state, goal);
+
+	key += Feature(2, Rounded(state.getMinerals(), ResourceBucket), Rounded(state.getGas(), ResourceBucket));
+	key += Feature(3, units.getNumMineralWorkers(), units.getNumGasWorkers(), units.getNumBuildingWorkers());
+
+	for (BOSS::UnitCountType i(0); i < units.getNumActionsInProgress(); ++i)
+	{
+		const int remaining = units.getActionInProgressFinishTimeByIndex(i) - frame;
+		key += Feature(4, units.getActionInProgressByIndex(i).ID(), Rounded(remaining, FrameBucket));
+	}
+
+	const BOSS::BuildingData & buildings = state.getBuildingData();
+	for (size_t i(0); i < buildings.size(); ++i)
+	{
+		const BOSS::BuildingStatus & building = buildings.getBuilding(BOSS::UnitCountType(i));
+		if (building._timeRemaining > 0)
+		{
+			key += Feature(5, building._type.ID(), building._isConstructing.ID(), Rounded(building._timeRemaining, FrameBucket));
+		}
+	}
+
+	const BOSS::HatcheryData & hatcheries = state.getHatcheryData();
+	for (BOSS::UnitCountType i(0); i < hatcheries.size(); ++i)
+	{
+		key += Feature(6, hatcheries.getHatchery(i).numLarva());
+	}
+
+	return key;
+}
+
+// Play the entry's plan from the state. It is a hit if every action is legal and the goal is reached.
+bool BOSSSearchCache::replay(const Entry & entry, const BOSS::GameState & state, BOSS::BuildOrderSearchGoal goal, Hit & hit) const
+{
+	const size_t numActions = BOSS::ActionTypes::GetAllActionTypes(state.getRace()).size();
+
+	BOSS::BuildOrder buildOrder;
+	for (int id : entry.actions)
+	{
+		if (id < 0 || size_t(id) >= numActions)
+		{
+			return false;
+		}
+		buildOrder.add(BOSS::ActionTypes::GetActionType(state.getRace(), BOSS::ActionID(id)));
+	}
+
+	try
+	{
+		BOSS::GameState end(state);
+		if (!buildOrder.doActions(end) || !goal.isAchievedBy(end))
+		{
+			return false;
+		}
+
+		hit.buildOrder = buildOrder;
+		hit.finishTime = end.getLastActionFinishTime();
+		hit.optimal = false;
+		return true;
+	}
+	catch (const BOSS::BOSSException &)
+	{
+		return false;
+	}
+}
+
+bool BOSSSearchCache::lookup(const BOSS::GameState & state, const BOSS::BuildOrderSearchGoal & goal, Hit & hit) const
+{
+	if (!Config::IO::UseSearchCache)
+	{
+		return false;
+	}
+
+	// An optimal plan for the same key is used as it is. It is still replayed, since it
+	// came from a state that was only about the same.
+	auto exact = _byKey.find(Key(state, goal));
+	if (exact != _byKey.end() && _entries[exact->second].optimal && replay(_entries[exact->second], state, goal, hit))
+	{
+		hit.optimal = true;
+		return true;
+	}
+
+	// Otherwise the best of the near matches, if any still works from this state.
+	bool found = false;
+	int tried = 0;
+	auto range = _byNearKey.equal_range(NearKey(state, goal));
+	for (auto it = range.first; it != range.second && tried < MaxNearMatches; ++it, ++tried)
+	{
+		Hit candidate;
+		if (replay(_entries[it->second], state, goal, candidate) && (!found || candidate.finishTime < hit.finishTime))
+		{
+			hit = candidate;
+			found = true;
+		}
+	}
+
+	return found;
+}
+
+void BOSSSearchCache::store(const BOSS::GameState & state, const BOSS::BuildOrderSearchGoal & goal, const BOSS::BuildOrder & buildOrder, bool optimal)
+{
+	if (!Config::IO::UseSearchCache || buildOrder.empty())
+	{
+		return;
+	}
+
+	Entry entry;
+	entry.key = Key(state, goal);
+	entry.nearKey = NearKey(state, goal);
+	entry.optimal = optimal;
+	entry.makespan = buildOrder.getCompletionTime(state) - state.getCurrentFrame();
+	for (size_t i(0); i < buildOrder.size(); ++i)
+	{
+		entry.actions.push_back(buildOrder[i].ID());
+	}
+
+	auto old = _byKey.find(entry.key);
+	if (old != _byKey.end())
+	{
+		const Entry & oldEntry = _entries[old->second];
+		if (!optimal && (oldEntry.optimal || oldEntry.makespan <= entry.makespan))
+		{
+			return;
+		}
+	}
+
+	add(entry);
+	_dirty = true;
+}
+
+// Add an entry, replacing the one with the same key, as the newest.
+void BOSSSearchCache::add(const Entry & entry)
+{
+	auto old = _byKey.find(entry.key);
+	if (old != _byKey.end())
+	{
+		_entries.erase(_entries.begin() + old->second);
+		_entries.push_back(entry);
+		rebuildIndex();
+		return;
+	}
+
+	_entries.push_back(entry);
+	_byKey[entry.key] = _entries.size() - 1;
+	_byNearKey.emplace(entry.nearKey, _entries.size() - 1);
+}
+
+void BOSSSearchCache::rebuildIndex()
+{
+	_byKey.clear();
+	_byNearKey.clear();
+	for (size_t i = 0; i < _entries.size(); ++i)
+	{
+		_byKey[_entries[i].key] = i;
+		_byNearKey.emplace(_entries[i].nearKey, i);
+	}
+}
+
+// One entry per line: key near-key optimal makespan count action-ids...
+void BOSSSearchCache::readFile(const std::string & filename)
+{
+	std::ifstream inFile(filename);
+
+	// There may not be a file to read. That's OK.
+	if (!inFile.good())
+	{
+		return;
+	}
+
+	int version = 0;
+	if (!(inFile >> version) || version != FormatVersion)
+	{
+		return;
+	}
+
+	Entry entry;
+	int count = 0;
+	while (inFile >> entry.key >> entry.nearKey >> entry.optimal >> entry.makespan >> count)
+	{
+		entry.actions.resize(std::max(0, count));
+		for (int & id : entry.actions)
+		{
+			inFile >> id;
+		}
+		if (!inFile)
+		{
+			break;
+		}
+		add(entry);
+	}
+}
+
+void BOSSSearchCache::read()
+{
+	if (!Config::IO::UseSearchCache || _loaded)
+	{
+		return;
+	}
+	_loaded = true;
+
+	// Same places as the opponent model: the read directory, or else the AI directory.
+	readFile(Config::IO::ReadDir + _filename);
+	if (_entries.empty())
+	{
+		readFile(Config::IO::AIDir + _filename);
+	}
+
+	Log().Get() << "BOSS search cache: " << _entries.size() << " entries";
+}
+
+void BOSSSearchCache::write()
+{
+	if (!Config::IO::UseSearchCache || !_dirty)
+	{
+		return;
+	}
+
+	std::ofstream outFile(Config::IO::WriteDir + _filename, std::ios::trunc);
+
+	// If it fails, there's not much we can do about it.
+	if (outFile.bad())
+	{
+		return;
+	}
+
+	// Keep the newest entries.
+	const size_t first = _entries.size() > size_t(MaxEntries) ? _entries.size() - MaxEntries : 0;
+
+	outFile << FormatVersion << '\n';
+	for (size_t i = first; i < _entries.size(); ++i)
+	{
+		const Entry & entry = _entries[i];
+		outFile << entry.key << ' ' << entry.nearKey << ' ' << entry.optimal << ' ' << entry.makespan << ' ' << entry.actions.size();
+		for (int id : entry.actions)
+		{
+			outFile << ' ' << id;
+		}
+		outFile << '\n';
+	}
+
+	_dirty = false;
+}
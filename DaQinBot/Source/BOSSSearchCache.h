@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Common.h"
+#include "../../BOSS/source/BOSS.h"
+#include <unordered_map>
+
+namespace UAlbertaBot
+{
+// Build order search results kept from game to game, in the write directory.
+// Games repeat the same searches: the same race, about the same units, the same goals.
+// An entry is keyed by a hash of the search's start state and goal. The state is canonical:
+// times are relative to the current frame and rounded, and resources are rounded, so that
+// states a few frames or minerals apart in different games get the same key.
+// Each entry also has a near key, which leaves out the times and resources. A plan from a
+// near match can't be trusted as it is, so it is replayed from the new start state.
+class BOSSSearchCache
+{
+public:
+
+	// A cached plan that is legal from the start state and reaches the goal.
+	struct Hit
+	{
+		BOSS::BuildOrder	buildOrder;
+		int					finishTime;		// frame the plan completes, from this start state
+		bool				optimal;		// same key and proven optimal, no need to search
+	};
+
+private:
+
+	struct Entry
+	{
+		uint64_t			key;
+		uint64_t			nearKey;
+		bool				optimal;
+		int					makespan;		// frames from the start state, for the log
+		std::vector<int>	actions;		// BOSS action IDs
+	};
+
+	static const int	FormatVersion = 1;			// change it when the search changes, to drop old results
+	static const int	MaxEntries = 2000;
+	static const int	MaxNearMatches = 8;			// replayed per lookup
+
+	std::vector<Entry>							_entries;		// oldest first
+	std::unordered_map<uint64_t, size_t>		_byKey;
+	std::unordered_multimap<uint64_t, size_t>	_byNearKey;
+
+	std::string		_filename;
+	bool			_loaded;
+	bool			_dirty;
+
+	BOSSSearchCache();
+
+	void		readFile(const std::string & filename);
+	void		add(const Entry & entry);
+	void		rebuildIndex();
+
+	static uint64_t	NearKey(const BOSS::GameState & state, const BOSS::BuildOrderSearchGoal & goal);
+	static uint64_t	Key(const BOSS::GameState & state, const BOSS::BuildOrderSearchGoal & goal);
+
+	bool		replay(const Entry & entry, const BOSS::GameState & state, BOSS::BuildOrderSearchGoal goal, Hit & hit) const;
+
+public:
+
+	static BOSSSearchCache & Instance();
+
+	void		read();
+	void		write();
+
+	// The best cached plan for this search, if any.
+	bool		lookup(const BOSS::GameState & state, const BOSS::BuildOrderSearchGoal & goal, Hit & hit) const;
+
+	// Remember the plan a search found. An optimal plan replaces any other for the same key,
+	// otherwise a plan only replaces one that finishes later.
+	void		store(const BOSS::GameState & state, const BOSS::BuildOrderSearchGoal & goal, const BOSS::BuildOrder & buildOrder, bool optimal);
+};
+}
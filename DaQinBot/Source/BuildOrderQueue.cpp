@@ -3,9 +3,30 @@
 
 using namespace UAlbertaBot;
 
+// Check the counters against a scan of the queue after every change.
+//#define BUILDORDERQUEUE_DEBUG 1
+
+namespace
+{
+	void AddCount(std::vector<int> & counts, int id, int n)
+	{
+		if (id >= int(counts.size()))
+		{
+			counts.resize(id + 1, 0);
+		}
+		counts[id] += n;
+	}
+
+	int GetCount(const std::vector<int> & counts, int id)
+	{
+		return id < int(counts.size()) ? counts[id] : 0;
+	}
+}
+
 BuildOrderItem::BuildOrderItem(MacroAct m, bool workerScoutBuilding)
 	: macroAct(m)
 	, isWorkerScoutBuilding(workerScoutBuilding)
+	, thenBuild(nullptr)
 {
 	// Recursively handle if the macro act has a "then" clause
 	if (m.hasThen())
@@ -13,38 +34,214 @@ BuildOrderItem::BuildOrderItem(MacroAct m, bool workerScoutBuilding)
 }
 
 BuildOrderQueue::BuildOrderQueue()
-	: modified(false)
+	: first(0)
+	, count(0)
+	, modified(false)
+	, workerScoutBuildings(0)
+	, fixedMinerals(0)
+	, fixedGas(0)
 {
 }
 
-void BuildOrderQueue::clearAll() 
+// Double the size of the ring, or make the first one. The items move to the start of the new ring.
+void BuildOrderQueue::grow()
 {
-    if (!queue.empty()) Log().Debug() << "Cleared build queue";
-    queue.clear();
+	std::vector<BuildOrderItem> bigger(std::max(size_t(16), 2 * ring.size()), BuildOrderItem(MacroAct()));
+	for (size_t i = 0; i < count; ++i)
+	{
+		bigger[i] = at(i);
+	}
+	ring.swap(bigger);
+	first = 0;
+}
+
+void BuildOrderQueue::pushBack(const BuildOrderItem & item)
+{
+	if (count == ring.size())
+	{
+		grow();
+	}
+	at(count) = item;
+	++count;
+	countItem(item, 1);
+
+#ifdef BUILDORDERQUEUE_DEBUG
+	checkCounters();
+#endif
+}
+
+void BuildOrderQueue::pushFront(const BuildOrderItem & item)
+{
+	if (count == ring.size())
+	{
+		grow();
+	}
+	first = (first - 1) & (ring.size() - 1);
+	at(0) = item;
+	++count;
+	countItem(item, 1);
+
+#ifdef BUILDORDERQUEUE_DEBUG
+	checkCounters();
+#endif
+}
+
+void BuildOrderQueue::popBack()
+{
+	UAB_ASSERT(count > 0, "taking from empty queue");
+
+	countItem(at(count - 1), -1);
+	--count;
+
+#ifdef BUILDORDERQUEUE_DEBUG
+	checkCounters();
+#endif
+}
+
+// Remove item i, moving whichever side of it is shorter.
+void BuildOrderQueue::erase(size_t i)
+{
+	UAB_ASSERT(i < count, "bad index");
+
+	countItem(at(i), -1);
+	if (i < count / 2)
+	{
+		for (size_t j = i; j > 0; --j)
+		{
+			at(j) = at(j - 1);
+		}
+		first = (first + 1) & (ring.size() - 1);
+	}
+	else
+	{
+		for (size_t j = i; j + 1 < count; ++j)
+		{
+			at(j) = at(j + 1);
+		}
+	}
+	--count;
+
+#ifdef BUILDORDERQUEUE_DEBUG
+	checkCounters();
+#endif
+}
+
+// Add n (1 or -1) of the item to the counters.
+void BuildOrderQueue::countItem(const BuildOrderItem & item, int n)
+{
+	const MacroAct & act = item.macroAct;
+	if (act.isUnit())
+	{
+		AddCount(unitCounts, act.getUnitType().getID(), n);
+	}
+	else if (act.isUpgrade())
+	{
+		AddCount(upgradeCounts, act.getUpgradeType().getID(), n);
+	}
+	else if (act.isTech())
+	{
+		AddCount(techCounts, act.getTechType().getID(), n);
+	}
+
+	if (item.isWorkerScoutBuilding)
+	{
+		workerScoutBuildings += n;
+	}
+
+	// Upgrades are priced when the costs are asked for, the rest now.
+	for (const MacroAct * part = &act; part; part = part->hasThen() ? &part->getThen() : nullptr)
+	{
+		if (part->isUpgrade())
+		{
+			AddCount(pricedUpgrades, part->getUpgradeType().getID(), n);
+		}
+		else
+		{
+			fixedMinerals += n * part->mineralPrice(false);
+			fixedGas += n * part->gasPrice(false);
+		}
+	}
+}
+
+// Compare the counters with a scan of the queue.
+void BuildOrderQueue::checkCounters() const
+{
+	std::vector<int> units(unitCounts.size(), 0);
+	std::vector<int> upgrades(upgradeCounts.size(), 0);
+	std::vector<int> techs(techCounts.size(), 0);
+	int scouts = 0;
+	int minerals = 0;
+	int gas = 0;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		const MacroAct & act = at(i).macroAct;
+		if (act.isUnit())
+		{
+			AddCount(units, act.getUnitType().getID(), 1);
+		}
+		else if (act.isUpgrade())
+		{
+			AddCount(upgrades, act.getUpgradeType().getID(), 1);
+		}
+		else if (act.isTech())
+		{
+			AddCount(techs, act.getTechType().getID(), 1);
+		}
+
+		if (at(i).isWorkerScoutBuilding)
+		{
+			++scouts;
+		}
+		minerals += act.mineralPrice();
+		gas += act.gasPrice();
+	}
+
+	int countedMinerals, countedGas;
+	totalCosts(countedMinerals, countedGas);
+
+	UAB_ASSERT(units == unitCounts, "bad unit counts");
+	UAB_ASSERT(upgrades == upgradeCounts, "bad upgrade counts");
+	UAB_ASSERT(techs == techCounts, "bad tech counts");
+	UAB_ASSERT(scouts == workerScoutBuildings, "bad worker scout building count %d, should be %d", workerScoutBuildings, scouts);
+	UAB_ASSERT(minerals == countedMinerals && gas == countedGas,
+		"bad costs %d/%d, should be %d/%d", countedMinerals, countedGas, minerals, gas);
+}
+
+void BuildOrderQueue::clearAll()
+{
+    if (count > 0) Log().Debug() << "Cleared build queue";
+
+	first = 0;
+	count = 0;
+	unitCounts.assign(unitCounts.size(), 0);
+	upgradeCounts.assign(upgradeCounts.size(), 0);
+	techCounts.assign(techCounts.size(), 0);
+	pricedUpgrades.assign(pricedUpgrades.size(), 0);
+	workerScoutBuildings = 0;
+	fixedMinerals = 0;
+	fixedGas = 0;
+
 	modified = true;
 }
 
 // A special purpose queue modification.
 void BuildOrderQueue::dropStaticDefenses()
 {
-	for (auto it = queue.begin(); it != queue.end(); )
+	for (size_t i = count; i-- > 0; )
 	{
-		MacroAct act = (*it).macroAct;
-		
+		const MacroAct & act = at(i).macroAct;
+
 		if (act.isBuilding() &&	UnitUtil::IsComingStaticDefense(act.getUnitType()))
 		{
-			it = queue.erase(it);
-		}
-		else
-		{
-			++it;
+			erase(i);
 		}
 	}
 }
 
 void BuildOrderQueue::queueAsHighestPriority(MacroAct m, bool gasSteal)
 {
-	queue.push_back(BuildOrderItem(m, gasSteal));
+	pushBack(BuildOrderItem(m, gasSteal));
 	modified = true;
 	Log().Debug() << "Queued " << m << " at top of queue";
 }
@@ -205,38 +402,43 @@ bool BuildOrderQueue::hasRequiredUnit(BWAPI::TechType type){
 
 void BuildOrderQueue::queueAsLowestPriority(MacroAct m) 
 {
-	queue.push_front(BuildOrderItem(m));
+	pushFront(BuildOrderItem(m));
 	modified = true;
 	Log().Debug() << "Queued " << m << " at bottom of queue";
 }
 
-void BuildOrderQueue::removeHighestPriorityItem() 
+void BuildOrderQueue::removeHighestPriorityItem()
 {
-	queue.pop_back();
+	popBack();
 	modified = true;
 	Log().Debug() << "Removed highest priority item";
 }
 
 void BuildOrderQueue::doneWithHighestPriorityItem()
 {
-	queue.pop_back();
+	popBack();
 }
 
 void BuildOrderQueue::pullToTop(size_t i)
 {
-	UAB_ASSERT(i >= 0 && i < queue.size()-1, "bad index");
+	UAB_ASSERT(i >= 0 && i < count-1, "bad index");
 
 	// BWAPI::Broodwar->printf("pulling %d to top", i);
 
-	BuildOrderItem item = queue[i];								// copy it
-	queue.erase(queue.begin() + i);
+	BuildOrderItem item = at(i);								// copy it
+	erase(i);
 	queueAsHighestPriority(item.macroAct, item.isWorkerScoutBuilding);		// this sets modified = true
 }
 
 void BuildOrderQueue::pullToTop(BWAPI::UnitType type) {
-	for (int i = queue.size() - 1; i >= 1; --i)
+	if (!anyInQueue(type))
+	{
+		return;
+	}
+
+	for (int i = count - 1; i >= 1; --i)
 	{
-		const MacroAct & act = queue[i].macroAct;
+		const MacroAct & act = at(i).macroAct;
 		if (act.isUnit() && act.getUnitType() == type)
 		{
 			pullToTop(i);
@@ -246,9 +448,14 @@ void BuildOrderQueue::pullToTop(BWAPI::UnitType type) {
 }
 
 void BuildOrderQueue::pullToTop(BWAPI::UpgradeType type){
-	for (int i = queue.size() - 1; i >= 1; --i)
+	if (!anyInQueue(type))
 	{
-		const MacroAct & act = queue[i].macroAct;
+		return;
+	}
+
+	for (int i = count - 1; i >= 1; --i)
+	{
+		const MacroAct & act = at(i).macroAct;
 		if (act.isUpgrade() && act.getUpgradeType() == type)
 		{
 			pullToTop(i);
@@ -258,9 +465,14 @@ void BuildOrderQueue::pullToTop(BWAPI::UpgradeType type){
 }
 
 void BuildOrderQueue::pullToTop(BWAPI::TechType type){
-	for (int i = queue.size() - 1; i >= 1; --i)
+	if (!anyInQueue(type))
 	{
-		const MacroAct & act = queue[i].macroAct;
+		return;
+	}
+
+	for (int i = count - 1; i >= 1; --i)
+	{
+		const MacroAct & act = at(i).macroAct;
 		if (act.isTech() && act.getTechType() == type)
 		{
 			pullToTop(i);
@@ -271,28 +483,28 @@ void BuildOrderQueue::pullToTop(BWAPI::TechType type){
 
 size_t BuildOrderQueue::size() const
 {
-	return queue.size();
+	return count;
 }
 
 bool BuildOrderQueue::isEmpty() const
 {
-	return queue.empty();
+	return count == 0;
 }
 
 const BuildOrderItem & BuildOrderQueue::getHighestPriorityItem() const
 {
-	UAB_ASSERT(!queue.empty(), "taking from empty queue");
+	UAB_ASSERT(count > 0, "taking from empty queue");
 
 	// the queue will be sorted with the highest priority at the back
-	return queue.back();
+	return at(count - 1);
 }
 
 // Return the next unit type in the queue, or None, skipping over commands.
 BWAPI::UnitType BuildOrderQueue::getNextUnit() const
 {
-	for (int i = queue.size() - 1; i >= 0; --i)
+	for (int i = count - 1; i >= 0; --i)
 	{
-		const MacroAct & act = queue[i].macroAct;
+		const MacroAct & act = at(i).macroAct;
 		if (act.isUnit())
 		{
 			return act.getUnitType();
@@ -310,9 +522,9 @@ BWAPI::UnitType BuildOrderQueue::getNextUnit() const
 // Look at most n items ahead in the queue.
 int BuildOrderQueue::getNextGasCost(int n) const
 {
-	for (int i = queue.size() - 1; i >= std::max(0, int(queue.size()) - n); --i)
+	for (int i = count - 1; i >= std::max(0, int(count) - n); --i)
 	{
-		int price = queue[i].macroAct.gasPrice();
+		int price = at(i).macroAct.gasPrice();
 		if (price > 0)
 		{
 			return price;
@@ -324,46 +536,30 @@ int BuildOrderQueue::getNextGasCost(int n) const
 
 bool BuildOrderQueue::anyInQueue(BWAPI::UpgradeType type) const
 {
-	for (const auto & item : queue)
-	{
-		if (item.macroAct.isUpgrade() && item.macroAct.getUpgradeType() == type)
-		{
-			return true;
-		}
-	}
-	return false;
+	return GetCount(upgradeCounts, type.getID()) > 0;
 }
 
 bool BuildOrderQueue::anyInQueue(BWAPI::UnitType type) const
 {
-	for (const auto & item : queue)
-	{
-		if (item.macroAct.isUnit() && item.macroAct.getUnitType() == type)
-		{
-			return true;
-		}
-	}
-	return false;
+	return GetCount(unitCounts, type.getID()) > 0;
 }
 
 bool BuildOrderQueue::anyInQueue(BWAPI::TechType type) const
 {
-	for (const auto & item : queue)
-	{
-		if (item.macroAct.isTech() && item.macroAct.getTechType() == type)
-		{
-			return true;
-		}
-	}
-	return false;
+	return GetCount(techCounts, type.getID()) > 0;
 }
 
 // Are there any of these in the next N items in the queue?
 bool BuildOrderQueue::anyInNextN(BWAPI::UnitType type, int n) const
 {
-	for (int i = queue.size() - 1; i >= std::max(0, int(queue.size()) - 1 - n); --i)
+	if (!anyInQueue(type))
+	{
+		return false;
+	}
+
+	for (int i = count - 1; i >= std::max(0, int(count) - 1 - n); --i)
 	{
-		const MacroAct & act = queue[i].macroAct;
+		const MacroAct & act = at(i).macroAct;
 		if (act.isUnit() && act.getUnitType() == type)
 		{
 			return true;
@@ -375,54 +571,50 @@ bool BuildOrderQueue::anyInNextN(BWAPI::UnitType type, int n) const
 
 size_t BuildOrderQueue::numInQueue(BWAPI::UnitType type) const
 {
-	size_t count = 0;
-	for (const auto & item : queue)
-	{
-		if (item.macroAct.isUnit() && item.macroAct.getUnitType() == type)
-		{
-			++count;
-		}
-	}
-	return count;
+	return GetCount(unitCounts, type.getID());
 }
 
 size_t BuildOrderQueue::numInNextN(BWAPI::UnitType type, int n) const
 {
-	size_t count = 0;
+	// none of this type, or the whole queue
+	size_t total = numInQueue(type);
+	if (total == 0 || n + 1 >= int(count))
+	{
+		return total;
+	}
 
-	for (int i = queue.size() - 1; i >= std::max(0, int(queue.size()) - 1 - n); --i)
+	size_t num = 0;
+
+	for (int i = count - 1; i >= int(count) - 1 - n; --i)
 	{
-		const MacroAct & act = queue[i].macroAct;
+		const MacroAct & act = at(i).macroAct;
 		if (act.isUnit() && act.getUnitType() == type)
 		{
-			++count;
+			++num;
 		}
 	}
 
-	return count;
+	return num;
 }
 
 void BuildOrderQueue::totalCosts(int & minerals, int & gas) const
 {
-	minerals = 0;
-	gas = 0;
-	for (const auto & item : queue)
+	minerals = fixedMinerals;
+	gas = fixedGas;
+	for (size_t id = 0; id < pricedUpgrades.size(); ++id)
 	{
-		minerals += item.macroAct.mineralPrice();
-		gas += item.macroAct.gasPrice();
+		if (pricedUpgrades[id] > 0)
+		{
+			MacroAct upgrade = MacroAct(BWAPI::UpgradeType(id));
+			minerals += pricedUpgrades[id] * upgrade.mineralPrice();
+			gas += pricedUpgrades[id] * upgrade.gasPrice();
+		}
 	}
 }
 
 bool BuildOrderQueue::isWorkerScoutBuildingInQueue() const
 {
-	for (const auto & item : queue)
-	{
-		if (item.isWorkerScoutBuilding)
-		{
-			return true;
-		}
-	}
-	return false;
+	return workerScoutBuildings > 0;
 }
 
 void BuildOrderQueue::drawQueueInformation(int x, int y, bool outOfBook) 
@@ -434,15 +626,15 @@ void BuildOrderQueue::drawQueueInformation(int x, int y, bool outOfBook)
 	
 	char prefix = white;
 
-	size_t reps = std::min(size_t(12), queue.size());
-	int remaining = queue.size() - reps;
+	size_t reps = std::min(size_t(12), count);
+	int remaining = count - reps;
 	
 	// for each item in the queue
 	for (size_t i(0); i<reps; i++) {
 
 		prefix = white;
 
-		const BuildOrderItem & item = queue[queue.size() - 1 - i];
+		const BuildOrderItem & item = at(count - 1 - i);
         const MacroAct & act = item.macroAct;
 
         if (act.isUnit())
@@ -494,10 +686,10 @@ void BuildOrderQueue::drawQueueInformation(int x, int y, bool outOfBook)
 
 BuildOrderItem BuildOrderQueue::operator [] (int i)
 {
-	return queue[i];
+	return at(i);
 }
 
 const BuildOrderItem & BuildOrderQueue::operator [] (int i) const
 {
-	return queue[i];
+	return at(i);
 }
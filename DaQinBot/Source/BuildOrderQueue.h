@@ -17,9 +17,34 @@ struct BuildOrderItem
 
 class BuildOrderQueue
 {
-    std::deque< BuildOrderItem > queue;		// highest priority item is in the back
+	// A ring buffer: item i is at ring[(first + i) & (ring.size() - 1)], ring.size() is a power of 2.
+	// Item 0 is the lowest priority, item count-1 the highest.
+	std::vector< BuildOrderItem > ring;
+	size_t first;
+	size_t count;
 	bool modified;							// so ProductionManager can detect changes made behind its back
 
+	// Kept up to date as items are added and removed, so the queries don't scan the queue.
+	std::vector<int> unitCounts;			// by unit type ID
+	std::vector<int> upgradeCounts;			// by upgrade type ID
+	std::vector<int> techCounts;			// by tech type ID
+	std::vector<int> pricedUpgrades;		// by upgrade type ID, including "then" clauses
+	int workerScoutBuildings;
+	int fixedMinerals;						// the costs of everything but upgrades,
+	int fixedGas;							// whose price depends on the current upgrade level
+
+	BuildOrderItem & at(size_t i) { return ring[(first + i) & (ring.size() - 1)]; };
+	const BuildOrderItem & at(size_t i) const { return ring[(first + i) & (ring.size() - 1)]; };
+
+	void grow();
+	void pushBack(const BuildOrderItem & item);
+	void pushFront(const BuildOrderItem & item);
+	void popBack();
+	void erase(size_t i);
+
+	void countItem(const BuildOrderItem & item, int n);
+	void checkCounters() const;
+
 public:
 
     BuildOrderQueue();
@@ -1,6 +1,7 @@
 #include "CombatCommander.h"
 
 #include "Bases.h"
+#include "NearestUnits.h"
 #include "OpponentModel.h"
 #include "Random.h"
 #include "UnitUtil.h"
@@ -1496,51 +1497,58 @@ void CombatCommander::updateDefenseSquadUnits(Squad & defenseSquad, const size_t
 BWAPI::Unit CombatCommander::findClosestDefender(
     const Squad & defenseSquad, BWAPI::Position pos, bool flyingDefender, bool pullCloseWorkers, bool pullDistantWorkers, bool preferRangedUnits)
 {
+	auto canDefend = [&](BWAPI::Unit unit)
+	{
+		return _combatUnits.contains(unit) &&
+			(flyingDefender ? UnitUtil::CanAttackAir(unit) : UnitUtil::CanAttackGround(unit)) &&
+			_squadData.canAssignUnitToSquad(unit, defenseSquad);
+	};
+
+	// Penalize non-ranged units if we want to pull ranged units
+	auto rangePenalty = [&](BWAPI::Unit unit, int dist)
+	{
+		return (preferRangedUnits && unit->getType().groundWeapon().maxRange() <= 32) ? dist * 5 : dist;
+	};
+
+	NearestUnits & nearest = NearestUnits::Instance();
+
 	BWAPI::Unit closestDefender = nullptr;
 	int minDistance = 99999;
+	std::vector<NearestUnits::Neighbor> found;
+
+	nearest.getNearest(found, pos, 1, true, false,
+		[&](BWAPI::Unit unit) { return !unit->getType().isWorker() && canDefend(unit); },
+		NearestUnits::Metric::Air, minDistance, rangePenalty);
+	if (!found.empty())
+	{
+		closestDefender = found.front().unit;
+		minDistance = found.front().distance;
+	}
 
 	BWAPI::Unit closestWorker = nullptr;
 	int minWorkerDistance = 99999;
 
-	for (const auto unit : _combatUnits) 
+	// Pull workers only if requested
+	// Any eligible worker will do, not necessarily the closest; the last one found is taken.
+	if (pullCloseWorkers || pullDistantWorkers)
 	{
-		if ((flyingDefender && !UnitUtil::CanAttackAir(unit)) ||
-			(!flyingDefender && !UnitUtil::CanAttackGround(unit)))
-        {
-            continue;
-        }
-
-        if (!_squadData.canAssignUnitToSquad(unit, defenseSquad))
-        {
-            continue;
-        }
-
-		int dist = unit->getDistance(pos);
-
-        // Penalize non-ranged units if we want to pull ranged units
-        if (preferRangedUnits && unit->getType().groundWeapon().maxRange() <= 32)
-            dist *= 5;
-
-		if (unit->getType().isWorker())
+		for (const auto unit : _combatUnits)
 		{
-			// Pull workers only if requested
-            if (!pullCloseWorkers && !pullDistantWorkers) continue;
+			if (!unit->getType().isWorker() || !canDefend(unit))
+			{
+				continue;
+			}
 
-            // Validate the distance
-            if (dist > 1000 || (dist > 200 && !pullDistantWorkers) || (dist <= 200 && !pullCloseWorkers)) continue;
+			int dist = rangePenalty(unit, unit->getDistance(pos));
 
-            // Don't pull builders, this can delay defensive structures
-            if (WorkerManager::Instance().isBuilder(unit)) continue;
+			// Validate the distance
+			if (dist > 1000 || (dist > 200 && !pullDistantWorkers) || (dist <= 200 && !pullCloseWorkers)) continue;
+
+			// Don't pull builders, this can delay defensive structures
+			if (WorkerManager::Instance().isBuilder(unit)) continue;
 
 			closestWorker = unit;
 			minWorkerDistance = dist;
-			continue;
-		}
-
-		if (dist < minDistance)
-		{
-			closestDefender = unit;
-			minDistance = dist;
 		}
 	}
 
@@ -23,6 +23,7 @@ namespace Config
 		int MaxGameRecords					= 0;
 		bool ReadOpponentModel				= false;
 		bool WriteOpponentModel				= false;
+		bool UseSearchCache					= false;
 	}
 
 	namespace Strategy
@@ -90,6 +91,7 @@ namespace Config
 		bool DrawUnitOrders					= false;
         bool DrawSquadInfo                  = false;
         bool DrawBOSSStateInfo              = false;
+        bool BenchmarkTargetAssignment      = false;
 
         std::string ErrorLogFilename        = "DaQin_ErrorLog.txt";
         bool LogAssertToErrorFile           = false;
@@ -116,6 +118,8 @@ namespace Config
     namespace Macro
     {
         int BOSSFrameLimit                  = 160;
+        int BOSSBeamGoalSize                = 20;       // units still to make before BOSS uses beam search, 0 = never
+        int BOSSGoalComparisonThreads       = 2;        // threads that search candidate goals at the same time
         int WorkersPerRefinery              = 3;
 		double WorkersPerPatch              = 3.0;
 		int AbsoluteMaxWorkers				= 75;
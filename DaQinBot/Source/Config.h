@@ -27,6 +27,7 @@ namespace Config
 		extern int MaxGameRecords;
 		extern bool ReadOpponentModel;
 		extern bool WriteOpponentModel;
+		extern bool UseSearchCache;
 	}
 
 	namespace Strategy
@@ -84,6 +85,7 @@ namespace Config
         extern bool DrawBuildingInfo;
 		extern bool DrawReservedBuildingTiles;
 		extern bool DrawBOSSStateInfo;
+		extern bool BenchmarkTargetAssignment;
 
         extern std::string ErrorLogFilename;
         extern bool LogAssertToErrorFile;
@@ -110,6 +112,8 @@ namespace Config
     namespace Macro
     {
         extern int BOSSFrameLimit;
+        extern int BOSSBeamGoalSize;
+        extern int BOSSGoalComparisonThreads;
         extern int WorkersPerRefinery;
 		extern double WorkersPerPatch;
 		extern int AbsoluteMaxWorkers;
@@ -12,6 +12,7 @@
 #include "Common.h"
 #include "OpponentModel.h"
 #include "ParseUtils.h"
+#include "TargetAssignment.h"
 #include "UnitUtil.h"
 
 using namespace UAlbertaBot;
@@ -76,6 +77,12 @@ void UAlbertaBotModule::onStart()
         BWAPI::Broodwar->printf("%s by %s, based on UAlbertaBot via Steamhammer and Locutus.", Config::BotInfo::BotName.c_str(), Config::BotInfo::Authors.c_str());
 	}
 
+	// Per-frame cost of target assignment for a big fight, 50 units against 80 targets.
+	if (Config::Debug::BenchmarkTargetAssignment)
+	{
+		TargetAssignment::Benchmark(50, 80, 1000);
+	}
+
 	for (auto type : BWAPI::UnitTypes::allUnitTypes()){
 		std::stringstream msg;
 
@@ -1,6 +1,7 @@
 #include "Common.h"
 #include "GameCommander.h"
 #include "OpponentModel.h"
+#include "BOSSSearchCache.h"
 #include "UnitUtil.h"
 #include "PathFinding.h"
 
@@ -68,7 +69,7 @@ void GameCommander::update()
 #endif
 
 	_timerManager.startTimer(TimerManager::Search);
-	BOSSManager::Instance().update(35 - _timerManager.getMilliseconds());
+	BOSSManager::Instance().update();
 	_timerManager.stopTimer(TimerManager::Search);
 
 #ifdef CRASH_DEBUG
@@ -415,8 +416,13 @@ void GameCommander::surrender()
 
 void GameCommander::onEnd(bool isWinner)
 {
+    // don't leave a search thread running after the game
+    BOSSManager::Instance().stopGoalComparison();
+    BOSSManager::Instance().reset();
+
     OpponentModel::Instance().setWin(isWinner);
     OpponentModel::Instance().write();
+    BOSSSearchCache::Instance().write();
 }
 
 void GameCommander::onUnitShow(BWAPI::Unit unit)			
@@ -433,16 +439,19 @@ void GameCommander::onUnitHide(BWAPI::Unit unit)
 void GameCommander::onUnitCreate(BWAPI::Unit unit)		
 { 
 	InformationManager::Instance().onUnitCreate(unit); 
+	ProductionManager::Instance().onUnitCreate(unit);
 }
 
 void GameCommander::onUnitComplete(BWAPI::Unit unit)
 {
 	InformationManager::Instance().onUnitComplete(unit);
+	ProductionManager::Instance().onUnitComplete(unit);
 }
 
 void GameCommander::onUnitRenegade(BWAPI::Unit unit)		
 { 
 	InformationManager::Instance().onUnitRenegade(unit); 
+	ProductionManager::Instance().onUnitRenegade(unit);
 }
 
 void GameCommander::onUnitDestroy(BWAPI::Unit unit)		
@@ -456,6 +465,7 @@ void GameCommander::onUnitMorph(BWAPI::Unit unit)
 { 
 	InformationManager::Instance().onUnitMorph(unit);
 	WorkerManager::Instance().onUnitMorph(unit);
+	ProductionManager::Instance().onUnitMorph(unit);
 }
 
 BWAPI::Unit GameCommander::getScoutWorker()
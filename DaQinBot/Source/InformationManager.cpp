@@ -3,6 +3,7 @@
 #include "Bases.h"
 #include "MapTools.h"
 #include "MapGrid.h"
+#include "OpponentModel.h"
 #include "ProductionManager.h"
 #include "Random.h"
 #include "UnitUtil.h"
@@ -785,7 +786,15 @@ void InformationManager::updateBullets()
     }
 }
 
-bool trace(BWAPI::TilePosition tile, BWAPI::TilePosition wallTile, int direction, std::set<BWAPI::TilePosition> & wallTiles)
+namespace
+{
+    size_t tileBit(BWAPI::TilePosition tile)
+    {
+        return tile.x * 256 + tile.y;
+    }
+}
+
+bool trace(BWAPI::TilePosition tile, BWAPI::TilePosition wallTile, int direction, TileBitmap & wallTiles)
 {
     Log().Debug() << "Wall tracing from " << tile << "; wall " << wallTile << "; direction=" << direction;
 
@@ -832,31 +841,31 @@ bool trace(BWAPI::TilePosition tile, BWAPI::TilePosition wallTile, int direction
         // Add the wall tile and continue
         tile = next;
         wallTile = nextWall;
-        wallTiles.insert(wallTile);
+        wallTiles.set(tileBit(wallTile));
 
         Log().Debug() << "Next " << tile << "; wall " << wallTile << "; direction=" << direction;
     }
 }
 
-void floodFill(BWAPI::TilePosition start, std::set<BWAPI::TilePosition> & visited)
+void floodFill(BWAPI::TilePosition start, TileBitmap & visited)
 {
-    std::queue<BWAPI::TilePosition> tileQueue;
-    tileQueue.push(start);
-    while (!tileQueue.empty())
+    std::vector<BWAPI::TilePosition> tileStack;
+    tileStack.push_back(start);
+    while (!tileStack.empty())
     {
-        BWAPI::TilePosition current = tileQueue.front();
-        tileQueue.pop();
+        BWAPI::TilePosition current = tileStack.back();
+        tileStack.pop_back();
 
         if (!current.isValid()) continue;
-        if (visited.find(current) != visited.end()) continue;
+        if (visited[tileBit(current)]) continue;
         if (!bwebMap.isWalkable(current)) continue;
 
-        visited.insert(current);
+        visited.set(tileBit(current));
 
-        tileQueue.push(current + BWAPI::TilePosition(1, 0));
-        tileQueue.push(current + BWAPI::TilePosition(0, 1));
-        tileQueue.push(current + BWAPI::TilePosition(-1, 0));
-        tileQueue.push(current + BWAPI::TilePosition(0, -1));
+        tileStack.push_back(current + BWAPI::TilePosition(1, 0));
+        tileStack.push_back(current + BWAPI::TilePosition(0, 1));
+        tileStack.push_back(current + BWAPI::TilePosition(-1, 0));
+        tileStack.push_back(current + BWAPI::TilePosition(0, -1));
     }
 }
 
@@ -876,7 +885,8 @@ void InformationManager::detectEnemyWall(BWAPI::Unit unit)
         if (!choke->Blocked() && unit->getDistance(BWAPI::Position(choke->Center())) < 320)
         {
             // If we have already registered a wall for this choke, no need to continue
-            if (enemyWalls.find(choke) != enemyWalls.end()) continue;
+            if (std::find_if(enemyWalls.begin(), enemyWalls.end(),
+                [choke](const EnemyWall & wall) { return wall.choke == choke; }) != enemyWalls.end()) continue;
 
             // Determine which area is on our side of the wall
             int firstDist = PathFinding::GetGroundDistance(BWAPI::Position(choke->GetAreas().first->Top()), getMyMainBaseLocation()->getPosition(), PathFinding::PathFindingOptions::UseNearestBWEMArea);
@@ -904,7 +914,7 @@ void InformationManager::detectEnemyWall(BWAPI::Unit unit)
             }
 
             // When the path hits a building, try to trace the wall
-            std::set<BWAPI::TilePosition> wallTiles;
+            TileBitmap wallTiles;
             BWAPI::TilePosition last = BWAPI::TilePositions::Invalid;
             for (auto tile : path)
             {
@@ -921,15 +931,15 @@ void InformationManager::detectEnemyWall(BWAPI::Unit unit)
                 if (trace(last, tile, 1, wallTiles) &&
                     trace(last, tile, -1, wallTiles))
                 {
-                    wallTiles.insert(tile);
+                    wallTiles.set(tileBit(tile));
                     break;
                 }
 
-                wallTiles.clear();
+                wallTiles.reset();
                 last = BWAPI::TilePositions::Invalid;
             }
 
-            if (wallTiles.empty())
+            if (wallTiles.none())
             {
                 Log().Get() << "Warning: Unable to trace probable wall near choke @ " << BWAPI::TilePosition(choke->Center());
                 continue;
@@ -938,11 +948,15 @@ void InformationManager::detectEnemyWall(BWAPI::Unit unit)
             Log().Get() << "Detected wall near choke @ " << BWAPI::TilePosition(choke->Center());
 
             // Now do a flood fill to get all of the tiles that are part of or behind the wall
-            std::set<BWAPI::TilePosition> tilesBehindWall = wallTiles;
-            floodFill(start, tilesBehindWall);
+            EnemyWall wall;
+            wall.choke = choke;
+            wall.wallTiles = wallTiles;
+            wall.tilesBehindWall = wallTiles;
+            floodFill(start, wall.tilesBehindWall);
 
             // Add to our set of walls
-            enemyWalls[choke] = std::make_pair(wallTiles, tilesBehindWall);
+            enemyWalls.push_back(wall);
+            updateEnemyWallGrids();
         }
 }
 
@@ -951,18 +965,22 @@ void InformationManager::detectBrokenEnemyWall(BWAPI::UnitType type, BWAPI::Tile
 {
     if (!type.isBuilding()) return;
 
+    if (enemyWalls.empty()) return;
+
     // For each wall...
+    bool changed = false;
     for (auto it = enemyWalls.begin(); it != enemyWalls.end(); )
     {
-        // ...check if any tiles in the building are in its wallTiles set
-        auto& wallTiles = it->second.first;
+        // ...check if any tiles in the building are in its wallTiles bitmap
+        auto& wallTiles = it->wallTiles;
         for (auto x = tile.x; x < tile.x + type.tileWidth(); x++)
             for (auto y = tile.y; y < tile.y + type.tileHeight(); y++)
-                if (wallTiles.find(BWAPI::TilePosition(x, y)) != wallTiles.end())
+                if (BWAPI::TilePosition(x, y).isValid() && wallTiles[tileBit(BWAPI::TilePosition(x, y))])
                 {
                     // ...and if so, erase the wall
-                    Log().Get() << "Detected broken wall near choke @ " << BWAPI::TilePosition(it->first->Center());
+                    Log().Get() << "Detected broken wall near choke @ " << BWAPI::TilePosition(it->choke->Center());
                     it = enemyWalls.erase(it);
+                    changed = true;
                     goto nextWall;
                 }
 
@@ -970,6 +988,44 @@ void InformationManager::detectBrokenEnemyWall(BWAPI::UnitType type, BWAPI::Tile
 
     nextWall:;
     }
+
+    if (changed) updateEnemyWallGrids();
+}
+
+// Rebuild the combined bitmaps and the nearest wall grid after the set of walls changes.
+// A wall counts as nearest to a tile if its choke center is within 500 of the tile center.
+void InformationManager::updateEnemyWallGrids()
+{
+    enemyWallTiles.reset();
+    tilesBehindEnemyWalls.reset();
+    std::fill(&nearestEnemyWall[0][0], &nearestEnemyWall[0][0] + 256 * 256, uint8_t(0));
+
+    if (enemyWalls.empty()) return;
+
+    std::vector<BWAPI::Position> chokeCenters;
+    for (auto & wall : enemyWalls)
+    {
+        enemyWallTiles |= wall.wallTiles;
+        tilesBehindEnemyWalls |= wall.tilesBehindWall;
+        chokeCenters.push_back(BWAPI::Position(wall.choke->Center()));
+    }
+
+    for (int x = 0; x < BWAPI::Broodwar->mapWidth(); x++)
+        for (int y = 0; y < BWAPI::Broodwar->mapHeight(); y++)
+        {
+            BWAPI::Position tileCenter = BWAPI::Position(BWAPI::TilePosition(x, y)) + BWAPI::Position(16, 16);
+
+            int bestDist = 500;
+            for (size_t i = 0; i < chokeCenters.size() && i < 255; i++)
+            {
+                int dist = tileCenter.getApproxDistance(chokeCenters[i]);
+                if (dist < bestDist)
+                {
+                    bestDist = dist;
+                    nearestEnemyWall[x][y] = uint8_t(i + 1);
+                }
+            }
+        }
 }
 
 // Is the unit part of an enemy wall?
@@ -977,11 +1033,10 @@ bool InformationManager::isEnemyWallBuilding(BWAPI::Unit unit)
 {
     if (!unit->getType().isBuilding()) return false;
 
-    for (auto & wall : enemyWalls)
-        for (auto x = unit->getTilePosition().x; x < unit->getTilePosition().x + unit->getType().tileWidth(); x++)
-            for (auto y = unit->getTilePosition().y; y < unit->getTilePosition().y + unit->getType().tileHeight(); y++)
-                if (wall.second.first.find(BWAPI::TilePosition(x, y)) != wall.second.first.end())
-                    return true;
+    for (auto x = unit->getTilePosition().x; x < unit->getTilePosition().x + unit->getType().tileWidth(); x++)
+        for (auto y = unit->getTilePosition().y; y < unit->getTilePosition().y + unit->getType().tileHeight(); y++)
+            if (BWAPI::TilePosition(x, y).isValid() && enemyWallTiles[tileBit(BWAPI::TilePosition(x, y))])
+                return true;
 
     return false;
 }
@@ -993,30 +1048,22 @@ bool InformationManager::isBehindEnemyWall(BWAPI::Unit attacker, BWAPI::Unit tar
     if (enemyWalls.empty()) return false;
     if (isEnemyWallBuilding(target)) return false;
 
+    BWAPI::TilePosition attackerTile = attacker->getTilePosition();
+    BWAPI::TilePosition targetTile = target->getTilePosition();
+    if (!attackerTile.isValid() || !targetTile.isValid()) return false;
+
     // Find the closest enemy wall, ignoring walls that are far away
-    int bestDist = INT_MAX;
-    std::set<BWAPI::TilePosition> * tilesBehindWall = nullptr;
-    for (auto & wall : enemyWalls)
-    {
-        int dist = attacker->getDistance(BWAPI::Position(wall.first->Center()));
-        if (dist < bestDist && dist < 500)
-        {
-            bestDist = dist;
-            tilesBehindWall = &wall.second.second;
-        }
-    }
-    if (!tilesBehindWall) return false;
+    uint8_t wall = nearestEnemyWall[attackerTile.x][attackerTile.y];
+    if (!wall) return false;
 
-    // Target is behind the wall if its position is in the set
-    return tilesBehindWall->find(target->getTilePosition()) != tilesBehindWall->end();
+    // Target is behind the wall if its tile is in the bitmap
+    return enemyWalls[wall - 1].tilesBehindWall[tileBit(targetTile)];
 }
 
 // Returns true if the give tile is either part of an enemy wall or is in the area behind the wall
 bool InformationManager::isBehindEnemyWall(BWAPI::TilePosition tile)
 {
-    for (auto & wall : enemyWalls)
-        if (wall.second.second.find(tile) != wall.second.second.end()) return true;
-    return false;
+    return tile.isValid() && tilesBehindEnemyWalls[tileBit(tile)];
 }
 
 bool InformationManager::isEnemyBuildingInRegion(BWTA::Region * region, bool ignoreRefineries) 
@@ -1666,9 +1713,6 @@ void InformationManager::onUnitDestroy(BWAPI::Unit unit)
 		{
 			_staticDefense.erase(unit);
 		}
-
-		removeAttackDamages(unit); 
-		removeAttackNumbers(unit);
 	}
 
     if (unit->getPlayer() == _self)
@@ -1682,6 +1726,16 @@ void InformationManager::onUnitDestroy(BWAPI::Unit unit)
     }
 }
 
+void InformationManager::onEnemyUnitChanged(const UnitInfo & ui, BWAPI::UnitType oldType, bool oldCompleted)
+{
+	OpponentModel::Instance().getPlanRecognizer().onEnemyUnitChanged(ui, oldType, oldCompleted);
+}
+
+void InformationManager::onEnemyUnitRemoved(const UnitInfo & ui)
+{
+	OpponentModel::Instance().getPlanRecognizer().onEnemyUnitRemoved(ui);
+}
+
 void InformationManager::onEnemyBuildingLanded(BWAPI::Unit building)
 {
     // Check if this building forms a wall
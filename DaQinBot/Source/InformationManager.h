@@ -2,6 +2,7 @@
 
 #include "Common.h"
 #include "BWTA.h"
+#include <bitset>
 
 #include "Base.h"
 #include "UnitData.h"
@@ -10,6 +11,9 @@
 
 namespace UAlbertaBot
 {
+// One bit per tile of the largest possible map, indexed by x * 256 + y.
+typedef std::bitset<256 * 256> TileBitmap;
+
 class InformationManager 
 {
 	BWAPI::Player	_self;
@@ -42,9 +46,6 @@ class InformationManager
 	double			_enemyFightScore = 0;//˵սܺ
 	double			_selfFightScore = 0;//ҷսܺ
 
-	std::map<BWAPI::Unit, int> _attackDamages;//Ŀ˺ֵ
-	std::map<BWAPI::Unit, int> _attackNumbers;//Ŀ
-
 	std::map<BWAPI::Player, UnitData>                   _unitData;
 	std::map<BWAPI::Player, BWTA::BaseLocation *>       _mainBaseLocations;
 	BWTA::BaseLocation *								_myNaturalBaseLocation;  // whether taken yet or not; may be null
@@ -62,9 +63,20 @@ class InformationManager
     int                             bulletsSeenAtExtendedMarineRange;
 
     // All enemy walls we have detected
-    // First set in the pair: the forward tiles in the wall. These tiles are covered by the wall buildings.
-    // Second set in the pair: all tiles behind or part of the wall.
-    std::map<const BWEM::ChokePoint*, std::pair<std::set<BWAPI::TilePosition>, std::set<BWAPI::TilePosition>>> enemyWalls;
+    // wallTiles: the forward tiles in the wall. These tiles are covered by the wall buildings.
+    // tilesBehindWall: all tiles behind or part of the wall.
+    struct EnemyWall
+    {
+        const BWEM::ChokePoint *    choke;
+        TileBitmap                  wallTiles;
+        TileBitmap                  tilesBehindWall;
+    };
+    std::vector<EnemyWall>  enemyWalls;
+
+    // Derived from enemyWalls whenever a wall is detected or broken
+    TileBitmap              enemyWallTiles;                     // wall tiles of all walls
+    TileBitmap              tilesBehindEnemyWalls;              // tiles behind or part of any wall
+    uint8_t                 nearestEnemyWall[256][256] = {};    // 1 + index of the closest wall within 500 of the tile, 0 if none
 
     // Caches of enemy unit statistics, used to track upgrades
     std::map<BWAPI::WeaponType, int> enemyWeaponDamage;
@@ -103,6 +115,7 @@ class InformationManager
 
     void                    detectEnemyWall(BWAPI::Unit unit);
     void                    detectBrokenEnemyWall(BWAPI::UnitType type, BWAPI::TilePosition tile);
+    void                    updateEnemyWallGrids();
 
 public:
 
@@ -110,13 +123,17 @@ public:
 
     // event driven stuff
 	void					onUnitShow(BWAPI::Unit unit)        { updateUnit(unit); maybeAddBase(unit); }
-	void					onUnitHide(BWAPI::Unit unit)        { updateUnit(unit); removeAttackDamages(unit); removeAttackNumbers(unit); }
+	void					onUnitHide(BWAPI::Unit unit)        { updateUnit(unit); }
 	void					onUnitCreate(BWAPI::Unit unit)		{ updateUnit(unit); maybeAddBase(unit); }
 	void					onUnitComplete(BWAPI::Unit unit)    { updateUnit(unit); maybeAddStaticDefense(unit); }
 	void					onUnitMorph(BWAPI::Unit unit)       { updateUnit(unit); maybeAddBase(unit); }
     void					onUnitRenegade(BWAPI::Unit unit)    { updateUnit(unit); }
     void					onUnitDestroy(BWAPI::Unit unit);
     void                    onNewEnemyUnit(BWAPI::Unit unit)    { detectEnemyWall(unit); }
+
+	// Changes to the enemy unit data, passed on to the plan recognizer.
+	void					onEnemyUnitChanged(const UnitInfo & ui, BWAPI::UnitType oldType, bool oldCompleted);
+	void					onEnemyUnitRemoved(const UnitInfo & ui);
     void                    onEnemyBuildingLanded(BWAPI::Unit unit);
     void                    onEnemyBuildingFlying(BWAPI::UnitType type, BWAPI::Position lastPosition);
 
@@ -210,16 +227,6 @@ public:
     LocutusUnit&            getLocutusUnit(BWAPI::Unit unit);
     LocutusMapGrid&         getMyUnitGrid() { return _myUnitGrid; };
 
-	void					setAttackDamages(BWAPI::Unit unit, int damage) { _attackDamages[unit] += damage; };
-	int						getAttackDamages(BWAPI::Unit unit) { if (_attackDamages[unit]) { return _attackDamages[unit]; } else { return 0; } };
-	void					clearAttackDamages() { _attackDamages.clear(); }
-	void					removeAttackDamages(BWAPI::Unit unit) { if (_attackDamages[unit]) { _attackDamages.erase(unit); } }
-
-	void					setAttackNumbers(BWAPI::Unit unit, int number) { _attackNumbers[unit] += number; };
-	int						getAttackNumbers(BWAPI::Unit unit) { if (_attackNumbers[unit]) { return _attackNumbers[unit]; } else { return 0; } };
-	void					clearAttackNumbers() { _attackNumbers.clear(); }
-	void					removeAttackNumbers(BWAPI::Unit unit) { if (_attackNumbers[unit]) { _attackNumbers.erase(unit); } }
-
 	const int				getPlayerLost(BWAPI::Player player) { return _unitData[player].getMineralsLost() + _unitData[player].getGasLost(); };
 	void					setPlayerLost(BWAPI::Player player, int mineralsLost = 0, int gasLost = 0) { _unitData[player].setMineralsLost(mineralsLost); _unitData[player].setGasLost(gasLost); }
 
@@ -1,5 +1,6 @@
 #include "MacroAct.h"
 #include "BuildingManager.h"
+#include "UnitUtil.h"
 
 #include <regex>
 
@@ -540,87 +541,88 @@ void MacroAct::getCandidateProducers(std::vector<BWAPI::Unit> & candidates) cons
 		return;
 	}
 
-	BWAPI::UnitType producerType = whatBuilds();
-
 	for (const auto unit : BWAPI::Broodwar->self()->getUnits())
 	{
-		// Reasons that a unit cannot produce the desired type:
-
-		if (producerType != unit->getType()) { continue; }
-
-		// TODO Due to a BWAPI 4.1.2 bug, lair research can't be done in a hive.
-		//      Also spire upgrades can't be done in a greater spire.
-		//      The bug is fixed in the next version, 4.2.0.
-		//      When switching to a fixed version, change the above line to the following:
-		// If the producerType is a lair, a hive will do as well.
-		// Note: Burrow research in a hatchery can also be done in a lair or hive, but we rarely want to.
-		// Ignore the possibility so that we don't accidentally waste lair time.
-		//if (!(
-		//	producerType == unit->getType() ||
-		//	producerType == BWAPI::UnitTypes::Zerg_Lair && unit->getType() == BWAPI::UnitTypes::Zerg_Hive ||
-		//  producerType == BWAPI::UnitTypes::Zerg_Spire && unit->getType() == BWAPI::UnitTypes::Zerg_Greater_Spire
-		//	))
-		//{
-		//	continue;
-		//}
-
-		if (!unit->isCompleted())  { continue; }
-		if (unit->isTraining())    { continue; }
-		if (unit->isLifted())      { continue; }
-		if (!unit->isPowered())    { continue; }
-		if (unit->isUpgrading())   { continue; }
-		if (unit->isResearching()) { continue; }
-
-		// if the type is an addon, some special cases
-		if (isAddon())
+		if (isCandidateProducer(unit))
 		{
-			// Already has an addon, or is otherwise unable to make one.
-			if (!unit->canBuildAddon())
-			{
-				continue;
-			}
+			candidates.push_back(unit);
+		}
+	}
+}
 
-			// if we just told this unit to build an addon, then it will not be building another one
-			// this deals with the frame-delay of telling a unit to build an addon and it actually starting to build
-			if (unit->getLastCommand().getType() == BWAPI::UnitCommandTypes::Build_Addon)
-				//			if (unit->getLastCommand().getType() == BWAPI::UnitCommandTypes::Build_Addon &&
-				//                (BWAPI::Broodwar->getFrameCount() - unit->getLastCommandFrame() < 10)) 
-			{
-				continue;
-			}
+// The unit is able to carry out this macro act now. See getCandidateProducers().
+bool MacroAct::isCandidateProducer(BWAPI::Unit unit) const
+{
+	// Reasons that a unit cannot produce the desired type:
+
+	if (whatBuilds() != unit->getType()) { return false; }
+
+	// TODO Due to a BWAPI 4.1.2 bug, lair research can't be done in a hive.
+	//      Also spire upgrades can't be done in a greater spire.
+	//      The bug is fixed in the next version, 4.2.0.
+	//      When switching to a fixed version, change the above line to the following:
+	// If the producerType is a lair, a hive will do as well.
+	// Note: Burrow research in a hatchery can also be done in a lair or hive, but we rarely want to.
+	// Ignore the possibility so that we don't accidentally waste lair time.
+	//if (!(
+	//	whatBuilds() == unit->getType() ||
+	//	whatBuilds() == BWAPI::UnitTypes::Zerg_Lair && unit->getType() == BWAPI::UnitTypes::Zerg_Hive ||
+	//  whatBuilds() == BWAPI::UnitTypes::Zerg_Spire && unit->getType() == BWAPI::UnitTypes::Zerg_Greater_Spire
+	//	))
+	//{
+	//	return false;
+	//}
+
+	if (!UnitUtil::IsIdleProducer(unit)) { return false; }
+
+	// if the type is an addon, some special cases
+	if (isAddon())
+	{
+		// Already has an addon, or is otherwise unable to make one.
+		if (!unit->canBuildAddon())
+		{
+			return false;
 		}
 
-		// if a unit requires an addon and the producer doesn't have one
-		// TODO Addons seem a bit erratic. Bugs are likely.
-		// TODO What exactly is requiredUnits()? On the face of it, the story is that
-		//      this code is for e.g. making tanks, built in a factory which has a machine shop.
-		//      Research that requires an addon is done in the addon, a different case.
-		//      Apparently wrong for e.g. ghosts, which require an addon not on the producer.
-		if (isUnit())
+		// if we just told this unit to build an addon, then it will not be building another one
+		// this deals with the frame-delay of telling a unit to build an addon and it actually starting to build
+		if (unit->getLastCommand().getType() == BWAPI::UnitCommandTypes::Build_Addon)
+			//			if (unit->getLastCommand().getType() == BWAPI::UnitCommandTypes::Build_Addon &&
+			//                (BWAPI::Broodwar->getFrameCount() - unit->getLastCommandFrame() < 10)) 
 		{
-			bool reject = false;   // innocent until proven guilty
-			typedef std::pair<BWAPI::UnitType, int> ReqPair;
-			for (const ReqPair & pair : getUnitType().requiredUnits())
+			return false;
+		}
+	}
+
+	// if a unit requires an addon and the producer doesn't have one
+	// TODO Addons seem a bit erratic. Bugs are likely.
+	// TODO What exactly is requiredUnits()? On the face of it, the story is that
+	//      this code is for e.g. making tanks, built in a factory which has a machine shop.
+	//      Research that requires an addon is done in the addon, a different case.
+	//      Apparently wrong for e.g. ghosts, which require an addon not on the producer.
+	if (isUnit())
+	{
+		bool reject = false;   // innocent until proven guilty
+		typedef std::pair<BWAPI::UnitType, int> ReqPair;
+		for (const ReqPair & pair : getUnitType().requiredUnits())
+		{
+			BWAPI::UnitType requiredType = pair.first;
+			if (requiredType.isAddon())
 			{
-				BWAPI::UnitType requiredType = pair.first;
-				if (requiredType.isAddon())
+				if (!unit->getAddon() || (unit->getAddon()->getType() != requiredType))
 				{
-					if (!unit->getAddon() || (unit->getAddon()->getType() != requiredType))
-					{
-						reject = true;
-						break;     // out of inner loop
-					}
+					reject = true;
+					break;     // out of inner loop
 				}
 			}
-			if (reject)
-			{
-				continue;
-			}
 		}
-
-		// If we haven't rejected it, add it to the list of candidates.
-		candidates.push_back(unit);
+		if (reject)
+		{
+			return false;
+		}
 	}
+
+	return true;
 }
 
 // The item can potentially be produced soon-ish; the producer is on hand and not too busy.
@@ -94,6 +94,7 @@ public:
 	void setReservedPosition(BWAPI::TilePosition tile) const { _reservedPosition = tile; }
 
 	void getCandidateProducers(std::vector<BWAPI::Unit> & candidates) const;
+	bool isCandidateProducer(BWAPI::Unit unit) const;
 	bool hasPotentialProducer() const;
 	bool hasTech() const;
 
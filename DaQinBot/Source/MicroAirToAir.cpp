@@ -76,7 +76,7 @@ BWAPI::Unit MicroAirToAir::getTarget(BWAPI::Unit airUnit, const BWAPI::Unitset &
 	for (const auto target : targets)
 	{
 		const int priority = getAttackPriority(airUnit, target);		// 0..12
-		const int range = airUnit->getDistance(target);					// 0..map size in pixels
+		const int range = targetMatrix().getDistance(airUnit, target);	// 0..map size in pixels
 		const int closerToGoal =										// positive if target is closer than us to the goal
 			airUnit->getDistance(order.getPosition()) - target->getDistance(order.getPosition());
 
@@ -99,7 +99,7 @@ BWAPI::Unit MicroAirToAir::getTarget(BWAPI::Unit airUnit, const BWAPI::Unitset &
 		}
 
 		// This could adjust for relative speed and direction, so that we don't chase what we can't catch.
-		if (airUnit->isInWeaponRange(target))
+		if (targetMatrix().isInWeaponRange(airUnit, target))
 		{
 			score += 4 * 32;
 		}
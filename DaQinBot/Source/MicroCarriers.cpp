@@ -23,6 +23,9 @@ void MicroCarriers::executeMicro(const BWAPI::Unitset & targets)
 			!u->isStasised();
 	});
 
+	// Carriers that won't take a new target this frame get their orders first, so that they
+	// don't use up the damage budget of a target that other carriers could attack.
+	BWAPI::Unitset attackers;
     for (const auto carrier : carriers)
 	{
 		if (buildScarabOrInterceptor(carrier))
@@ -69,158 +72,165 @@ void MicroCarriers::executeMicro(const BWAPI::Unitset & targets)
                 }
             }
 
-			// If a target is found,
-			BWAPI::Unit target = getTarget(carrier, carrierTargets);
-			if (target)
-			{
-				if (Config::Debug::DrawUnitTargetInfo)
-				{
-					BWAPI::Broodwar->drawLineMap(carrier->getPosition(), carrier->getTargetPosition(), BWAPI::Colors::Purple);
-				}
+			attackers.insert(carrier);
+		}
+	}
 
-				// attack it.
-                Micro::AttackUnit(carrier, target);
+	// Score every attacking carrier against every target in one pass, then share out the targets.
+	// A carrier's damage is that of all its interceptors.
+	_targetAssignment.reset(attackers, carrierTargets);
+	for (size_t i = 0; i < _targetAssignment.getUnits().size(); ++i)
+	{
+		int * scores = _targetAssignment.scoreRow(i);
+		for (size_t j = 0; j < _targetAssignment.getTargets().size(); ++j)
+		{
+			scores[j] = getTargetScore(_targetAssignment.getUnits()[i], _targetAssignment.getTargets()[j]);
+		}
+	}
+	_targetAssignment.assign([this](size_t row, size_t column)
+	{
+		return
+			BWAPI::Broodwar->getDamageFrom(BWAPI::UnitTypes::Protoss_Interceptor, _targetAssignment.getTargets()[column]->getType()) *
+			_targetAssignment.getUnits()[row]->getInterceptorCount();
+	});
+
+	for (const auto carrier : attackers)
+	{
+		// If a target is found,
+		BWAPI::Unit target = getTarget(carrier);
+		if (target)
+		{
+			if (Config::Debug::DrawUnitTargetInfo)
+			{
+				BWAPI::Broodwar->drawLineMap(carrier->getPosition(), carrier->getTargetPosition(), BWAPI::Colors::Purple);
 			}
-			else
+
+			// attack it.
+            Micro::AttackUnit(carrier, target);
+		}
+		else
+		{
+            // No target found. If we're not near the order position, go there.
+			if (carrier->getDistance(order.getPosition()) > 100)
 			{
-                // No target found. If we're not near the order position, go there.
-				if (carrier->getDistance(order.getPosition()) > 100)
-				{
-                    InformationManager::Instance().getLocutusUnit(carrier).moveTo(order.getPosition());
-				}
+                InformationManager::Instance().getLocutusUnit(carrier).moveTo(order.getPosition());
 			}
 		}
 	}
 }
 
-BWAPI::Unit MicroCarriers::getTarget(BWAPI::Unit rangedUnit, const BWAPI::Unitset & targets)
+BWAPI::Unit MicroCarriers::getTarget(BWAPI::Unit rangedUnit)
 {
-	int bestScore = -999999;
-	BWAPI::Unit bestTarget = nullptr;
-	int bestPriority = -1;   // TODO debug only
+	return _targetAssignment.getTarget(rangedUnit);
+}
 
-	for (const auto target : targets)
-	{
-		int priority = getAttackPriority(rangedUnit, target);     // 0..12
-		int range = rangedUnit->getDistance(target);           // 0..map size in pixels
-		int toGoal = target->getDistance(order.getPosition());  // 0..map size in pixels
+// Score the target for the unit, or TargetAssignment::NoTarget if the unit should not consider it.
+int MicroCarriers::getTargetScore(BWAPI::Unit rangedUnit, BWAPI::Unit target)
+{
+	int priority = getAttackPriority(rangedUnit, target);     // 0..12
+	int range = targetMatrix().getDistance(rangedUnit, target);           // 0..map size in pixels
+	int toGoal = target->getDistance(order.getPosition());  // 0..map size in pixels
 
-		if (range >= 12 * 32)
-		{
-			continue;
-		}
+	if (range >= 12 * 32)
+	{
+		return TargetAssignment::NoTarget;
+	}
 
-		// Let's say that 1 priority step is worth 160 pixels (5 tiles).
-		// We care about unit-target range and target-order position distance.
-		int score = 5 * 32 * priority - range - toGoal / 2;
+	// Let's say that 1 priority step is worth 160 pixels (5 tiles).
+	// We care about unit-target range and target-order position distance.
+	int score = 5 * 32 * priority - range - toGoal / 2;
 
-		// Adjust for special features.
-		// This could adjust for relative speed and direction, so that we don't chase what we can't catch.
-		//⹦ܡ
-		//ԵԵٶȺͷ, ǲ׷ʲô, ǲܸϡ
+	// Adjust for special features.
+	// This could adjust for relative speed and direction, so that we don't chase what we can't catch.
+	//⹦ܡ
+	//ԵԵٶȺͷ, ǲ׷ʲô, ǲܸϡ
 
-		if (!target->canAttack()) {
-			score -= 4 * 32;
-		}
+	if (!target->canAttack()) {
+		score -= 4 * 32;
+	}
 
-		if (rangedUnit->isInWeaponRange(target))
-		{
-			score += 4 * 32;
-		}
-		else if (!target->isMoving())
-		{
-			if (target->isSieged() ||
-				target->getOrder() == BWAPI::Orders::Sieging ||
-				target->getOrder() == BWAPI::Orders::Unsieging)
-			{
-				score += 48;
-			}
-			else
-			{
-				score += 24;
-			}
-		}
-		else if (target->isBraking())
+	if (targetMatrix().isInWeaponRange(rangedUnit, target))
+	{
+		score += 4 * 32;
+	}
+	else if (!target->isMoving())
+	{
+		if (target->isSieged() ||
+			target->getOrder() == BWAPI::Orders::Sieging ||
+			target->getOrder() == BWAPI::Orders::Unsieging)
 		{
-			score += 16;
+			score += 48;
 		}
-		else if (target->getType().topSpeed() >= rangedUnit->getType().topSpeed())
+		else
 		{
-			score -= 5 * 32;
+			score += 24;
 		}
+	}
+	else if (target->isBraking())
+	{
+		score += 16;
+	}
+	else if (target->getType().topSpeed() >= rangedUnit->getType().topSpeed())
+	{
+		score -= 5 * 32;
+	}
 
-		if (target->canBurrow()) {
-			if (target->isBurrowed()) {
-				score -= 48;
-			}
-			else {
-				score += 48;
-			}
+	if (target->canBurrow()) {
+		if (target->isBurrowed()) {
+			score -= 48;
 		}
-
-		// Prefer targets that are already hurt.
-		if (target->getType().getRace() == BWAPI::Races::Protoss && target->getShields() <= 5)
-		{
-			score += 32;
+		else {
+			score += 48;
 		}
+	}
 
-		if (target->getHitPoints() < target->getType().maxHitPoints() && target->getHitPoints() > 0 && target->getType().maxHitPoints() > 0)
-		{
-			int hit = (target->getHitPoints() / target->getType().maxHitPoints());
-			if (hit > 0) {
-				score += 20 / hit;
-			}
-		}
+	// Prefer targets that are already hurt.
+	if (target->getType().getRace() == BWAPI::Races::Protoss && target->getShields() <= 5)
+	{
+		score += 32;
+	}
 
-		// Prefer to hit air units that have acid spores on them from devourers.
-		//ϲʳϻӵĿλ
-		if (target->getAcidSporeCount() > 0)
-		{
-			// Especially if we're a mutalisk with a bounce attack.
-			//رһĹ
-			if (rangedUnit->getType() == BWAPI::UnitTypes::Zerg_Mutalisk)
-			{
-				score += 16 * target->getAcidSporeCount();
-			}
-			else
-			{
-				score += 8 * target->getAcidSporeCount();
-			}
+	if (target->getHitPoints() < target->getType().maxHitPoints() && target->getHitPoints() > 0 && target->getType().maxHitPoints() > 0)
+	{
+		int hit = (target->getHitPoints() / target->getType().maxHitPoints());
+		if (hit > 0) {
+			score += 20 / hit;
 		}
+	}
 
-		BWAPI::DamageType damage = UnitUtil::GetWeapon(rangedUnit, target).damageType();
-		if (damage == BWAPI::DamageTypes::Explosive)
+	// Prefer to hit air units that have acid spores on them from devourers.
+	//ϲʳϻӵĿλ
+	if (target->getAcidSporeCount() > 0)
+	{
+		// Especially if we're a mutalisk with a bounce attack.
+		//رһĹ
+		if (rangedUnit->getType() == BWAPI::UnitTypes::Zerg_Mutalisk)
 		{
-			if (target->getType().size() == BWAPI::UnitSizeTypes::Large)
-			{
-				score += 32;
-			}
+			score += 16 * target->getAcidSporeCount();
 		}
-		else if (damage == BWAPI::DamageTypes::Concussive)
+		else
 		{
-			if (target->getType().size() == BWAPI::UnitSizeTypes::Small)
-			{
-				score += 32;
-			}
+			score += 8 * target->getAcidSporeCount();
 		}
+	}
 
-		score = getMarkTargetScore(target, score);
-
-		if (score > bestScore)
+	BWAPI::DamageType damage = UnitUtil::GetWeapon(rangedUnit, target).damageType();
+	if (damage == BWAPI::DamageTypes::Explosive)
+	{
+		if (target->getType().size() == BWAPI::UnitSizeTypes::Large)
 		{
-			bestScore = score;
-			bestTarget = target;
-
-			bestPriority = priority;
+			score += 32;
 		}
 	}
-
-	if (bestTarget) {
-		InformationManager::Instance().setAttackDamages(bestTarget, BWAPI::Broodwar->getDamageFrom(BWAPI::UnitTypes::Protoss_Interceptor, bestTarget->getType()) * rangedUnit->getInterceptorCount());
-		InformationManager::Instance().setAttackNumbers(bestTarget, 1);
+	else if (damage == BWAPI::DamageTypes::Concussive)
+	{
+		if (target->getType().size() == BWAPI::UnitSizeTypes::Small)
+		{
+			score += 32;
+		}
 	}
 
-	return bestTarget;
+	return score;
 }
 
 // get the attack priority of a target unit
@@ -303,7 +313,7 @@ int MicroCarriers::getAttackPriority(BWAPI::Unit rangedUnit, BWAPI::Unit target)
 	if (UnitUtil::CanAttack(targetType, rangedType) && !targetType.isWorker())
 	{
 		// Enemy unit which is far enough outside its range is lower priority than a worker.
-		if (rangedUnit->getDistance(target) > 48 + UnitUtil::GetAttackRange(target, rangedUnit))
+		if (targetMatrix().getDistance(rangedUnit, target) > 48 + targetMatrix().getAttackRange(target, rangedUnit))
 		{
 			return 8;
 		}
@@ -14,7 +14,8 @@ public:
 	void executeMicro(const BWAPI::Unitset & targets);
 
 	int getAttackPriority(BWAPI::Unit rangedUnit, BWAPI::Unit target);
-	BWAPI::Unit getTarget(BWAPI::Unit rangedUnit, const BWAPI::Unitset & targets);
+	int getTargetScore(BWAPI::Unit rangedUnit, BWAPI::Unit target);
+	BWAPI::Unit getTarget(BWAPI::Unit rangedUnit);
 
 	bool stayHomeUntilReady(const BWAPI::Unit u) const;
 };
@@ -112,7 +112,7 @@ BWAPI::Unit MicroDarkTemplar::getTarget(BWAPI::Unit meleeUnit, const BWAPI::Unit
 	for (const auto target : targets)
 	{
 		const int priority = getAttackPriority(meleeUnit, target);		// 0..12
-		const int range = meleeUnit->getDistance(target);				// 0..map size in pixels
+		const int range = targetMatrix().getDistance(meleeUnit, target);	// 0..map size in pixels
 		int toGoal = target->getDistance(order.getPosition());  // 0..map size in pixels
 		const int closerToGoal =										// positive if target is closer than us to the goal
 			meleeUnit->getDistance(order.getPosition()) - target->getDistance(order.getPosition());
@@ -145,7 +145,7 @@ BWAPI::Unit MicroDarkTemplar::getTarget(BWAPI::Unit meleeUnit, const BWAPI::Unit
 		}
 
 		// This could adjust for relative speed and direction, so that we don't chase what we can't catch.
-		if (meleeUnit->isInWeaponRange(target))
+		if (targetMatrix().isInWeaponRange(meleeUnit, target))
 		{
 			if (meleeUnit->getType() == BWAPI::UnitTypes::Zerg_Ultralisk || meleeUnit->getType() == BWAPI::UnitTypes::Terran_Vulture_Spider_Mine)
 			{
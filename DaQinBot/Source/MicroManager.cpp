@@ -9,6 +9,7 @@
 using namespace UAlbertaBot;
 
 MicroManager::MicroManager() 
+	: _targetMatrix(nullptr)
 {
 }
 
@@ -41,6 +42,20 @@ void MicroManager::setOrder(const SquadOrder & inputOrder)
 	order = inputOrder;
 }
 
+// The squad owns the matrix and rebuilds it each frame before executing micro.
+void MicroManager::setTargetMatrix(const UnitTargetMatrix * matrix)
+{
+	_targetMatrix = matrix;
+}
+
+// Unit/target distances and ranges. If the squad has not provided a matrix,
+// an empty one answers every query directly from BWAPI.
+const UnitTargetMatrix & MicroManager::targetMatrix() const
+{
+	static const UnitTargetMatrix empty;
+	return _targetMatrix ? *_targetMatrix : empty;
+}
+
 void MicroManager::execute()
 {
 	// Nothing to do if we have no units.
@@ -152,7 +167,7 @@ bool MicroManager::shouldIgnoreTarget(BWAPI::Unit combatUnit, BWAPI::Unit target
             else
             {
                 int bunkerRange = InformationManager::Instance().enemyHasInfantryRangeUpgrade() ? 6 * 32 : 5 * 32;
-                int ourRange = std::max(0, UnitUtil::GetAttackRange(combatUnit, target) - 64); // be pessimistic and subtract two tiles
+                int ourRange = std::max(0, targetMatrix().getAttackRange(combatUnit, target) - 64); // be pessimistic and subtract two tiles
                 if (target->getDistance(solitaryBunker) < (bunkerRange - ourRange + 32)) return true;
             }
         }
@@ -479,52 +494,6 @@ BWAPI::Position MicroManager::cutFleeFrom(BWAPI::Unit unit, BWAPI::Position posi
 	return orderTargetPosition;
 }
 
-//ȡǷ
-int	MicroManager::getMarkTargetScore(BWAPI::Unit target, int score){
-	/*
-	int num = 2;
-	if (target->getType().size() == BWAPI::UnitSizeTypes::Small)
-	{
-		num = 4;
-	}
-	else if (target->getType().size() == BWAPI::UnitSizeTypes::Medium)
-	{
-		num = 6;
-	}
-	else if (target->getType().size() == BWAPI::UnitSizeTypes::Large)
-	{
-		num = 8;
-	}
-	else {
-		num = 10;
-	}
-
-	if (InformationManager::Instance().getAttackNumbers(target) < num) {
-		score += 1 * 32;
-	}
-	else {
-		score = 2 * 32;
-	}
-
-	if (InformationManager::Instance().getAttackDamages(target) > (target->getHitPoints() + target->getShields())) {
-		score = 32;
-	}
-	else 
-	*/
-
-	if (InformationManager::Instance().getAttackDamages(target) > (target->getHitPoints() + target->getShields()) * 0.3) {
-		score += 2 * 32;
-	}
-
-	return score;
-}
-
-//ǹλ˺
-void MicroManager::setMarkTargetScore(BWAPI::Unit target, BWAPI::UnitType unitType) {
-	InformationManager::Instance().setAttackDamages(target, BWAPI::Broodwar->getDamageFrom(unitType, target->getType()));
-	InformationManager::Instance().setAttackNumbers(target, 1);
-}
-
 void MicroManager::drawOrderText() 
 {
 	if (Config::Debug::DrawUnitTargetInfo)
@@ -5,6 +5,8 @@
 #include "SquadOrder.h"
 #include "InformationManager.h"
 #include "Micro.h"
+#include "UnitTargetMatrix.h"
+#include "TargetAssignment.h"
 
 namespace UAlbertaBot
 {
@@ -12,10 +14,14 @@ namespace UAlbertaBot
 class MicroManager
 {
 	BWAPI::Unitset		_units;
+	const UnitTargetMatrix * _targetMatrix;
 
 protected:
 	
 	SquadOrder			order;
+	TargetAssignment	_targetAssignment;
+
+	const UnitTargetMatrix & targetMatrix() const;
 
 	virtual void        executeMicro(const BWAPI::Unitset & targets) = 0;
 	virtual void		getTargets(BWAPI::Unitset & targets) const;
@@ -38,9 +44,6 @@ protected:
 
 	void                drawOrderText();
 
-	int					getMarkTargetScore(BWAPI::Unit target, int score);
-	void				setMarkTargetScore(BWAPI::Unit target, BWAPI::UnitType unitType);
-
 	struct CompareTiles {
 		bool operator() (const std::pair<BWAPI::TilePosition, double>& lhs, const std::pair<BWAPI::TilePosition, double>& rhs) const {
 			return lhs.second < rhs.second;
@@ -69,6 +72,7 @@ public:
 
 	void				setUnits(const BWAPI::Unitset & u);
 	void				setOrder(const SquadOrder & inputOrder);
+	void				setTargetMatrix(const UnitTargetMatrix * matrix);
 	void				execute();
 	void				regroup(const BWAPI::Position & regroupPosition, const BWAPI::Unit vanguard, std::map<BWAPI::Unit, bool> & nearEnemy) const;
 
@@ -65,6 +65,9 @@ void MicroMelee::assignTargets(const BWAPI::Unitset & targets)
 		}
 	}
 
+	// Units that won't attack this frame get their orders first, so that they don't use up
+	// the damage budget of a target that other units could attack.
+	BWAPI::Unitset attackers;
 	for (const auto meleeUnit : meleeUnits)
 	{
 		if (meleeUnit->isBurrowed())
@@ -109,38 +112,8 @@ void MicroMelee::assignTargets(const BWAPI::Unitset & targets)
             }
 			else
 			{
-				BWAPI::Unit target = getTarget(meleeUnit, meleeUnitTargets);
-				if (target)
-				{
-                    // Bunkers are handled by a special micro manager
-                    if (target->getType() == BWAPI::UnitTypes::Terran_Bunker &&
-                        target->isCompleted())
-                    {
-                        squad.addUnitToBunkerAttackSquad(target->getPosition(), meleeUnit);
-                    }
-                    else
-                        Micro::AttackUnit(meleeUnit, target);
-				}
-                // There are no targets. Move to the order position if not already close.
-                else if (meleeUnit->getDistance(order.getPosition()) > 96)
-				{
-                    // If this unit is doing a bunker run-by, get the position it should move towards
-                    auto bunkerRunBySquad = squad.getBunkerRunBySquad(meleeUnit);
-                    if (bunkerRunBySquad)
-                    {
-                        InformationManager::Instance().getLocutusUnit(meleeUnit)
-                            .moveTo(bunkerRunBySquad->getRunByPosition(meleeUnit, order.getPosition()));
-                    }
-
-                    // Otherwise, maybe add it to a bunker attack squad
-                    else if (!StrategyManager::Instance().isRushing() ||
-                        order.getType() == SquadOrderTypes::KamikazeAttack ||
-                        !squad.addUnitToBunkerAttackSquadIfClose(meleeUnit))
-                    {
-                        // Neither are appropriate, move towards the order position
-                        InformationManager::Instance().getLocutusUnit(meleeUnit).moveTo(order.getPosition(), order.getType() == SquadOrderTypes::Attack);
-                    }
-				}
+				attackers.insert(meleeUnit);
+				continue;
 			}
 		}
 
@@ -150,170 +123,218 @@ void MicroMelee::assignTargets(const BWAPI::Unitset & targets)
 				Config::Debug::ColorLineTarget);
 		}
 	}
-}
 
-// Choose a target from the set. Never return null!
-BWAPI::Unit MicroMelee::getTarget(BWAPI::Unit meleeUnit, const BWAPI::Unitset & targets)
-{
-	int bestScore = -999999;
-	BWAPI::Unit bestTarget = nullptr;
+	// Score every attacker against every target in one pass, then share out the targets.
+	// Targets the unit should ignore are not scored, so they are never assigned.
+	const BWEM::Area * orderPositionArea = bwemMap.GetArea(BWAPI::TilePosition(order.getPosition()));
+	_targetAssignment.reset(attackers, meleeUnitTargets);
+	for (size_t i = 0; i < _targetAssignment.getUnits().size(); ++i)
+	{
+		const BWAPI::Unit meleeUnit = _targetAssignment.getUnits()[i];
+		BWAPI::Position myPositionInFiveFrames = InformationManager::Instance().predictUnitPosition(meleeUnit, 5);
+		bool inOrderPositionArea = bwemMap.GetArea(meleeUnit->getTilePosition()) == orderPositionArea;
 
-    BWAPI::Position myPositionInFiveFrames = InformationManager::Instance().predictUnitPosition(meleeUnit, 5);
-    bool inOrderPositionArea = bwemMap.GetArea(meleeUnit->getTilePosition()) == bwemMap.GetArea(BWAPI::TilePosition(order.getPosition()));
+		int * scores = _targetAssignment.scoreRow(i);
+		for (size_t j = 0; j < _targetAssignment.getTargets().size(); ++j)
+		{
+			const BWAPI::Unit target = _targetAssignment.getTargets()[j];
+			const int score = getTargetScore(meleeUnit, target, myPositionInFiveFrames, inOrderPositionArea);
+			scores[j] = score == TargetAssignment::NoTarget || shouldIgnoreTarget(meleeUnit, target) ? TargetAssignment::NoTarget : score;
+		}
+	}
+	_targetAssignment.assign();
 
-	for (const auto target : targets)
+	for (const auto meleeUnit : attackers)
 	{
-		const int priority = getAttackPriority(meleeUnit, target);		// 0..12
-		const int range = meleeUnit->getDistance(target);				// 0..map size in pixels
-		const int closerToGoal =										// positive if target is closer than us to the goal
-			meleeUnit->getDistance(order.getPosition()) - target->getDistance(order.getPosition());
+		BWAPI::Unit target = getTarget(meleeUnit);
+		if (target)
+		{
+            // Bunkers are handled by a special micro manager
+            if (target->getType() == BWAPI::UnitTypes::Terran_Bunker &&
+                target->isCompleted())
+            {
+                squad.addUnitToBunkerAttackSquad(target->getPosition(), meleeUnit);
+            }
+            else
+                Micro::AttackUnit(meleeUnit, target);
+		}
+        // There are no targets. Move to the order position if not already close.
+        else if (meleeUnit->getDistance(order.getPosition()) > 96)
+		{
+            // If this unit is doing a bunker run-by, get the position it should move towards
+            auto bunkerRunBySquad = squad.getBunkerRunBySquad(meleeUnit);
+            if (bunkerRunBySquad)
+            {
+                InformationManager::Instance().getLocutusUnit(meleeUnit)
+                    .moveTo(bunkerRunBySquad->getRunByPosition(meleeUnit, order.getPosition()));
+            }
 
-		// Skip targets that are too far away to worry about.
-		if (range >= 12 * 32)
+            // Otherwise, maybe add it to a bunker attack squad
+            else if (!StrategyManager::Instance().isRushing() ||
+                order.getType() == SquadOrderTypes::KamikazeAttack ||
+                !squad.addUnitToBunkerAttackSquadIfClose(meleeUnit))
+            {
+                // Neither are appropriate, move towards the order position
+                InformationManager::Instance().getLocutusUnit(meleeUnit).moveTo(order.getPosition(), order.getType() == SquadOrderTypes::Attack);
+            }
+		}
+
+		if (Config::Debug::DrawUnitTargetInfo)
 		{
-			continue;
+			BWAPI::Broodwar->drawLineMap(meleeUnit->getPosition(), meleeUnit->getTargetPosition(),
+				Config::Debug::ColorLineTarget);
 		}
+	}
+}
 
-		// Let's say that 1 priority step is worth 64 pixels (2 tiles).
-		// We care about unit-target range and target-order position distance.
-		int score = 2 * 32 * priority - range;
+// The assigned target, or null if there is none the unit should attack.
+BWAPI::Unit MicroMelee::getTarget(BWAPI::Unit meleeUnit)
+{
+	return _targetAssignment.getTarget(meleeUnit);
+}
 
-        // Kamikaze and rush attacks ignore all tier 2+ combat units
-        if ((StrategyManager::Instance().isRushing() || order.getType() == SquadOrderTypes::KamikazeAttack) &&
-            UnitUtil::IsCombatUnit(target) && 
-            !UnitUtil::IsTierOneCombatUnit(target->getType())
-            && !target->getType().isWorker())
-        {
-            continue;
-        }
+// Score the target for the unit, or TargetAssignment::NoTarget if the unit should not consider it.
+int MicroMelee::getTargetScore(BWAPI::Unit meleeUnit, BWAPI::Unit target,
+	BWAPI::Position myPositionInFiveFrames, bool inOrderPositionArea)
+{
+	const int priority = getAttackPriority(meleeUnit, target);		// 0..12
+	const int range = targetMatrix().getDistance(meleeUnit, target);				// 0..map size in pixels
+	const int closerToGoal =										// positive if target is closer than us to the goal
+		meleeUnit->getDistance(order.getPosition()) - target->getDistance(order.getPosition());
 
-        // Consider whether to attack enemies that are outside of our weapon range when on the attack
-        bool inWeaponRange = meleeUnit->isInWeaponRange(target);
-        if (!inWeaponRange && order.getType() != SquadOrderTypes::Defend)
-        {
-            // Never chase units that can kite us easily
-            if (target->getType() == BWAPI::UnitTypes::Protoss_Dragoon ||
-                target->getType() == BWAPI::UnitTypes::Terran_Vulture) continue;
-
-            // Check if the target is moving away from us
-            BWAPI::Position targetPositionInFiveFrames = InformationManager::Instance().predictUnitPosition(target, 5);
-            if (target->isMoving() && 
-                range <= MathUtil::EdgeToEdgeDistance(meleeUnit->getType(), myPositionInFiveFrames, target->getType(), targetPositionInFiveFrames))
-            {
-                // Never chase workers
-                if (target->getType().isWorker()) continue;
+	// Skip targets that are too far away to worry about.
+	if (range >= 12 * 32)
+	{
+		return TargetAssignment::NoTarget;
+	}
 
-                // When rushing, don't chase anything when outside the order position area
-                if (StrategyManager::Instance().isRushing() && !inOrderPositionArea) continue;
-            }
+	// Let's say that 1 priority step is worth 64 pixels (2 tiles).
+	// We care about unit-target range and target-order position distance.
+	int score = 2 * 32 * priority - range;
 
-            // Skip targets behind a wall
-            if (InformationManager::Instance().isBehindEnemyWall(meleeUnit, target)) continue;
-        }
+    // Kamikaze and rush attacks ignore all tier 2+ combat units
+    if ((StrategyManager::Instance().isRushing() || order.getType() == SquadOrderTypes::KamikazeAttack) &&
+        UnitUtil::IsCombatUnit(target) && 
+        !UnitUtil::IsTierOneCombatUnit(target->getType())
+        && !target->getType().isWorker())
+    {
+        return TargetAssignment::NoTarget;
+    }
 
-        // When rushing, prioritize workers that are building something
-        if (StrategyManager::Instance().isRushing() && target->getType().isWorker() && target->isConstructing())
+    // Consider whether to attack enemies that are outside of our weapon range when on the attack
+    bool inWeaponRange = targetMatrix().isInWeaponRange(meleeUnit, target);
+    if (!inWeaponRange && order.getType() != SquadOrderTypes::Defend)
+    {
+        // Never chase units that can kite us easily
+        if (target->getType() == BWAPI::UnitTypes::Protoss_Dragoon ||
+            target->getType() == BWAPI::UnitTypes::Terran_Vulture) return TargetAssignment::NoTarget;
+
+        // Check if the target is moving away from us
+        BWAPI::Position targetPositionInFiveFrames = InformationManager::Instance().predictUnitPosition(target, 5);
+        if (target->isMoving() && 
+            range <= MathUtil::EdgeToEdgeDistance(meleeUnit->getType(), myPositionInFiveFrames, target->getType(), targetPositionInFiveFrames))
         {
-            score += 4 * 32;
+            // Never chase workers
+            if (target->getType().isWorker()) return TargetAssignment::NoTarget;
+
+            // When rushing, don't chase anything when outside the order position area
+            if (StrategyManager::Instance().isRushing() && !inOrderPositionArea) return TargetAssignment::NoTarget;
         }
 
-		// Adjust for special features.
+        // Skip targets behind a wall
+        if (InformationManager::Instance().isBehindEnemyWall(meleeUnit, target)) return TargetAssignment::NoTarget;
+    }
 
-		// Prefer targets under dark swarm, on the expectation that then we'll be under it too.
-		if (target->isUnderDarkSwarm())
-		{
-			if (meleeUnit->getType().isWorker())
-			{
-				// Workers can't hit under dark swarm. Skip this target.
-				continue;
-			}
-			score += 4 * 32;
-		}
+    // When rushing, prioritize workers that are building something
+    if (StrategyManager::Instance().isRushing() && target->getType().isWorker() && target->isConstructing())
+    {
+        score += 4 * 32;
+    }
 
-		// A bonus for attacking enemies that are "in front".
-		// It helps reduce distractions from moving toward the goal, the order position.
-		if (closerToGoal > 0)
-		{
-			score += 2 * 32;
-		}
+	// Adjust for special features.
 
-		// This could adjust for relative speed and direction, so that we don't chase what we can't catch.
-		if (inWeaponRange)
-		{
-			if (meleeUnit->getType() == BWAPI::UnitTypes::Zerg_Ultralisk)
-			{
-				score += 12 * 32;   // because they're big and awkward
-			}
-			else
-			{
-				score += 4 * 32;
-			}
-		}
-		else if (!target->isMoving())
+	// Prefer targets under dark swarm, on the expectation that then we'll be under it too.
+	if (target->isUnderDarkSwarm())
+	{
+		if (meleeUnit->getType().isWorker())
 		{
-			if (target->isSieged() ||
-				target->getOrder() == BWAPI::Orders::Sieging ||
-				target->getOrder() == BWAPI::Orders::Unsieging)
-			{
-				score += 48;
-			}
-			else
-			{
-				score += 32;
-			}
+			// Workers can't hit under dark swarm. Skip this target.
+			return TargetAssignment::NoTarget;
 		}
-		else if (target->isBraking())
+		score += 4 * 32;
+	}
+
+	// A bonus for attacking enemies that are "in front".
+	// It helps reduce distractions from moving toward the goal, the order position.
+	if (closerToGoal > 0)
+	{
+		score += 2 * 32;
+	}
+
+	// This could adjust for relative speed and direction, so that we don't chase what we can't catch.
+	if (inWeaponRange)
+	{
+		if (meleeUnit->getType() == BWAPI::UnitTypes::Zerg_Ultralisk)
 		{
-			score += 16;
+			score += 12 * 32;   // because they're big and awkward
 		}
-		else if (target->getType().topSpeed() >= meleeUnit->getType().topSpeed())
+		else
 		{
-			score -= 2 * 32;
+			score += 4 * 32;
 		}
-
-		if (target->isUnderStorm())
+	}
+	else if (!target->isMoving())
+	{
+		if (target->isSieged() ||
+			target->getOrder() == BWAPI::Orders::Sieging ||
+			target->getOrder() == BWAPI::Orders::Unsieging)
 		{
-			score -= 4 * 32;
+			score += 48;
 		}
-
-		// Prefer targets that are already hurt.
-		if (target->getType().getRace() == BWAPI::Races::Protoss && target->getShields() <= 5)
+		else
 		{
 			score += 32;
-            if (target->getHitPoints() < (target->getType().maxHitPoints() / 3))
-            {
-                score += 24;
-            }
 		}
-		else if (target->getHitPoints() < target->getType().maxHitPoints())
-		{
-			score += 24;
-            if (target->getHitPoints() < (target->getType().maxHitPoints() / 3))
-            {
-                score += 24;
-            }
-        }
+	}
+	else if (target->isBraking())
+	{
+		score += 16;
+	}
+	else if (target->getType().topSpeed() >= meleeUnit->getType().topSpeed())
+	{
+		score -= 2 * 32;
+	}
+
+	if (target->isUnderStorm())
+	{
+		score -= 4 * 32;
+	}
 
-        // Avoid defensive matrix
-        if (target->isDefenseMatrixed())
+	// Prefer targets that are already hurt.
+	if (target->getType().getRace() == BWAPI::Races::Protoss && target->getShields() <= 5)
+	{
+		score += 32;
+        if (target->getHitPoints() < (target->getType().maxHitPoints() / 3))
         {
-            score -= 4 * 32;
+            score += 24;
         }
-
-		score = getMarkTargetScore(target, score);
-
-		if (score > bestScore)
-		{
-			bestScore = score;
-			bestTarget = target;
-		}
 	}
+	else if (target->getHitPoints() < target->getType().maxHitPoints())
+	{
+		score += 24;
+        if (target->getHitPoints() < (target->getType().maxHitPoints() / 3))
+        {
+            score += 24;
+        }
+    }
 
-	if (bestTarget) {
-		setMarkTargetScore(bestTarget, meleeUnit->getType());
-	}
+    // Avoid defensive matrix
+    if (target->isDefenseMatrixed())
+    {
+        score -= 4 * 32;
+    }
 
-	return shouldIgnoreTarget(meleeUnit, bestTarget) ? nullptr : bestTarget;
+	return score;
 }
 
 // get the attack priority of a type
@@ -344,10 +365,10 @@ int MicroMelee::getAttackPriority(BWAPI::Unit attacker, BWAPI::Unit target) cons
 	}
 
 	// Short circuit: Enemy unit which is far enough outside its range is lower priority than a worker.
-	int enemyRange = UnitUtil::GetAttackRange(target, attacker);
+	int enemyRange = targetMatrix().getAttackRange(target, attacker);
 	if (enemyRange &&
 		!targetType.isWorker() &&
-		attacker->getDistance(target) > 32 + enemyRange)
+		targetMatrix().getDistance(attacker, target) > 32 + enemyRange)
 	{
 		return 8;
 	}
@@ -454,7 +475,7 @@ bool MicroMelee::meleeUnitShouldRetreat(BWAPI::Unit meleeUnit, const BWAPI::Unit
 
 	BWAPI::Unit target = meleeUnit->getOrderTarget();
 	if (target && target->getType() != BWAPI::UnitTypes::Terran_Vulture_Spider_Mine  && meleeUnit->isUnderAttack() &&
-		meleeUnit->getDistance(target) < 2 * 32 &&
+		targetMatrix().getDistance(meleeUnit, target) < 2 * 32 &&
 		target->getType().groundWeapon().maxRange() <= 32 &&
 		meleeUnit->getUnitsInRadius(4 * 32, BWAPI::Filter::IsOwned &&
 		BWAPI::Filter::CanAttack).size() > 1 && !meleeUnit->isAttacking()) {
@@ -19,7 +19,8 @@ public:
 	void assignTargets(const BWAPI::Unitset & targets);
 
 	int getAttackPriority(BWAPI::Unit attacker, BWAPI::Unit unit) const;
-	BWAPI::Unit getTarget(BWAPI::Unit meleeUnit, const BWAPI::Unitset & targets);
+	int getTargetScore(BWAPI::Unit meleeUnit, BWAPI::Unit target, BWAPI::Position myPositionInFiveFrames, bool inOrderPositionArea);
+	BWAPI::Unit getTarget(BWAPI::Unit meleeUnit);
 	bool meleeUnitShouldRetreat(BWAPI::Unit meleeUnit, const BWAPI::Unitset & targets);
 };
 }
\ No newline at end of file
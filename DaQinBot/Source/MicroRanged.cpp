@@ -190,6 +190,9 @@ void MicroRanged::assignTargets(const BWAPI::Unitset & targets)
 		return;
 	}
 
+	// Units that won't attack this frame get their orders first, so that they don't use up
+	// the damage budget of a target that other units could attack.
+	BWAPI::Unitset attackers;
     for (const auto rangedUnit : rangedUnits)
 	{
 		if (buildScarabOrInterceptor(rangedUnit))
@@ -227,230 +230,233 @@ void MicroRanged::assignTargets(const BWAPI::Unitset & targets)
 			}
 		}
 
-		if (order.isCombatOrder())
-        {
-			if (unstickStuckUnit(rangedUnit))
+		if (order.isCombatOrder() && !unstickStuckUnit(rangedUnit))
+		{
+			attackers.insert(rangedUnit);
+		}
+	}
+
+	// Score every attacker against every target in one pass, then share out the targets.
+	// Targets that are not worth attacking or that the unit should ignore are not scored,
+	// so they are never assigned.
+	_targetAssignment.reset(attackers, rangedUnitTargets);
+	for (size_t i = 0; i < _targetAssignment.getUnits().size(); ++i)
+	{
+		const BWAPI::Unit rangedUnit = _targetAssignment.getUnits()[i];
+
+		int * scores = _targetAssignment.scoreRow(i);
+		for (size_t j = 0; j < _targetAssignment.getTargets().size(); ++j)
+		{
+			const BWAPI::Unit target = _targetAssignment.getTargets()[j];
+			const int score = getTargetScore(rangedUnit, target);
+			scores[j] = score > 0 && !shouldIgnoreTarget(rangedUnit, target) ? score : TargetAssignment::NoTarget;
+		}
+	}
+	_targetAssignment.assign();
+
+	for (const auto rangedUnit : attackers)
+	{
+		// If a target is found,
+		BWAPI::Unit target = getTarget(rangedUnit);
+		if (target)
+		{
+			if (Config::Debug::DrawUnitTargetInfo)
 			{
-				continue;
+				BWAPI::Broodwar->drawLineMap(rangedUnit->getPosition(), rangedUnit->getTargetPosition(), BWAPI::Colors::Purple);
 			}
 
-			// If a target is found,
-			BWAPI::Unit target = getTarget(rangedUnit, rangedUnitTargets);
-			if (target)
+			// attack it.
+            // Bunkers are handled by a special micro manager
+            if (target->getType() == BWAPI::UnitTypes::Terran_Bunker &&
+                target->isCompleted())
+            {
+                squad.addUnitToBunkerAttackSquad(target->getPosition(), rangedUnit);
+            }
+			else if (Config::Micro::KiteWithRangedUnits)
 			{
-				if (Config::Debug::DrawUnitTargetInfo)
-				{
-					BWAPI::Broodwar->drawLineMap(rangedUnit->getPosition(), rangedUnit->getTargetPosition(), BWAPI::Colors::Purple);
-				}
-
-				// attack it.
-                // Bunkers are handled by a special micro manager
-                if (target->getType() == BWAPI::UnitTypes::Terran_Bunker &&
-                    target->isCompleted())
-                {
-                    squad.addUnitToBunkerAttackSquad(target->getPosition(), rangedUnit);
-                }
-				else if (Config::Micro::KiteWithRangedUnits)
-				{
-					//kite(rangedUnit, target);
-					Micro::KiteTarget(rangedUnit, target);
-				}
-				else
-				{
-					Micro::AttackUnit(rangedUnit, target);
-				}
+				//kite(rangedUnit, target);
+				Micro::KiteTarget(rangedUnit, target);
 			}
 			else
 			{
-                // No target found. If we're not near the order position, go there.
-				if (rangedUnit->getDistance(order.getPosition()) > 100)
-				{
-                    // If this unit is doing a bunker run-by, get the position it should move towards
-                    auto bunkerRunBySquad = squad.getBunkerRunBySquad(rangedUnit);
-                    if (bunkerRunBySquad)
-                    {
-                        InformationManager::Instance().getLocutusUnit(rangedUnit)
-                            .moveTo(bunkerRunBySquad->getRunByPosition(rangedUnit, order.getPosition()));
-                    }
-                    else
-                    {
-                        InformationManager::Instance().getLocutusUnit(rangedUnit).moveTo(order.getPosition(), order.getType() == SquadOrderTypes::Attack);
-                    }
-				}
+				Micro::AttackUnit(rangedUnit, target);
+			}
+		}
+		else
+		{
+            // No target found. If we're not near the order position, go there.
+			if (rangedUnit->getDistance(order.getPosition()) > 100)
+			{
+                // If this unit is doing a bunker run-by, get the position it should move towards
+                auto bunkerRunBySquad = squad.getBunkerRunBySquad(rangedUnit);
+                if (bunkerRunBySquad)
+                {
+                    InformationManager::Instance().getLocutusUnit(rangedUnit)
+                        .moveTo(bunkerRunBySquad->getRunByPosition(rangedUnit, order.getPosition()));
+                }
+                else
+                {
+                    InformationManager::Instance().getLocutusUnit(rangedUnit).moveTo(order.getPosition(), order.getType() == SquadOrderTypes::Attack);
+                }
 			}
 		}
 	}
 }
 
 // This can return null if no target is worth attacking.
-BWAPI::Unit MicroRanged::getTarget(BWAPI::Unit rangedUnit, const BWAPI::Unitset & targets)
+BWAPI::Unit MicroRanged::getTarget(BWAPI::Unit rangedUnit)
 {
-	int bestScore = -999999;
-	BWAPI::Unit bestTarget = nullptr;
-	int bestPriority = -1;   // TODO debug only
+	return _targetAssignment.getTarget(rangedUnit);
+}
 
-	for (const auto target : targets)
+// Score the target for the unit, or TargetAssignment::NoTarget if the unit should not consider it.
+int MicroRanged::getTargetScore(BWAPI::Unit rangedUnit, BWAPI::Unit target)
+{
+	// Skip targets under dark swarm that we can't hit.
+	//޷еĻµĿꡣ
+	if (target->isUnderDarkSwarm() && !goodUnderDarkSwarm(rangedUnit->getType()))
 	{
-		// Skip targets under dark swarm that we can't hit.
-		//޷еĻµĿꡣ
-		if (target->isUnderDarkSwarm() && !goodUnderDarkSwarm(rangedUnit->getType()))
-		{
-			continue;
-		}
+		return TargetAssignment::NoTarget;
+	}
 
-		const int priority = getAttackPriority(rangedUnit, target);		// 0..12
-		const int range = rangedUnit->getDistance(target);				// 0..map diameter in pixels
-		const int closerToGoal =										// positive if target is closer than us to the goal
-			rangedUnit->getDistance(order.getPosition()) - target->getDistance(order.getPosition());
-		
-		// Skip targets that are too far away to worry about--outside tank range.
-		if (range >= 13 * 32)
-		{
-			continue;
-		}
+	const int priority = getAttackPriority(rangedUnit, target);		// 0..12
+	const int range = targetMatrix().getDistance(rangedUnit, target);				// 0..map diameter in pixels
+	const int closerToGoal =										// positive if target is closer than us to the goal
+		rangedUnit->getDistance(order.getPosition()) - target->getDistance(order.getPosition());
+	
+	// Skip targets that are too far away to worry about--outside tank range.
+	if (range >= 13 * 32)
+	{
+		return TargetAssignment::NoTarget;
+	}
 
-        // Skip targets safe behind a wall
-        if (range > UnitUtil::GetAttackRange(rangedUnit, target) &&
-            InformationManager::Instance().isBehindEnemyWall(rangedUnit, target))
-        {
-            continue;
-        }
+    // Skip targets safe behind a wall
+    if (range > targetMatrix().getAttackRange(rangedUnit, target) &&
+        InformationManager::Instance().isBehindEnemyWall(rangedUnit, target))
+    {
+        return TargetAssignment::NoTarget;
+    }
 
-		// Let's say that 1 priority step is worth 160 pixels (5 tiles).
-		// We care about unit-target range and target-order position distance.
-		int score = 5 * 32 * priority - range;
+	// Let's say that 1 priority step is worth 160 pixels (5 tiles).
+	// We care about unit-target range and target-order position distance.
+	int score = 5 * 32 * priority - range;
 
-		// Adjust for special features.
-		// A bonus for attacking enemies that are "in front".
-		// It helps reduce distractions from moving toward the goal, the order position.
-		if (closerToGoal > 0)
-		{
-			score += 2 * 32;
-		}
+	// Adjust for special features.
+	// A bonus for attacking enemies that are "in front".
+	// It helps reduce distractions from moving toward the goal, the order position.
+	if (closerToGoal > 0)
+	{
+		score += 2 * 32;
+	}
 
-		const bool isThreat = UnitUtil::CanAttack(target, rangedUnit);   // may include workers as threats
-		const bool canShootBack = isThreat && target->isInWeaponRange(rangedUnit);
+	const bool isThreat = targetMatrix().canAttack(target, rangedUnit);   // may include workers as threats
+	const bool canShootBack = isThreat && targetMatrix().isInWeaponRange(target, rangedUnit);
 
-		if (isThreat)
+	if (isThreat)
+	{
+		if (canShootBack)
 		{
-			if (canShootBack)
-			{
-				score += 6 * 32;
-			}
-			else if (rangedUnit->isInWeaponRange(target))
-			{
-				score += 4 * 32;
-			}
-			else
-			{
-				score += 3 * 32;
-			}
+			score += 6 * 32;
 		}
-		// This could adjust for relative speed and direction, so that we don't chase what we can't catch.
-		else if (!target->isMoving())
+		else if (targetMatrix().isInWeaponRange(rangedUnit, target))
 		{
-			if (target->isSieged() ||
-				target->getOrder() == BWAPI::Orders::Sieging ||
-				target->getOrder() == BWAPI::Orders::Unsieging)
-			{
-				score += 48;
-			}
-			else
-			{
-				score += 24;
-			}
+			score += 4 * 32;
 		}
-		else if (target->isBraking())
+		else
 		{
-			score += 16;
+			score += 3 * 32;
 		}
-		else if (target->getType().topSpeed() >= rangedUnit->getType().topSpeed())
+	}
+	// This could adjust for relative speed and direction, so that we don't chase what we can't catch.
+	else if (!target->isMoving())
+	{
+		if (target->isSieged() ||
+			target->getOrder() == BWAPI::Orders::Sieging ||
+			target->getOrder() == BWAPI::Orders::Unsieging)
 		{
-			score -= 4 * 32;
+			score += 48;
 		}
-		
-		// Prefer targets that are already hurt.
-        if (target->getType().getRace() == BWAPI::Races::Protoss && target->getShields() <= 5)
+		else
+		{
+			score += 24;
+		}
+	}
+	else if (target->isBraking())
+	{
+		score += 16;
+	}
+	else if (target->getType().topSpeed() >= rangedUnit->getType().topSpeed())
+	{
+		score -= 4 * 32;
+	}
+	
+	// Prefer targets that are already hurt.
+    if (target->getType().getRace() == BWAPI::Races::Protoss && target->getShields() <= 5)
+    {
+        score += 32;
+        if (target->getHitPoints() < (target->getType().maxHitPoints() / 3))
         {
-            score += 32;
-            if (target->getHitPoints() < (target->getType().maxHitPoints() / 3))
-            {
-                score += 24;
-            }
+            score += 24;
         }
-        else if (target->getHitPoints() < target->getType().maxHitPoints())
+    }
+    else if (target->getHitPoints() < target->getType().maxHitPoints())
+    {
+        score += 24;
+        if (target->getHitPoints() < (target->getType().maxHitPoints() / 3))
         {
             score += 24;
-            if (target->getHitPoints() < (target->getType().maxHitPoints() / 3))
-            {
-                score += 24;
-            }
         }
+    }
 
-        // Avoid defensive matrix
-        if (target->isDefenseMatrixed())
-        {
-            score -= 4 * 32;
-        }
+    // Avoid defensive matrix
+    if (target->isDefenseMatrixed())
+    {
+        score -= 4 * 32;
+    }
 
-		// Prefer to hit air units that have acid spores on them from devourers.
-		if (target->getAcidSporeCount() > 0)
+	// Prefer to hit air units that have acid spores on them from devourers.
+	if (target->getAcidSporeCount() > 0)
+	{
+		// Especially if we're a mutalisk with a bounce attack.
+		if (rangedUnit->getType() == BWAPI::UnitTypes::Zerg_Mutalisk)
 		{
-			// Especially if we're a mutalisk with a bounce attack.
-			if (rangedUnit->getType() == BWAPI::UnitTypes::Zerg_Mutalisk)
-			{
-				score += 16 * target->getAcidSporeCount();
-			}
-			else
-			{
-				score += 8 * target->getAcidSporeCount();
-			}
+			score += 16 * target->getAcidSporeCount();
 		}
+		else
+		{
+			score += 8 * target->getAcidSporeCount();
+		}
+	}
 
-		// Take the damage type into account.
-		BWAPI::DamageType damage = UnitUtil::GetWeapon(rangedUnit, target).damageType();
-		if (damage == BWAPI::DamageTypes::Explosive)
+	// Take the damage type into account.
+	BWAPI::DamageType damage = UnitUtil::GetWeapon(rangedUnit, target).damageType();
+	if (damage == BWAPI::DamageTypes::Explosive)
+	{
+		if (target->getType().size() == BWAPI::UnitSizeTypes::Large)
 		{
-			if (target->getType().size() == BWAPI::UnitSizeTypes::Large)
-			{
-				score += 32;
-			}
+			score += 32;
 		}
-		else if (damage == BWAPI::DamageTypes::Concussive)
+	}
+	else if (damage == BWAPI::DamageTypes::Concussive)
+	{
+		if (target->getType().size() == BWAPI::UnitSizeTypes::Small)
 		{
-			if (target->getType().size() == BWAPI::UnitSizeTypes::Small)
-			{
-				score += 32;
-			}
-			else if (target->getType().size() == BWAPI::UnitSizeTypes::Large)
-			{
-				score -= 32;
-			}
+			score += 32;
 		}
-
-        // For wall buildings, prefer the ones with lower health
-        if (InformationManager::Instance().isEnemyWallBuilding(target) &&
-            target->getType() == BWAPI::UnitTypes::Terran_Supply_Depot)
-        {
-            score += 128;
-        }
-
-		score = getMarkTargetScore(target, score);
-
-		if (score > bestScore)
+		else if (target->getType().size() == BWAPI::UnitSizeTypes::Large)
 		{
-			bestScore = score;
-			bestTarget = target;
-
-			bestPriority = priority;
+			score -= 32;
 		}
 	}
 
-	if (bestTarget) {
-		setMarkTargetScore(bestTarget, rangedUnit->getType());
-	}
+    // For wall buildings, prefer the ones with lower health
+    if (InformationManager::Instance().isEnemyWallBuilding(target) &&
+        target->getType() == BWAPI::UnitTypes::Terran_Supply_Depot)
+    {
+        score += 128;
+    }
 
-	return bestScore > 0 && !shouldIgnoreTarget(rangedUnit, bestTarget) ? bestTarget : nullptr;
+	return score;
 }
 
 // get the attack priority of a target unit
@@ -578,7 +584,7 @@ int MicroRanged::getAttackPriority(BWAPI::Unit rangedUnit, BWAPI::Unit target)
 	if (UnitUtil::CanAttack(targetType, rangedType) && !targetType.isWorker())
 	{
 		// Enemy unit which is far enough outside its range is lower priority than a worker.
-		if (rangedUnit->getDistance(target) > 48 + UnitUtil::GetAttackRange(target, rangedUnit))
+		if (targetMatrix().getDistance(rangedUnit, target) > 48 + targetMatrix().getAttackRange(target, rangedUnit))
 		{
 			return 8;
 		}
@@ -626,7 +632,7 @@ int MicroRanged::getAttackPriority(BWAPI::Unit rangedUnit, BWAPI::Unit target)
             }
         }
         // SCVs so close to the unit that they are likely to be attacking it are important
-        if (rangedUnit->getDistance(target) < 32)
+        if (targetMatrix().getDistance(rangedUnit, target) < 32)
         {
             return 10;
         }
@@ -728,7 +734,7 @@ void MicroRanged::kite(BWAPI::Unit rangedUnit, BWAPI::Unit target)
         range = 6 * 32;
     }
 
-    int distToTarget = rangedUnit->getDistance(target);
+    int distToTarget = targetMatrix().getDistance(rangedUnit, target);
 
     // If our weapon is ready to fire, attack
     int cooldown = rangedUnit->getGroundWeaponCooldown() - BWAPI::Broodwar->getRemainingLatencyFrames() - 2;
@@ -775,7 +781,7 @@ void MicroRanged::kite(BWAPI::Unit rangedUnit, BWAPI::Unit target)
     bool moveCloser =
         target->getType() == BWAPI::UnitTypes::Terran_Siege_Tank_Siege_Mode ||
         (target->isRepairing() && target->getOrderTarget() && target->getOrderTarget()->getType() == BWAPI::UnitTypes::Terran_Siege_Tank_Siege_Mode) ||
-        (target->getType().isBuilding() && !UnitUtil::CanAttack(target, rangedUnit));
+        (target->getType().isBuilding() && !targetMatrix().canAttack(target, rangedUnit));
 
     // Now check enemy unit movement
     if (!moveCloser)
@@ -23,6 +23,7 @@ public:
 	void assignTargets(const BWAPI::Unitset & targets);
 
 	int getAttackPriority(BWAPI::Unit rangedUnit, BWAPI::Unit target);
-	BWAPI::Unit getTarget(BWAPI::Unit rangedUnit, const BWAPI::Unitset & targets);
+	int getTargetScore(BWAPI::Unit rangedUnit, BWAPI::Unit target);
+	BWAPI::Unit getTarget(BWAPI::Unit rangedUnit);
 };
 }
\ No newline at end of file
@@ -0,0 +1,312 @@
+#include "Common.h"
+#include "NearestUnits.h"
+#include "PathFinding.h"
+
+using namespace UAlbertaBot;
+
+namespace
+{
+	// A bound on how far a unit's edge can be from its center, for pruning grid cells.
+	// Manhattan extent, so it is never less than the true corner distance.
+	int unitExtent(BWAPI::UnitType type)
+	{
+		return std::max(type.dimensionLeft(), type.dimensionRight()) + std::max(type.dimensionUp(), type.dimensionDown()) + 1;
+	}
+
+	// Insert into a list kept sorted by distance and capped at k entries.
+	void insertSorted(std::vector<NearestUnits::Neighbor> & list, size_t k, BWAPI::Unit unit, int dist)
+	{
+		if (list.size() == k && dist >= list.back().distance)
+		{
+			return;
+		}
+
+		auto it = list.end();
+		while (it != list.begin() && (it - 1)->distance > dist)
+		{
+			--it;
+		}
+		list.insert(it, NearestUnits::Neighbor(unit, dist));
+
+		if (list.size() > k)
+		{
+			list.pop_back();
+		}
+	}
+}
+
+NearestUnits::NearestUnits()
+	: _cols((BWAPI::Broodwar->mapWidth() * 32 + CellSize - 1) / CellSize)
+	, _rows((BWAPI::Broodwar->mapHeight() * 32 + CellSize - 1) / CellSize)
+	, _lastUpdated(-1)
+{
+}
+
+NearestUnits & NearestUnits::Instance()
+{
+	static NearestUnits instance;
+	return instance;
+}
+
+// Rebuild the grids if we have not done it yet this frame.
+void NearestUnits::update()
+{
+	if (_lastUpdated == BWAPI::Broodwar->getFrameCount())
+	{
+		return;
+	}
+	_lastUpdated = BWAPI::Broodwar->getFrameCount();
+
+	std::vector<BWAPI::Unit> units;
+
+	for (const auto unit : BWAPI::Broodwar->self()->getUnits())
+	{
+		if (unit->getPosition().isValid())
+		{
+			units.push_back(unit);
+		}
+	}
+	fillGrid(_ourGrid, units);
+
+	units.clear();
+	for (const auto unit : BWAPI::Broodwar->enemy()->getUnits())
+	{
+		if (unit->exists() &&
+			unit->getType() != BWAPI::UnitTypes::Unknown &&
+			unit->getPosition().isValid())
+		{
+			units.push_back(unit);
+		}
+	}
+	fillGrid(_oppGrid, units);
+}
+
+// Counting sort of the units by cell, so that each cell's units are contiguous.
+void NearestUnits::fillGrid(Grid & grid, const std::vector<BWAPI::Unit> & units)
+{
+	grid.cellStart.assign(_cols * _rows + 1, 0);
+	grid.entries.resize(units.size());
+	grid.maxExtent = 0;
+
+	std::vector<int> cellOf(units.size());
+	for (size_t i = 0; i < units.size(); ++i)
+	{
+		BWAPI::Position pos = units[i]->getPosition();
+		cellOf[i] = std::min(pos.y / CellSize, _rows - 1) * _cols + std::min(pos.x / CellSize, _cols - 1);
+		++grid.cellStart[cellOf[i] + 1];
+		grid.maxExtent = std::max(grid.maxExtent, unitExtent(units[i]->getType()));
+	}
+
+	for (size_t c = 1; c < grid.cellStart.size(); ++c)
+	{
+		grid.cellStart[c] += grid.cellStart[c - 1];
+	}
+
+	std::vector<int> next(grid.cellStart.begin(), grid.cellStart.end() - 1);
+	for (size_t i = 0; i < units.size(); ++i)
+	{
+		Entry & entry = grid.entries[next[cellOf[i]]++];
+		entry.unit = units[i];
+		entry.pos = units[i]->getPosition();
+	}
+}
+
+// Grid search by air distance. Visit the cells in square rings around the origin,
+// and stop as soon as no unit in the next ring can be closer than the k-th best so far.
+void NearestUnits::airNearest(
+	std::vector<Neighbor> & result,
+	BWAPI::Position origin, BWAPI::Unit target, size_t k,
+	bool ourUnits, bool oppUnits,
+	const Filter & filter, int maxDist, const Adjust & adjust)
+{
+	result.clear();
+
+	if (k == 0 || !origin.isValid())
+	{
+		return;
+	}
+
+	update();
+
+	std::vector<const Grid *> grids;
+	int maxExtent = 0;
+	if (ourUnits)
+	{
+		grids.push_back(&_ourGrid);
+		maxExtent = std::max(maxExtent, _ourGrid.maxExtent);
+	}
+	if (oppUnits)
+	{
+		grids.push_back(&_oppGrid);
+		maxExtent = std::max(maxExtent, _oppGrid.maxExtent);
+	}
+	if (target)
+	{
+		maxExtent += unitExtent(target->getType());
+	}
+
+	const int cx = std::min(origin.x / CellSize, _cols - 1);
+	const int cy = std::min(origin.y / CellSize, _rows - 1);
+	const int maxRing = std::max(std::max(cx, _cols - 1 - cx), std::max(cy, _rows - 1 - cy));
+
+	auto visitCell = [&](int x, int y)
+	{
+		if (x < 0 || y < 0 || x >= _cols || y >= _rows)
+		{
+			return;
+		}
+
+		const int cell = y * _cols + x;
+		for (const Grid * grid : grids)
+		{
+			for (int i = grid->cellStart[cell]; i < grid->cellStart[cell + 1]; ++i)
+			{
+				BWAPI::Unit unit = grid->entries[i].unit;
+				if (unit == target || (filter && !filter(unit)))
+				{
+					continue;
+				}
+
+				int dist = target ? unit->getDistance(target) : unit->getDistance(origin);
+				if (adjust)
+				{
+					dist = adjust(unit, dist);
+				}
+				if (dist < maxDist)
+				{
+					insertSorted(result, k, unit, dist);
+				}
+			}
+		}
+	};
+
+	for (int ring = 0; ring <= maxRing; ++ring)
+	{
+		if (ring > 0)
+		{
+			// No unit centered in this ring can be nearer than this.
+			// BWAPI's approximate distance may come out up to about 9% short, hence the 7/8.
+			const int bound = ((ring - 1) * CellSize - maxExtent) * 7 / 8;
+			if (bound >= maxDist || (result.size() == k && bound > result.back().distance))
+			{
+				break;
+			}
+		}
+
+		if (ring == 0)
+		{
+			visitCell(cx, cy);
+			continue;
+		}
+
+		for (int x = cx - ring; x <= cx + ring; ++x)
+		{
+			visitCell(x, cy - ring);
+			visitCell(x, cy + ring);
+		}
+		for (int y = cy - ring + 1; y <= cy + ring - 1; ++y)
+		{
+			visitCell(cx - ring, y);
+			visitCell(cx + ring, y);
+		}
+	}
+}
+
+void NearestUnits::nearest(
+	std::vector<Neighbor> & result,
+	BWAPI::Position origin, BWAPI::Unit target, size_t k,
+	bool ourUnits, bool oppUnits,
+	const Filter & filter, Metric metric, int maxDist, const Adjust & adjust)
+{
+	if (metric == Metric::Air)
+	{
+		airNearest(result, origin, target, k, ourUnits, oppUnits, filter, maxDist, adjust);
+		return;
+	}
+
+	// Ground distance is expensive, so measure it only for the best air candidates.
+	// Ground distance is never much less than air distance, so once the k-th best ground distance
+	// is no farther than the worst air candidate, the remaining units cannot do better.
+	// Otherwise fetch more air candidates and try again.
+	std::vector<Neighbor> air;
+	std::vector<Neighbor> measured;      // ground distance of each candidate so far, -1 if unreachable
+	size_t n = std::max(k * 2, size_t(4));
+
+	for (;;)
+	{
+		airNearest(air, origin, target, n, ourUnits, oppUnits, filter, maxDist, nullptr);
+
+		for (const auto & candidate : air)
+		{
+			if (std::find_if(measured.begin(), measured.end(),
+				[&](const Neighbor & m) { return m.unit == candidate.unit; }) != measured.end())
+			{
+				continue;
+			}
+
+			int dist = PathFinding::GetGroundDistance(candidate.unit->getPosition(), origin);
+			if (dist >= 0 && adjust)
+			{
+				dist = adjust(candidate.unit, dist);
+			}
+			measured.push_back(Neighbor(candidate.unit, dist >= 0 && dist < maxDist ? dist : -1));
+		}
+
+		result.clear();
+		for (const auto & m : measured)
+		{
+			if (m.distance >= 0)
+			{
+				insertSorted(result, k, m.unit, m.distance);
+			}
+		}
+
+		if (air.size() < n ||
+			(result.size() == k && result.back().distance <= air.back().distance))
+		{
+			return;
+		}
+
+		n *= 2;
+	}
+}
+
+void NearestUnits::getNearest(
+	std::vector<Neighbor> & result,
+	BWAPI::Position pos, size_t k,
+	bool ourUnits, bool oppUnits,
+	const Filter & filter, Metric metric, int maxDist, const Adjust & adjust)
+{
+	nearest(result, pos, nullptr, k, ourUnits, oppUnits, filter, metric, maxDist, adjust);
+}
+
+void NearestUnits::getNearest(
+	std::vector<Neighbor> & result,
+	BWAPI::Unit target, size_t k,
+	bool ourUnits, bool oppUnits,
+	const Filter & filter, Metric metric, int maxDist, const Adjust & adjust)
+{
+	UAB_ASSERT(target, "Unit was null");
+
+	nearest(result, target->getPosition(), target, k, ourUnits, oppUnits, filter, metric, maxDist, adjust);
+}
+
+BWAPI::Unit NearestUnits::getClosest(
+	BWAPI::Position pos,
+	bool ourUnits, bool oppUnits,
+	const Filter & filter, Metric metric, int maxDist, const Adjust & adjust)
+{
+	std::vector<Neighbor> result;
+	getNearest(result, pos, 1, ourUnits, oppUnits, filter, metric, maxDist, adjust);
+	return result.empty() ? nullptr : result.front().unit;
+}
+
+BWAPI::Unit NearestUnits::getClosest(
+	BWAPI::Unit target,
+	bool ourUnits, bool oppUnits,
+	const Filter & filter, Metric metric, int maxDist, const Adjust & adjust)
+{
+	std::vector<Neighbor> result;
+	getNearest(result, target, 1, ourUnits, oppUnits, filter, metric, maxDist, adjust);
+	return result.empty() ? nullptr : result.front().unit;
+}
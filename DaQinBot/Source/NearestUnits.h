@@ -0,0 +1,107 @@
+#pragma once
+
+#include "Common.h"
+#include <functional>
+
+namespace UAlbertaBot
+{
+// Answers "which units are closest to here" queries for our units and the visible enemy units.
+// The unit positions are bucketed into a coarse grid, rebuilt lazily on the first query of each frame,
+// so a query only looks at the grid cells near the origin instead of looping over every unit.
+// Air distance is BWAPI's edge distance, the same as unit->getDistance().
+// Ground distance is computed only for the best air candidates, which are then re-ranked.
+class NearestUnits
+{
+public:
+
+	enum class Metric { Air, Ground };
+
+	struct Neighbor
+	{
+		BWAPI::Unit unit;
+		int         distance;
+
+		Neighbor(BWAPI::Unit u, int d) : unit(u), distance(d) {}
+	};
+
+	// Return true to accept the unit as a candidate.
+	typedef std::function<bool(BWAPI::Unit)> Filter;
+
+	// Given a unit and its distance, return the distance to rank it by.
+	// The result must not be less than the distance passed in, or the grid search may stop too early.
+	// Return INT_MAX to reject the unit.
+	typedef std::function<int(BWAPI::Unit, int)> Adjust;
+
+private:
+
+	static const int CellSize = 128;
+
+	struct Entry
+	{
+		BWAPI::Unit     unit;
+		BWAPI::Position pos;
+	};
+
+	// Units bucketed by grid cell: the units of cell i are entries[cellStart[i]] .. entries[cellStart[i+1]-1].
+	struct Grid
+	{
+		std::vector<int>   cellStart;
+		std::vector<Entry> entries;
+		int                maxExtent;       // largest center-to-corner extent of any unit in the grid
+	};
+
+	int     _cols;
+	int     _rows;
+	int     _lastUpdated;
+	Grid    _ourGrid;
+	Grid    _oppGrid;
+
+	NearestUnits();
+
+	void    update();
+	void    fillGrid(Grid & grid, const std::vector<BWAPI::Unit> & units);
+
+	void    airNearest(
+		std::vector<Neighbor> & result,
+		BWAPI::Position origin, BWAPI::Unit target, size_t k,
+		bool ourUnits, bool oppUnits,
+		const Filter & filter, int maxDist, const Adjust & adjust);
+
+	void    nearest(
+		std::vector<Neighbor> & result,
+		BWAPI::Position origin, BWAPI::Unit target, size_t k,
+		bool ourUnits, bool oppUnits,
+		const Filter & filter, Metric metric, int maxDist, const Adjust & adjust);
+
+public:
+
+	static NearestUnits & Instance();
+
+	// The k units closest to the position, closest first. Units at maxDist or beyond are ignored.
+	void    getNearest(
+		std::vector<Neighbor> & result,
+		BWAPI::Position pos, size_t k,
+		bool ourUnits, bool oppUnits,
+		const Filter & filter = nullptr, Metric metric = Metric::Air, int maxDist = INT_MAX, const Adjust & adjust = nullptr);
+
+	// The k units closest to the target unit, measured edge to edge for air distance.
+	// The target itself is never returned.
+	void    getNearest(
+		std::vector<Neighbor> & result,
+		BWAPI::Unit target, size_t k,
+		bool ourUnits, bool oppUnits,
+		const Filter & filter = nullptr, Metric metric = Metric::Air, int maxDist = INT_MAX, const Adjust & adjust = nullptr);
+
+	// The single closest unit, or nullptr if none qualifies.
+	BWAPI::Unit getClosest(
+		BWAPI::Position pos,
+		bool ourUnits, bool oppUnits,
+		const Filter & filter = nullptr, Metric metric = Metric::Air, int maxDist = INT_MAX, const Adjust & adjust = nullptr);
+
+	BWAPI::Unit getClosest(
+		BWAPI::Unit target,
+		bool ourUnits, bool oppUnits,
+		const Filter & filter = nullptr, Metric metric = Metric::Air, int maxDist = INT_MAX, const Adjust & adjust = nullptr);
+};
+
+}
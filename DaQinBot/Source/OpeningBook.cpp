@@ -0,0 +1,81 @@
+#include "OpeningBook.h"
+
+#include <regex>
+
+using namespace UAlbertaBot;
+
+int OpeningBook::intern(const std::string & item, int & count)
+{
+	// You can specify a count, like "6 x mutalisk". The spaces are required.
+	// Mostly useful for units, but "2 x creep colony @ natural" also works.
+	static const std::regex countRegex("([0-9]+)\\s+x\\s+([a-zA-Z_ ]+(\\s+@\\s+[a-zA-Z_ ]+)?)");
+
+	std::string itemName = item;
+	count = 1;
+
+	std::smatch m;
+	if (std::regex_match(item, m, countRegex))
+	{
+		count = GetIntFromString(m[1].str());
+		itemName = m[2].str();
+	}
+
+	auto it = _actIndex.find(itemName);
+	if (it != _actIndex.end())
+	{
+		return it->second;
+	}
+
+	MacroAct act(itemName);
+	int index = -1;
+	if (act.getRace() != BWAPI::Races::None || act.isCommand())
+	{
+		index = int(_acts.size());
+		_acts.push_back(act);
+	}
+
+	_actIndex[itemName] = index;
+	return index;
+}
+
+// An opening of the same name as an earlier one replaces it.
+void OpeningBook::addOpening(const std::string & name, const std::vector<int> & acts)
+{
+	for (int act : acts)
+	{
+		UAB_ASSERT(act >= 0 && act < int(_acts.size()), "bad opening act");
+	}
+
+	auto it = _openings.find(name);
+	if (it != _openings.end())
+	{
+		_openingActs[it->second] = acts;
+		return;
+	}
+
+	_openings[name] = int(_openingActs.size());
+	_openingActs.push_back(acts);
+}
+
+int OpeningBook::getOpening(const std::string & name) const
+{
+	auto it = _openings.find(name);
+	return it == _openings.end() ? -1 : it->second;
+}
+
+BuildOrder OpeningBook::getBuildOrder(int opening, BWAPI::Race race) const
+{
+	if (opening < 0 || opening >= int(_openingActs.size()))
+	{
+		return BuildOrder(race);
+	}
+
+	std::vector<MacroAct> acts;
+	acts.reserve(_openingActs[opening].size());
+	for (int act : _openingActs[opening])
+	{
+		acts.push_back(_acts[act]);
+	}
+
+	return BuildOrder(race, acts);
+}
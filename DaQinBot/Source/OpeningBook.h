@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Common.h"
+#include "BuildOrder.h"
+#include <unordered_map>
+
+namespace UAlbertaBot
+{
+// The opening build orders of the config, compiled once as the config is read.
+// Each distinct item string, like "pylon" or "gateway @ natural", is parsed into a MacroAct only once,
+// and an opening is just the indexes of its acts.
+class OpeningBook
+{
+	std::vector<MacroAct>					_acts;
+	std::unordered_map<std::string, int>	_actIndex;		// item string to index into _acts, -1 if it isn't an act
+	std::vector<std::vector<int>>			_openingActs;	// the acts of each opening
+	std::map<std::string, int>				_openings;		// name to index into _openingActs
+
+public:
+
+	// The act of a config item. "6 x zergling" sets count to 6, otherwise it is 1.
+	// Returns -1 if the item isn't an act.
+	int					intern(const std::string & item, int & count);
+
+	// The acts are indexes returned by intern().
+	void				addOpening(const std::string & name, const std::vector<int> & acts);
+
+	// The index of a named opening, -1 if the book doesn't have it.
+	int					getOpening(const std::string & name) const;
+
+	BuildOrder			getBuildOrder(int opening, BWAPI::Race race) const;
+};
+}
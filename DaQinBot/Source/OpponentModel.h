@@ -70,6 +70,7 @@ namespace UAlbertaBot
 		void predictEnemy(int lookaheadFrames, PlayerSnapshot & snap) const;
 
 		bool		getEnemySingleStrategy() const { return _singleStrategy; };
+		OpponentPlan & getPlanRecognizer() { return _planRecognizer; };
 		OpeningPlan getEnemyPlan() const;
 		std::string getEnemyPlanString() const;
 		OpeningPlan getInitialExpectedEnemyPlan() const { return _initialExpectedEnemyPlan; };
@@ -22,87 +22,145 @@ bool OpponentPlan::fastPlan(OpeningPlan plan)
 		plan == OpeningPlan::FastRush;
 }
 
-// NOTE Incomplete test! We don't measure the distance of enemy units from the enemy base,
-//      so we don't recognize all the rushes that we should.
-bool OpponentPlan::recognizeWorkerRush()
+// Whether the unit is counted, by the same rule as PlayerSnapshot::takeEnemy():
+// incomplete buildings are counted, other incomplete units are not.
+bool OpponentPlan::counted(BWAPI::UnitType type, bool completed) const
 {
-	BWAPI::Position myOrigin = InformationManager::Instance().getMyMainBaseLocation()->getPosition();
+	return
+		type != BWAPI::UnitTypes::None &&
+		!PlayerSnapshot::excludeType(type) &&
+		(type.isBuilding() || completed);
+}
 
-	int enemyWorkerRushCount = 0;
+int OpponentPlan::getCount(BWAPI::UnitType type) const
+{
+	auto it = _unitCounts.find(type);
+	return it == _unitCounts.end() ? 0 : it->second;
+}
 
-	for (const auto & kv : InformationManager::Instance().getUnitData(BWAPI::Broodwar->enemy()).getUnits())
+// The same estimate as PlayerSnapshot::EstimateStartFrame(). For a rush unit, the walking
+// time from its base needs a ground path, so keep it until the unit is seen somewhere else
+// or the enemy base it came from changes.
+int OpponentPlan::estimateStartFrame(const UnitInfo & ui)
+{
+	if (!ui.completed || !PlayerSnapshot::IsRushUnit(ui.type))
 	{
-		const UnitInfo & ui(kv.second);
+		return PlayerSnapshot::EstimateStartFrame(ui);
+	}
 
-		if (ui.type.isWorker() && ui.unit->isVisible() && myOrigin.getDistance(ui.unit->getPosition()) < 1000)
-		{
-			++enemyWorkerRushCount;
-		}
+	BWTA::BaseLocation * base = PlayerSnapshot::EstimatedHomeBase(ui);
+	MoveEstimate & estimate = _moveEstimates[ui.unit];
+	if (estimate.frames < 0 || estimate.position != ui.lastPosition || estimate.base != base)
+	{
+		estimate.position = ui.lastPosition;
+		estimate.base = base;
+		estimate.frames = PlayerSnapshot::EstimateFramesToMove(ui, base);
 	}
 
-	return enemyWorkerRushCount >= 3;
+	return BWAPI::Broodwar->getFrameCount() - estimate.frames;
 }
 
-// Factory, possibly with starport, and no sign of many marines intended.
-bool OpponentPlan::recognizeFactoryTech()
+// Was a counted unit of this type started before the given frame, as far as we can estimate?
+bool OpponentPlan::startedBefore(BWAPI::UnitType type, int frame)
 {
-	if (BWAPI::Broodwar->enemy()->getRace() != BWAPI::Races::Terran)
+	auto it = _unitsByType.find(type);
+	if (it == _unitsByType.end())
 	{
 		return false;
 	}
 
-	int nMarines = 0;
-	int nBarracks = 0;
-	int nTechProduction = 0;
-	bool tech = false;
-
-	for (const auto & kv : InformationManager::Instance().getUnitData(BWAPI::Broodwar->enemy()).getUnits())
+	const auto & enemyUnits = InformationManager::Instance().getUnitData(BWAPI::Broodwar->enemy()).getUnits();
+	for (const auto unit : it->second)
 	{
-		const UnitInfo & ui(kv.second);
-
-		if (ui.type == BWAPI::UnitTypes::Terran_Marine)
+		auto ui = enemyUnits.find(unit);
+		if (ui == enemyUnits.end() || !counted(ui->second.type, ui->second.completed))
 		{
-			++nMarines;
+			continue;
 		}
 
-		else if (ui.type.whatBuilds().first == BWAPI::UnitTypes::Terran_Barracks)
+		const int startFrame = estimateStartFrame(ui->second);
+		if (startFrame > 0 && startFrame < frame)
 		{
-			return false;			// academy implied, marines seem to be intended
+			return true;
 		}
+	}
 
-		else if (ui.type == BWAPI::UnitTypes::Terran_Barracks)
-		{
-			++nBarracks;
-		}
+	return false;
+}
 
-		else if (ui.type == BWAPI::UnitTypes::Terran_Academy)
-		{
-			return false;			// marines seem to be intended
-		}
+// NOTE Incomplete test! We don't measure the distance of enemy units from the enemy base,
+//      so we don't recognize all the rushes that we should.
+bool OpponentPlan::recognizeWorkerRush()
+{
+	BWAPI::Position myOrigin = InformationManager::Instance().getMyMainBaseLocation()->getPosition();
+
+	int enemyWorkerRushCount = 0;
 
-		else if (ui.type == BWAPI::UnitTypes::Terran_Factory ||
-			ui.type == BWAPI::UnitTypes::Terran_Starport)
+	for (const auto & kv : _unitsByType)
+	{
+		if (!kv.first.isWorker())
 		{
-			++nTechProduction;
+			continue;
 		}
 
-		else if (ui.type.whatBuilds().first == BWAPI::UnitTypes::Terran_Factory ||
-			ui.type.whatBuilds().first == BWAPI::UnitTypes::Terran_Starport ||
-			ui.type == BWAPI::UnitTypes::Terran_Armory)
+		for (const auto unit : kv.second)
 		{
-			tech = true;			// indicates intention to rely on tech units
+			if (unit->isVisible() && myOrigin.getDistance(unit->getPosition()) < 1000)
+			{
+				++enemyWorkerRushCount;
+			}
 		}
 	}
 
-	return (nTechProduction >= 2 || tech) && nMarines <= 6 && nBarracks <= 1;
+	return enemyWorkerRushCount >= 3;
 }
 
-void OpponentPlan::recognize()
+// Early production buildings or early rush units.
+bool OpponentPlan::recognizeFastRush()
 {
+	return
+		startedBefore(BWAPI::UnitTypes::Zerg_Spawning_Pool, 1600) ||
+		startedBefore(BWAPI::UnitTypes::Zerg_Zergling, 3200) ||
+		startedBefore(BWAPI::UnitTypes::Protoss_Gateway, 1750) ||
+		startedBefore(BWAPI::UnitTypes::Protoss_Zealot, 3300) ||
+		startedBefore(BWAPI::UnitTypes::Terran_Barracks, 1400) ||
+		startedBefore(BWAPI::UnitTypes::Terran_Marine, 3000);
+}
+
+// Gather the inputs of the rules below. The proxy, worker rush and fast rush tests
+// take precedence in that order, so a test is skipped once an earlier one succeeds.
+OpponentPlan::Inputs OpponentPlan::getInputs()
+{
+	int frame = BWAPI::Broodwar->getFrameCount();
+
+	Inputs inputs;
+	inputs.proxy = InformationManager::Instance().getEnemyProxy();
+	inputs.workerRush = !inputs.proxy && frame < 3000 && recognizeWorkerRush();
+	inputs.fastRush = !inputs.proxy && !inputs.workerRush && recognizeFastRush();
+	inputs.frameBand =
+		(frame < 3000 ? 1 : 0) |
+		(frame > 4000 ? 2 : 0) |
+		(frame < 5500 ? 4 : 0) |
+		(frame < 7000 ? 8 : 0) |
+		(frame > 8000 ? 16 : 0);
+	inputs.unitCountsVersion = _unitCountsVersion;
+	return inputs;
+}
+
+void OpponentPlan::recognize(const Inputs & inputs)
+{
+	// The rules give the same answer for the same inputs, so skip them if nothing changed.
+	if (_evaluated && inputs == _lastInputs)
+	{
+		return;
+	}
+	_evaluated = true;
+	_lastInputs = inputs;
+
 	// Recognize fast plans first, slow plans below.
 
 	// Recognize in-base proxy buildings. Info manager does it for us.
-	if (InformationManager::Instance().getEnemyProxy())
+	if (inputs.proxy)
 	{
 		_openingPlan = OpeningPlan::Proxy;
 		_planIsFixed = true;
@@ -112,22 +170,14 @@ void OpponentPlan::recognize()
     int frame = BWAPI::Broodwar->getFrameCount();
 
 	// Recognize worker rushes.
-	if (frame < 3000 && recognizeWorkerRush())
+	if (inputs.workerRush)
 	{
 		_openingPlan = OpeningPlan::WorkerRush;
 		return;
 	}
 
-	PlayerSnapshot snap;
-	snap.takeEnemy();
-
 	// Recognize fast rushes.
-	if (snap.getFrame(BWAPI::UnitTypes::Zerg_Spawning_Pool) < 1600 ||
-		snap.getFrame(BWAPI::UnitTypes::Zerg_Zergling) < 3200 ||
-		snap.getFrame(BWAPI::UnitTypes::Protoss_Gateway) < 1750 ||
-		snap.getFrame(BWAPI::UnitTypes::Protoss_Zealot) < 3300 ||
-		snap.getFrame(BWAPI::UnitTypes::Terran_Barracks) < 1400 ||
-		snap.getFrame(BWAPI::UnitTypes::Terran_Marine) < 3000)
+	if (inputs.fastRush)
 	{
 		_openingPlan = OpeningPlan::FastRush;
 		_planIsFixed = true;
@@ -143,9 +193,9 @@ void OpponentPlan::recognize()
     // When we know the enemy is not doing a fast plan, set it
     // May get overridden by a more appropriate plan below later on
     if (_openingPlan == OpeningPlan::Unknown && (
-        snap.getCount(BWAPI::UnitTypes::Zerg_Drone) > 6 ||     // 4- or 5-pool
-        snap.getCount(BWAPI::UnitTypes::Terran_SCV) > 8 ||     // BBS
-        snap.getCount(BWAPI::UnitTypes::Protoss_Probe) > 9) || // 9-gate
+        getCount(BWAPI::UnitTypes::Zerg_Drone) > 6 ||     // 4- or 5-pool
+        getCount(BWAPI::UnitTypes::Terran_SCV) > 8 ||     // BBS
+        getCount(BWAPI::UnitTypes::Protoss_Probe) > 9) || // 9-gate
         frame > 8000) // Failsafe if we have no other information at this point
     {
         _openingPlan = OpeningPlan::NotFastRush;
@@ -155,26 +205,26 @@ void OpponentPlan::recognize()
 	// TODO make sure we've seen the bare geyser in the enemy base!
 	// TODO seeing a unit carrying gas also means the enemy has gas
 	if (frame < 5500 &&
-        snap.getCount(BWAPI::UnitTypes::Zerg_Zergling) > 10
+        getCount(BWAPI::UnitTypes::Zerg_Zergling) > 10
         ||
         frame > 4000 &&
-        snap.getCount(BWAPI::UnitTypes::Zerg_Hatchery) == 1 &&
-        snap.getCount(BWAPI::UnitTypes::Zerg_Drone) <= 9
+        getCount(BWAPI::UnitTypes::Zerg_Hatchery) == 1 &&
+        getCount(BWAPI::UnitTypes::Zerg_Drone) <= 9
         ||
-        snap.getCount(BWAPI::UnitTypes::Zerg_Hatchery) >= 2 &&
-		snap.getCount(BWAPI::UnitTypes::Zerg_Spawning_Pool) > 0 &&
-		snap.getCount(BWAPI::UnitTypes::Zerg_Extractor) == 0 &&
-        snap.getCount(BWAPI::UnitTypes::Zerg_Zergling) > 5
+        getCount(BWAPI::UnitTypes::Zerg_Hatchery) >= 2 &&
+		getCount(BWAPI::UnitTypes::Zerg_Spawning_Pool) > 0 &&
+		getCount(BWAPI::UnitTypes::Zerg_Extractor) == 0 &&
+        getCount(BWAPI::UnitTypes::Zerg_Zergling) > 5
 		||
-		snap.getCount(BWAPI::UnitTypes::Terran_Barracks) >= 2 &&
-		snap.getCount(BWAPI::UnitTypes::Terran_Refinery) == 0 &&
-		snap.getCount(BWAPI::UnitTypes::Terran_Command_Center) <= 1 &&
-		snap.getCount(BWAPI::UnitTypes::Terran_Marine) > 3
+		getCount(BWAPI::UnitTypes::Terran_Barracks) >= 2 &&
+		getCount(BWAPI::UnitTypes::Terran_Refinery) == 0 &&
+		getCount(BWAPI::UnitTypes::Terran_Command_Center) <= 1 &&
+		getCount(BWAPI::UnitTypes::Terran_Marine) > 3
 		||
-		snap.getCount(BWAPI::UnitTypes::Protoss_Gateway) >= 2 &&
-		snap.getCount(BWAPI::UnitTypes::Protoss_Assimilator) == 0 &&
-		snap.getCount(BWAPI::UnitTypes::Protoss_Nexus) <= 1 &&
-		snap.getCount(BWAPI::UnitTypes::Protoss_Zealot) > 3)
+		getCount(BWAPI::UnitTypes::Protoss_Gateway) >= 2 &&
+		getCount(BWAPI::UnitTypes::Protoss_Assimilator) == 0 &&
+		getCount(BWAPI::UnitTypes::Protoss_Nexus) <= 1 &&
+		getCount(BWAPI::UnitTypes::Protoss_Zealot) > 3)
 	{
 		_openingPlan = OpeningPlan::HeavyRush;
 		_planIsFixed = true;
@@ -183,59 +233,18 @@ void OpponentPlan::recognize()
 
     // Recognize a hydra bust
     if (frame < 7000 &&
-        snap.getCount(BWAPI::UnitTypes::Zerg_Hatchery) >= 2 &&
-        snap.getCount(BWAPI::UnitTypes::Zerg_Hydralisk_Den) > 0 &&
-        snap.getCount(BWAPI::UnitTypes::Zerg_Zergling) < 3)
+        getCount(BWAPI::UnitTypes::Zerg_Hatchery) >= 2 &&
+        getCount(BWAPI::UnitTypes::Zerg_Hydralisk_Den) > 0 &&
+        getCount(BWAPI::UnitTypes::Zerg_Zergling) < 3)
     {
         _openingPlan = OpeningPlan::HydraBust;
         _planIsFixed = true;
         return;
     }
 
-    // Disabling the rest, as we do no specific counters or reactions to them
-    // Better to leave it as NotFastRush so we don't confuse our opening selection
-    return;
-
-	// Recognize terran factory tech openings.
-	if (recognizeFactoryTech())
-	{
-		_openingPlan = OpeningPlan::Factory;
-		return;
-	}
-
-	// Recognize expansions with pre-placed static defense.
-	// Zerg can't do this.
-	// NOTE Incomplete test! We don't check the location of the static defense
-	if (InformationManager::Instance().getNumBases(BWAPI::Broodwar->enemy()) >= 2)
-	{
-		if (snap.getCount(BWAPI::UnitTypes::Terran_Bunker) > 0 ||
-			snap.getCount(BWAPI::UnitTypes::Protoss_Photon_Cannon) > 0)
-		{
-			_openingPlan = OpeningPlan::SafeExpand;
-			return;
-		}
-	}
-
-	// Recognize a naked expansion.
-	// This has to run after the SafeExpand check, since it doesn't check for what's missing.
-	if (InformationManager::Instance().getNumBases(BWAPI::Broodwar->enemy()) >= 2)
-	{
-		_openingPlan = OpeningPlan::NakedExpand;
-		return;
-	}
-
-	// Recognize a turtling enemy.
-	// NOTE Incomplete test! We don't check where the defenses are placed.
-	if (InformationManager::Instance().getNumBases(BWAPI::Broodwar->enemy()) < 2)
-	{
-		if (snap.getCount(BWAPI::UnitTypes::Terran_Bunker) >= 2 ||
-			snap.getCount(BWAPI::UnitTypes::Protoss_Photon_Cannon) >= 2 ||
-			snap.getCount(BWAPI::UnitTypes::Zerg_Sunken_Colony) >= 2)
-		{
-			_openingPlan = OpeningPlan::Turtle;
-			return;
-		}
-	}
+    // Factory, SafeExpand, NakedExpand and Turtle are not recognized, as we do no specific
+    // counters or reactions to them. Better to leave it as NotFastRush so we don't confuse
+    // our opening selection.
 
 	// Nothing recognized: Opening plan remains unchanged.
 }
@@ -245,6 +254,8 @@ void OpponentPlan::recognize()
 OpponentPlan::OpponentPlan()
 	: _openingPlan(OpeningPlan::Unknown)
 	, _planIsFixed(false)
+	, _unitCountsVersion(0)
+	, _evaluated(false)
 {
 }
 
@@ -268,6 +279,47 @@ void OpponentPlan::update()
 	if (frame > 100 && frame < 7200 &&       // only try to recognize openings
 		frame % 12 == 7)                     // update interval
 	{
-		recognize();
+		recognize(getInputs());
+	}
+}
+
+// The unit data calls this when an enemy unit appears, or changes its type or completion.
+// A new unit comes with oldType None.
+void OpponentPlan::onEnemyUnitChanged(const UnitInfo & ui, BWAPI::UnitType oldType, bool oldCompleted)
+{
+	if (oldType != ui.type)
+	{
+		if (oldType != BWAPI::UnitTypes::None)
+		{
+			_unitsByType[oldType].erase(ui.unit);
+		}
+		_unitsByType[ui.type].insert(ui.unit);
+	}
+
+	const bool wasCounted = counted(oldType, oldCompleted);
+	const bool isCounted = counted(ui.type, ui.completed);
+
+	if (wasCounted && (!isCounted || oldType != ui.type))
+	{
+		--_unitCounts[oldType];
+		++_unitCountsVersion;
+	}
+	if (isCounted && (!wasCounted || oldType != ui.type))
+	{
+		++_unitCounts[ui.type];
+		++_unitCountsVersion;
+	}
+}
+
+// The unit data calls this before it forgets an enemy unit.
+void OpponentPlan::onEnemyUnitRemoved(const UnitInfo & ui)
+{
+	_unitsByType[ui.type].erase(ui.unit);
+	_moveEstimates.erase(ui.unit);
+
+	if (counted(ui.type, ui.completed))
+	{
+		--_unitCounts[ui.type];
+		++_unitCountsVersion;
 	}
 }
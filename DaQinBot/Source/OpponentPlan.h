@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Common.h"
+#include "UnitData.h"
 
 namespace UAlbertaBot
 {
@@ -67,21 +68,69 @@ class OpponentPlan
 {
 private:
 
+	// Everything the decision rules look at. The rules are evaluated again only when this changes.
+	struct Inputs
+	{
+		bool	proxy;
+		bool	workerRush;
+		bool	fastRush;
+		int		frameBand;				// one bit for each frame threshold in the rules
+		int		unitCountsVersion;
+
+		bool operator==(const Inputs & rhs) const
+		{
+			return
+				proxy == rhs.proxy &&
+				workerRush == rhs.workerRush &&
+				fastRush == rhs.fastRush &&
+				frameBand == rhs.frameBand &&
+				unitCountsVersion == rhs.unitCountsVersion;
+		}
+	};
+
 	OpeningPlan _openingPlan;		// estimated enemy plan
 	bool _planIsFixed;				// estimate will no longer change
 
+	// Kept up to date by the enemy unit data events.
+	std::map<BWAPI::UnitType, BWAPI::Unitset> _unitsByType;	// every enemy unit we know of
+	std::map<BWAPI::UnitType, int> _unitCounts;				// counted as in PlayerSnapshot::takeEnemy()
+	int _unitCountsVersion;									// changes when _unitCounts changes
+
+	bool _evaluated;				// the rules have been evaluated with _lastInputs
+	Inputs _lastInputs;
+
+	// The walking time of a rush unit from its base, and where it was seen and which base it came from.
+	struct MoveEstimate
+	{
+		BWAPI::Position			position;
+		BWTA::BaseLocation *	base;
+		int						frames;
+
+		MoveEstimate() : position(BWAPI::Positions::None), base(nullptr), frames(-1) {};
+	};
+	std::map<BWAPI::Unit, MoveEstimate> _moveEstimates;
+
 	bool fastPlan(OpeningPlan plan);
 
+	bool counted(BWAPI::UnitType type, bool completed) const;
+	int getCount(BWAPI::UnitType type) const;
+	int estimateStartFrame(const UnitInfo & ui);
+	bool startedBefore(BWAPI::UnitType type, int frame);
+
 	bool recognizeWorkerRush();
-	bool recognizeFactoryTech();
+	bool recognizeFastRush();
 
-	void recognize();
+	Inputs getInputs();
+	void recognize(const Inputs & inputs);
 
 public:
 	OpponentPlan();
 
 	void update();
 
+	void onEnemyUnitChanged(const UnitInfo & ui, BWAPI::UnitType oldType, bool oldCompleted);
+	void onEnemyUnitRemoved(const UnitInfo & ui);
+
 	OpeningPlan getPlan() const { return _openingPlan; };
 };
 
@@ -6,8 +6,6 @@
 #include "Random.h"
 #include "StrategyManager.h"
 
-#include <regex>
-
 // Parse the configuration file.
 // Parse manual commands.
 // Provide a few simple parsing routines for wider use.
@@ -90,6 +88,8 @@ void ParseUtils::ParseConfigFile(const std::string & filename)
     {
         const rapidjson::Value & macro = doc["Macro"];
         JSONTools::ReadInt("BOSSFrameLimit", macro, Config::Macro::BOSSFrameLimit);
+        JSONTools::ReadInt("BOSSBeamGoalSize", macro, Config::Macro::BOSSBeamGoalSize);
+        JSONTools::ReadInt("BOSSGoalComparisonThreads", macro, Config::Macro::BOSSGoalComparisonThreads);
         JSONTools::ReadInt("PylonSpacing", macro, Config::Macro::PylonSpacing);
 
 		Config::Macro::ProductionJamFrameLimit = GetIntByRace("ProductionJamFrameLimit", macro);
@@ -130,6 +130,7 @@ void ParseUtils::ParseConfigFile(const std::string & filename)
 		JSONTools::ReadBool("DrawUnitOrders", debug, Config::Debug::DrawUnitOrders);
 		JSONTools::ReadBool("DrawReservedBuildingTiles", debug, Config::Debug::DrawReservedBuildingTiles);
         JSONTools::ReadBool("DrawBOSSStateInfo", debug, Config::Debug::DrawBOSSStateInfo); 
+        JSONTools::ReadBool("BenchmarkTargetAssignment", debug, Config::Debug::BenchmarkTargetAssignment);
     }
 
     // Parse the Tool Options
@@ -153,6 +154,7 @@ void ParseUtils::ParseConfigFile(const std::string & filename)
 
 		Config::IO::ReadOpponentModel = GetBoolByRace("ReadOpponentModel", io);
 		Config::IO::WriteOpponentModel = GetBoolByRace("WriteOpponentModel", io);
+		JSONTools::ReadBool("UseSearchCache", io, Config::IO::UseSearchCache);
 	}
 
 	// We do this here because opening selection may depend on the results.
@@ -207,7 +209,9 @@ void ParseUtils::ParseConfigFile(const std::string & filename)
 					openingGroup = val["OpeningGroup"].GetString();
 				}
 
-				BuildOrder buildOrder(strategyRace);
+				// The openings share their parsed items, most openings use the same few.
+				OpeningBook & openingBook = StrategyManager::Instance().getOpeningBook();
+				std::vector<int> acts;
 				if (val.HasMember("OpeningBuildOrder") && val["OpeningBuildOrder"].IsArray())
 				{
 					const rapidjson::Value & build = val["OpeningBuildOrder"];
@@ -216,27 +220,12 @@ void ParseUtils::ParseConfigFile(const std::string & filename)
 					{
 						if (build[b].IsString())
 						{
-							std::string itemName = build[b].GetString();
-
-							int unitCount = 1;    // the default count
-
-							// You can specify a count, like "6 x mutalisk". The spaces are required.
-							// Mostly useful for units, but "2 x creep colony @ natural" also works.
-							std::regex countRegex("([0-9]+)\\s+x\\s+([a-zA-Z_ ]+(\\s+@\\s+[a-zA-Z_ ]+)?)");
-							std::smatch m;
-							if (std::regex_match(itemName, m, countRegex)) {
-								unitCount = GetIntFromString(m[1].str());
-								itemName = m[2].str();
-							}
-
-							MacroAct act(itemName);
+							int unitCount = 1;
+							int act = openingBook.intern(build[b].GetString(), unitCount);
 
-							if (act.getRace() != BWAPI::Races::None || act.isCommand())
+							if (act >= 0)
 							{
-								for (int i = 0; i < unitCount; ++i)
-								{
-									buildOrder.add(act);
-								}
+								acts.insert(acts.end(), unitCount, act);
 							}
 						}
 						else
@@ -250,7 +239,8 @@ void ParseUtils::ParseConfigFile(const std::string & filename)
 				// Only remember the ones that are for our current race.
 				if (strategyRace == BWAPI::Broodwar->self()->getRace())
 				{
-					StrategyManager::Instance().addStrategy(name, Strategy(name, strategyRace, openingGroup, buildOrder));
+					openingBook.addOpening(name, acts);
+					StrategyManager::Instance().addStrategy(name, Strategy(name, strategyRace, openingGroup));
 					openingNames.push_back(name);
 				}
 			}
@@ -57,6 +57,66 @@ void PlayerSnapshot::takeSelf()
 	}
 }
 
+// Estimate the frame the enemy unit was started: buildings from their build time,
+// rush units from how long they would take to walk here from the enemy base.
+// Other units, and incomplete non-buildings, get 0 for no estimate.
+int PlayerSnapshot::EstimateStartFrame(const UnitInfo & ui)
+{
+    int startFrame = 0;
+
+    if (ui.type.isBuilding())
+    {
+        startFrame = (ui.completed ? BWAPI::Broodwar->getFrameCount() : ui.estimatedCompletionFrame) - ui.type.buildTime();
+    }
+    else if (ui.completed && IsRushUnit(ui.type))
+    {
+        // For rush units, estimate when they were likely completed
+        startFrame = BWAPI::Broodwar->getFrameCount() - EstimateFramesToMove(ui, EstimatedHomeBase(ui));
+    }
+
+    return startFrame;
+}
+
+bool PlayerSnapshot::IsRushUnit(BWAPI::UnitType type)
+{
+    return
+        type == BWAPI::UnitTypes::Zerg_Zergling ||
+        type == BWAPI::UnitTypes::Terran_Marine ||
+        type == BWAPI::UnitTypes::Protoss_Zealot;
+}
+
+// The base the unit most likely came from.
+BWTA::BaseLocation * PlayerSnapshot::EstimatedHomeBase(const UnitInfo & ui)
+{
+    // If we haven't found the enemy base yet, assume the unit came from the closest starting location to it
+    auto enemyBase = InformationManager::Instance().getEnemyMainBaseLocation();
+    if (!enemyBase)
+    {
+        int minDistance = INT_MAX;
+        for (BWTA::BaseLocation * base : BWTA::getStartLocations())
+        {
+            if (base == InformationManager::Instance().getMyMainBaseLocation()) continue;
+
+            int dist = ui.lastPosition.getApproxDistance(base->getPosition());
+            if (dist < minDistance)
+            {
+                minDistance = dist;
+                enemyBase = base;
+            }
+        }
+    }
+
+    return enemyBase;
+}
+
+// How long the unit would take to walk from the base to where it was last seen.
+// This finds a ground path, so callers which ask often should keep the answer.
+int PlayerSnapshot::EstimateFramesToMove(const UnitInfo & ui, BWTA::BaseLocation * base)
+{
+    int distanceToMove = PathFinding::GetGroundDistance(ui.lastPosition, base->getPosition(), PathFinding::PathFindingOptions::UseNearestBWEMArea);
+    return std::floor(((double)distanceToMove / ui.type.topSpeed()) * 1.1);
+}
+
 // Include incomplete buildings, but not other incomplete units.
 // The plan recognizer pays attention to incomplete buildings.
 void PlayerSnapshot::takeEnemy()
@@ -72,48 +132,9 @@ void PlayerSnapshot::takeEnemy()
         if (excludeType(ui.type)) continue;
         if (!ui.type.isBuilding() && !ui.completed) continue;
 
-        int startFrame = 0;
-
-        if (ui.type.isBuilding())
-        {
-            ++unitCounts[ui.type];
-
-            startFrame = (ui.completed ? BWAPI::Broodwar->getFrameCount() : ui.estimatedCompletionFrame) - ui.type.buildTime();
-        }
-        else if (ui.completed)
-        {
-            ++unitCounts[ui.type];
-
-            // For rush units, estimate when they were likely completed
-            if (ui.type == BWAPI::UnitTypes::Zerg_Zergling ||
-                ui.type == BWAPI::UnitTypes::Terran_Marine ||
-                ui.type == BWAPI::UnitTypes::Protoss_Zealot)
-            {
-                // If we haven't found the enemy base yet, assume the unit came from the closest starting location to it
-                auto enemyBase = InformationManager::Instance().getEnemyMainBaseLocation();
-                if (!enemyBase)
-                {
-                    int minDistance = INT_MAX;
-                    for (BWTA::BaseLocation * base : BWTA::getStartLocations())
-                    {
-                        if (base == InformationManager::Instance().getMyMainBaseLocation()) continue;
-
-                        int dist = ui.lastPosition.getApproxDistance(base->getPosition());
-                        if (dist < minDistance)
-                        {
-                            minDistance = dist;
-                            enemyBase = base;
-                        }
-                    }
-                }
-
-                int distanceToMove = PathFinding::GetGroundDistance(ui.lastPosition, enemyBase->getPosition(), PathFinding::PathFindingOptions::UseNearestBWEMArea);
-                int framesToMove = std::floor(((double)distanceToMove / ui.type.topSpeed()) * 1.1);
-
-                startFrame = BWAPI::Broodwar->getFrameCount() - framesToMove;
-            }
-        }
+        ++unitCounts[ui.type];
 
+        int startFrame = EstimateStartFrame(ui);
         if (startFrame > 0)
         {
             if (unitFrame.find(ui.type) == unitFrame.end())
@@ -1,15 +1,17 @@
 #pragma once
 
 #include "Common.h"
+#include <BWTA.h>
 
 namespace UAlbertaBot
 {
+struct UnitInfo;
 
 class PlayerSnapshot
 {
-	bool excludeType(BWAPI::UnitType type);
-
 public:
+	static bool excludeType(BWAPI::UnitType type);
+
 	int numBases;
 	std::map<BWAPI::UnitType, int> unitCounts;
     std::map<BWAPI::UnitType, int> unitFrame;
@@ -24,6 +26,11 @@ public:
     int getFrame(BWAPI::UnitType type) const;
 
 	std::string debugString() const;
+
+	static int EstimateStartFrame(const UnitInfo & ui);
+	static bool IsRushUnit(BWAPI::UnitType type);
+	static BWTA::BaseLocation * EstimatedHomeBase(const UnitInfo & ui);
+	static int EstimateFramesToMove(const UnitInfo & ui, BWTA::BaseLocation * base);
 };
 
 }
\ No newline at end of file
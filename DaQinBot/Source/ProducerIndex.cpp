@@ -0,0 +1,150 @@
+#include "ProducerIndex.h"
+#include "UnitUtil.h"
+
+using namespace UAlbertaBot;
+
+ProducerIndex::ProducerIndex()
+	: _initialized(false)
+{
+}
+
+// When a busy building will be free to produce, if nothing else is ordered meanwhile.
+// -1 if it won't be free until it lands or is powered again.
+int ProducerIndex::GetFreeFrame(BWAPI::Unit unit)
+{
+	const int now = BWAPI::Broodwar->getFrameCount();
+
+	if (!unit->isCompleted() || unit->isMorphing())
+	{
+		return now + unit->getRemainingBuildTime();
+	}
+	if (unit->isLifted() || !unit->isPowered())
+	{
+		return -1;
+	}
+	if (unit->isTraining())
+	{
+		return now + unit->getRemainingTrainTime();
+	}
+	if (unit->isUpgrading())
+	{
+		return now + unit->getRemainingUpgradeTime();
+	}
+	if (unit->isResearching())
+	{
+		return now + unit->getRemainingResearchTime();
+	}
+	return now;
+}
+
+// Once per frame, before any queries.
+void ProducerIndex::update()
+{
+	// The units we start with may be created before we are listening.
+	if (!_initialized)
+	{
+		for (const auto unit : BWAPI::Broodwar->self()->getUnits())
+		{
+			onUnitChange(unit);
+		}
+		_initialized = true;
+	}
+
+	for (auto & producers : _producers)
+	{
+		producers.second.idle.clear();
+		producers.second.nextFreeFrame = -1;
+	}
+
+	for (const auto unit : _buildings)
+	{
+		if (!unit->exists())
+		{
+			continue;
+		}
+
+		// A morphed building, like a lair, is listed under its new type.
+		ProducerList & producers = _producers[unit->getType()];
+		bool idle = UnitUtil::IsIdleProducer(unit);
+		int freeFrame = idle ? BWAPI::Broodwar->getFrameCount() : GetFreeFrame(unit);
+
+		if (idle)
+		{
+			producers.idle.push_back(unit);
+		}
+		if (freeFrame >= 0 && (producers.nextFreeFrame < 0 || freeFrame < producers.nextFreeFrame))
+		{
+			producers.nextFreeFrame = freeFrame;
+		}
+	}
+}
+
+void ProducerIndex::onUnitChange(BWAPI::Unit unit)
+{
+	if (!unit)
+	{
+		return;
+	}
+
+	if (unit->getPlayer() == BWAPI::Broodwar->self() && isIndexed(unit->getType()))
+	{
+		_buildings.insert(unit);
+	}
+	else
+	{
+		// A cancelled drone morph, or a building that was taken from us.
+		_buildings.erase(unit);
+	}
+}
+
+void ProducerIndex::onUnitDestroy(BWAPI::Unit unit)
+{
+	_buildings.erase(unit);
+}
+
+BWAPI::Unit ProducerIndex::getProducer(BWAPI::UnitType type, BWAPI::Position position, bool farthest,
+	const std::function<bool(BWAPI::Unit)> & filter) const
+{
+	auto it = _producers.find(type);
+	if (it == _producers.end())
+	{
+		return nullptr;
+	}
+
+	BWAPI::Unit best = nullptr;
+	int bestDist = -1;
+
+	for (const auto unit : it->second.idle)
+	{
+		// It may have been given an order since the update.
+		if (!filter(unit))
+		{
+			continue;
+		}
+
+		if (position == BWAPI::Positions::None)
+		{
+			return unit;
+		}
+
+		int dist = unit->getDistance(position);
+		if (!best || (farthest ? dist > bestDist : dist < bestDist))
+		{
+			best = unit;
+			bestDist = dist;
+		}
+	}
+
+	return best;
+}
+
+int ProducerIndex::getNextFreeFrame(BWAPI::UnitType type) const
+{
+	auto it = _producers.find(type);
+	if (it == _producers.end())
+	{
+		return -1;
+	}
+
+	return it->second.nextFreeFrame;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Common.h"
+#include <functional>
+
+namespace UAlbertaBot
+{
+// Our buildings by type, with the ones free to produce and when the next busy one will be free.
+// Which buildings we have is kept up to date from unit events. A building stops training or researching
+// without any event, so update() reads that once per frame, for the indexed buildings only.
+// Workers, larvas and units which morph are not indexed; look for those among all our units.
+class ProducerIndex
+{
+	struct ProducerList
+	{
+		std::vector<BWAPI::Unit> idle;		// completed, powered, landed and not busy, in the order of _buildings
+		int nextFreeFrame;					// -1 if none is idle or will be free without a new order
+	};
+
+	std::set<BWAPI::Unit>						_buildings;
+	std::map<BWAPI::UnitType, ProducerList>		_producers;		// by the building's current type
+	bool										_initialized;
+
+	static int	GetFreeFrame(BWAPI::Unit unit);
+
+public:
+
+	ProducerIndex();
+
+	void		update();
+
+	void		onUnitChange(BWAPI::Unit unit);		// created, completed, morphed or changed owner
+	void		onUnitDestroy(BWAPI::Unit unit);
+
+	bool		isIndexed(BWAPI::UnitType type) const { return type.isBuilding(); };
+
+	// The idle building of the type which passes the filter, closest to the position, or farthest
+	// from it if farthest is set. If the position is None, the first that passes. Null if none does.
+	BWAPI::Unit	getProducer(BWAPI::UnitType type, BWAPI::Position position, bool farthest,
+					const std::function<bool(BWAPI::Unit)> & filter) const;
+
+	// The frame that the first building of the type is expected to be free, the current frame if
+	// one is idle now. -1 if we have none, or none will be free without a new order (it is lifted
+	// or unpowered). A building training a queue of units is counted as free after the first.
+	int			getNextFreeFrame(BWAPI::UnitType type) const;
+};
+}
@@ -48,6 +48,9 @@ void ProductionManager::queueMacroAction(const MacroAct & macroAct)
 
 void ProductionManager::update() 
 {
+	// Find which of our buildings are free to produce this frame.
+	_producers.update();
+
 	BWAPI::Player _self = BWAPI::Broodwar->self();
 	// TODO move this to worker manager and make it more precise; it normally goes a little over
 	// If we have reached a target amount of gas, take workers off gas.
@@ -101,9 +104,31 @@ void ProductionManager::update()
 	manageBuildOrderQueue();
 }
 
+void ProductionManager::onUnitCreate(BWAPI::Unit unit)
+{
+	_producers.onUnitChange(unit);
+}
+
+void ProductionManager::onUnitComplete(BWAPI::Unit unit)
+{
+	_producers.onUnitChange(unit);
+}
+
+void ProductionManager::onUnitMorph(BWAPI::Unit unit)
+{
+	_producers.onUnitChange(unit);
+}
+
+void ProductionManager::onUnitRenegade(BWAPI::Unit unit)
+{
+	_producers.onUnitChange(unit);
+}
+
 // If something important was destroyed, we may want to react.
 void ProductionManager::onUnitDestroy(BWAPI::Unit unit)
 {
+	_producers.onUnitDestroy(unit);
+
 	// If it's not our unit, we don't care.
 	if (!unit || unit->getPlayer() != BWAPI::Broodwar->self())
 	{
@@ -592,6 +617,20 @@ void ProductionManager::maybeReorderQueue()
 // NOTE closestTo defaults to BWAPI::Positions::None, meaning we don't care.
 BWAPI::Unit ProductionManager::getProducer(MacroAct act, BWAPI::Position closestTo) const
 {
+	// Buildings are looked up among the idle buildings of the type, not among all our units.
+	if (_producers.isIndexed(act.whatBuilds()))
+	{
+		auto isCandidate = [&act](BWAPI::Unit unit) { return act.isCandidateProducer(unit); };
+
+		// Workers from the base farthest from the main, as below.
+		if (act.isWorker())
+		{
+			return _producers.getProducer(act.whatBuilds(),
+				InformationManager::Instance().getMyMainBaseLocation()->getPosition(), true, isCandidate);
+		}
+		return _producers.getProducer(act.whatBuilds(), closestTo, false, isCandidate);
+	}
+
 	std::vector<BWAPI::Unit> candidateProducers;
 
 	act.getCandidateProducers(candidateProducers);
@@ -610,6 +649,17 @@ BWAPI::Unit ProductionManager::getProducer(MacroAct act, BWAPI::Position closest
 	}
 }
 
+// For a producer building, from the per-frame producer index. Other producers, like larvas, are not predicted.
+int ProductionManager::getNextProducerFrame(const MacroAct & act) const
+{
+	if (!_producers.isIndexed(act.whatBuilds()))
+	{
+		return -1;
+	}
+
+	return _producers.getNextFreeFrame(act.whatBuilds());
+}
+
 BWAPI::Unit ProductionManager::getClosestUnitToPosition(const std::vector<BWAPI::Unit> & units, BWAPI::Position closestTo) const
 {
     if (units.size() == 0)
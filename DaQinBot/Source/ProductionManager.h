@@ -8,6 +8,7 @@
 #include "BuildOrder.h"
 #include "BuildOrderQueue.h"
 #include "BuildingManager.h"
+#include "ProducerIndex.h"
 #include "ProductionGoal.h"
 #include "StrategyManager.h"
 
@@ -20,6 +21,7 @@ class ProductionManager
     ProductionManager();
     
     BuildOrderQueue						_queue;
+	ProducerIndex						_producers;
 	std::forward_list<std::shared_ptr<ProductionGoal>>	_goals;
 
 	int					_lastProductionFrame;            // for detecting jams
@@ -66,7 +68,10 @@ public:
 	void	setBuildOrder(const BuildOrder & buildOrder);
 	void	queueMacroAction(const MacroAct & macroAct);
 	void	update();
+	void	onUnitCreate(BWAPI::Unit unit);
+	void	onUnitComplete(BWAPI::Unit unit);
 	void	onUnitMorph(BWAPI::Unit unit);
+	void	onUnitRenegade(BWAPI::Unit unit);
 	void	onUnitDestroy(BWAPI::Unit unit);
 	void	drawProductionInformation(int x, int y);
 	void	startExtractorTrick(BWAPI::UnitType type);
@@ -84,6 +89,9 @@ public:
 
 	bool	canMakeUnit(BWAPI::UnitType type, int minerals, int gas, int supply);
 
+	// When the next producer for the act is expected to be free, -1 if unknown.
+	int		getNextProducerFrame(const MacroAct & act) const;
+
     const BuildOrderQueue& getQueue() const { return _queue; };
 };
 
@@ -1,5 +1,6 @@
 #include "ScoutManager.h"
 
+#include "NearestUnits.h"
 #include "OpponentModel.h"
 #include "ProductionManager.h"
 #include "UnitUtil.h"
@@ -599,29 +600,18 @@ BWAPI::Unit ScoutManager::enemyWorkerToHarass() const
 		}
 	}
 
-	BWAPI::Unit enemyWorker = nullptr;
-	int maxDist = 500;    // ignore any beyond this range
-
 	// Failing that, find the enemy worker closest to the gas.
 	BWAPI::Unit geyser = getAnyEnemyGeyser();
 	if (geyser)
 	{
-		for (const auto unit : BWAPI::Broodwar->enemy()->getUnits())
-		{
-			if (unit->getType().isWorker())
-			{
-				int dist = unit->getDistance(geyser->getInitialPosition());
+		const int maxDist = 500;    // ignore any beyond this range
 
-				if (dist < maxDist)
-				{
-					maxDist = dist;
-					enemyWorker = unit;
-				}
-			}
-		}
+		return NearestUnits::Instance().getClosest(geyser->getInitialPosition(), false, true,
+			[](BWAPI::Unit unit) { return unit->getType().isWorker(); },
+			NearestUnits::Metric::Air, maxDist);
 	}
 
-	return enemyWorker;
+	return nullptr;
 }
 
 // Used in choosing an enemy worker to harass.
@@ -4,6 +4,7 @@
 #include "UnitUtil.h"
 #include "MathUtil.h"
 #include "MapGrid.h"
+#include "NearestUnits.h"
 #include "PathFinding.h"
 
 using namespace UAlbertaBot;
@@ -174,6 +175,7 @@ void Squad::updateUnits()
 	setAllUnits();
 	setNearEnemyUnits();
 	addUnitsToMicroManagers();
+	updateTargetMatrix();
 }
 
 // Clean up the _units vector.
@@ -222,6 +224,31 @@ void Squad::setNearEnemyUnits()
 {
 	_nearEnemy.clear();
 
+	// Collect the enemy units that could count as near once for the whole squad,
+	// together with how far beyond the 400 pixel radius each one reaches.
+	// This is the unit-independent part of InformationManager::getNearbyForce().
+	std::vector<std::pair<const UnitInfo *, int>> enemies;
+	for (const auto & kv : InformationManager::Instance().getUnitData(BWAPI::Broodwar->enemy()).getUnits())
+	{
+		const UnitInfo & ui(kv.second);
+
+		if (UnitUtil::IsCombatSimUnit(ui.type) && ui.completed && !ui.goneFromLastPosition)
+		{
+			if (ui.type == BWAPI::UnitTypes::Terran_Medic)
+			{
+				enemies.push_back(std::make_pair(&ui, 32));
+			}
+			else
+			{
+				int range = UnitUtil::GetMaxAttackRange(ui.type);
+				if (range)
+				{
+					enemies.push_back(std::make_pair(&ui, range + 32));
+				}
+			}
+		}
+	}
+
 	for (const auto unit : _units)
 	{
 		if (!unit->getPosition().isValid())   // excludes loaded units
@@ -229,7 +256,7 @@ void Squad::setNearEnemyUnits()
 			continue;
 		}
 
-		_nearEnemy[unit] = unitNearEnemy(unit);
+		_nearEnemy[unit] = unitNearEnemy(unit, enemies);
 
 		if (Config::Debug::DrawSquadInfo) {
 			int left = unit->getType().dimensionLeft();
@@ -454,27 +481,54 @@ void Squad::clear()
 	_units.clear();
 }
 
-bool Squad::unitNearEnemy(BWAPI::Unit unit)
+void Squad::updateTargetMatrix()
 {
-	UAB_ASSERT(unit, "missing unit");
-
-	BWAPI::Unitset enemyNear;
+	// The same enemies that MicroManager::getTargets() finds for the micro managers.
+	BWAPI::Unitset targets;
+	if (_order.isCombatOrder())
+	{
+		MapGrid::Instance().getUnits(targets, _order.getPosition(), _order.getRadius(), false, true);
+		for (const auto unit : _units)
+		{
+			if (unit->getPosition().isValid())
+			{
+				MapGrid::Instance().getUnits(targets, unit->getPosition(), unit->getType().sightRange(), false, true);
+			}
+		}
+	}
 
-	//MapGrid::Instance().getUnits(enemyNear, unit->getPosition(), 400, false, true);
+	_targetMatrix.update(_units, targets);
+
+	_microAirToAir.setTargetMatrix(&_targetMatrix);
+	_microMelee.setTargetMatrix(&_targetMatrix);
+	_microRanged.setTargetMatrix(&_targetMatrix);
+	_microCarriers.setTargetMatrix(&_targetMatrix);
+	_microDetectors.setTargetMatrix(&_targetMatrix);
+	_microDarkTemplar.setTargetMatrix(&_targetMatrix);
+	_microHighTemplar.setTargetMatrix(&_targetMatrix);
+	_microLurkers.setTargetMatrix(&_targetMatrix);
+	_microMedics.setTargetMatrix(&_targetMatrix);
+	_microTanks.setTargetMatrix(&_targetMatrix);
+	_microTransports.setTargetMatrix(&_targetMatrix);
+	_microDragoons.setTargetMatrix(&_targetMatrix);
+}
 
-    //return enemyNear.size() > 0;
+// The enemies are the candidates collected by setNearEnemyUnits(), each with its reach.
+bool Squad::unitNearEnemy(BWAPI::Unit unit, const std::vector<std::pair<const UnitInfo *, int>> & enemies)
+{
+	UAB_ASSERT(unit, "missing unit");
 
     // Consider all enemy units, even if they are no longer visible
     // Otherwise we just stand still and let tanks range us down
 	//еĵ˵λʹǲٿɼ
 	//Ǿվű𶯣̹˿ǵ
-    std::vector<UnitInfo> enemyUnits;
-    InformationManager::Instance().getNearbyForce(enemyUnits, unit->getPosition(), BWAPI::Broodwar->enemy(), 400);
-
     // Return true if we are close to being in firing range of any of the enemy units
-    for (auto& ui : enemyUnits)
+    for (auto& enemy : enemies)
     {
-        if (ui.lastHealth > 0 &&
+        const UnitInfo & ui = *enemy.first;
+
+        if (ui.lastPosition.getDistance(unit->getPosition()) <= (400 + enemy.second) &&
+            ui.lastHealth > 0 &&
             (ui.unit->exists() || ui.lastPosition.isValid() && !ui.goneFromLastPosition) &&
             (ui.completed || ui.estimatedCompletionFrame < BWAPI::Broodwar->getFrameCount()) &&
             (ui.unit->exists() ? UnitUtil::IsCombatSimUnit(ui.unit) : UnitUtil::IsCombatSimUnit(ui.type)))
@@ -595,42 +649,20 @@ BWAPI::Unit Squad::unitClosestToOrderPosition() const
 //ӽλõĵԪ
 BWAPI::Unit Squad::unitClosestTo(BWAPI::Position position, bool debug) const
 {
-	BWAPI::Unit closest = nullptr;
-	int closestDist = INT_MAX;
-
 	UAB_ASSERT(position.isValid(), "bad position");
 
-	for (auto unit : _units)
-	{
-		// Non-combat units should be ignored for this calculation.
-		if (unit->getType().isDetector() ||
-			!unit->getPosition().isValid() ||       // includes units loaded into bunkers or transports
-			unit->getType().isFlyer() ||
-			unit->getType() == BWAPI::UnitTypes::Terran_Medic)
+	// Units loaded into bunkers or transports have no valid position and are never returned.
+	// A ground or air-ground squad uses ground distance, an all-air squad uses air distance.
+	return NearestUnits::Instance().getClosest(position, true, false,
+		[this](BWAPI::Unit unit)
 		{
-			continue;
-		}
-
-		int dist;
-		if (_hasGround)
-		{
-			// A ground or air-ground squad. Use ground distance.
-            dist = PathFinding::GetGroundDistance(unit->getPosition(), position);
-		}
-		else
-		{
-			// An all-air squad. Use air distance (which is what unit->getDistance() gives).
-			dist = unit->getDistance(position);
-        }
-
-		if (dist < closestDist && dist != -1)
-		{
-			closest = unit;
-			closestDist = dist;
-		}
-	}
-
-	return closest;
+			// Non-combat units should be ignored for this calculation.
+			return _units.contains(unit) &&
+				!unit->getType().isDetector() &&
+				!unit->getType().isFlyer() &&
+				unit->getType() != BWAPI::UnitTypes::Terran_Medic;
+		},
+		_hasGround ? NearestUnits::Metric::Ground : NearestUnits::Metric::Air);
 }
 
 const BWAPI::Unitset & Squad::getUnits() const	
@@ -20,6 +20,7 @@
 #include "MicroDragoon.h"
 
 #include "MicroBunkerAttackSquad.h"
+#include "UnitTargetMatrix.h"
 
 namespace UAlbertaBot
 {
@@ -63,12 +64,15 @@ class Squad
 
 	std::map<BWAPI::Unit, bool>	_nearEnemy;
 
+	UnitTargetMatrix	_targetMatrix;		// shared by the micro managers, rebuilt each frame
+
 	void			updateUnits();
 	void			addUnitsToMicroManagers();
 	void			setNearEnemyUnits();
 	void			setAllUnits();
+	void			updateTargetMatrix();
 	
-	bool			unitNearEnemy(BWAPI::Unit unit);
+	bool			unitNearEnemy(BWAPI::Unit unit, const std::vector<std::pair<const UnitInfo *, int>> & enemies);
 	bool			needsToRegroup();
 
 	void			loadTransport();
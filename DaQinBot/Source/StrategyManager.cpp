@@ -14,7 +14,6 @@ namespace { auto & bwebMap = BWEB::Map::Instance(); }
 StrategyManager::StrategyManager() 
 	: _selfRace(BWAPI::Broodwar->self()->getRace())
 	, _enemyRace(BWAPI::Broodwar->enemy()->getRace())
-    , _emptyBuildOrder(BWAPI::Broodwar->self()->getRace())
 	, _openingGroup("")
 	, _rushing(false)
 	, _hasDropTech(false)
@@ -66,19 +65,19 @@ void StrategyManager::update()
     }
 }
 
-const BuildOrder & StrategyManager::getOpeningBookBuildOrder() const
+BuildOrder StrategyManager::getOpeningBookBuildOrder() const
 {
-    auto buildOrderIt = _strategies.find(Config::Strategy::StrategyName);
+    int opening = _openingBook.getOpening(Config::Strategy::StrategyName);
 
-    // look for the build order in the build order map
-	if (buildOrderIt != std::end(_strategies))
+    // look for the build order in the opening book
+	if (opening >= 0)
     {
-        return (*buildOrderIt).second._buildOrder;
+        return _openingBook.getBuildOrder(opening, _selfRace);
     }
     else
     {
         UAB_ASSERT_WARNING(false, "Strategy not found: %s, returning empty initial build order", Config::Strategy::StrategyName.c_str());
-        return _emptyBuildOrder;
+        return BuildOrder(_selfRace);
     }
 }
 
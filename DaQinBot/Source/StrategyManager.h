@@ -5,6 +5,7 @@
 #include "WorkerManager.h"
 #include "BuildOrder.h"
 #include "BuildOrderQueue.h"
+#include "OpeningBook.h"
 
 namespace UAlbertaBot
 {
@@ -16,7 +17,6 @@ struct Strategy
     std::string _name;
     BWAPI::Race _race;
 	std::string _openingGroup;
-    BuildOrder  _buildOrder;
 
     Strategy()
         : _name("None")
@@ -25,11 +25,11 @@ struct Strategy
     {
     }
 
-	Strategy(const std::string & name, const BWAPI::Race & race, const std::string & openingGroup, const BuildOrder & buildOrder)
+	// the build order is in StrategyManager's opening book, under the same name
+	Strategy(const std::string & name, const BWAPI::Race & race, const std::string & openingGroup)
         : _name(name)
         , _race(race)
 		, _openingGroup(openingGroup)
-		, _buildOrder(buildOrder)
 	{
     }
 };
@@ -45,7 +45,7 @@ class StrategyManager
 	BWAPI::Race					    _enemyRace;
     std::map<std::string, Strategy> _strategies;
     int                             _totalGamesPlayed;
-    const BuildOrder                _emptyBuildOrder;
+    OpeningBook                     _openingBook;
 	std::string						_openingGroup;
     bool                            _rushing;
 	bool							_hasDropTech;
@@ -70,10 +70,11 @@ public:
             void                    update();
 
             void                    addStrategy(const std::string & name, Strategy & strategy);
+            OpeningBook &           getOpeningBook() { return _openingBook; };
 			void					initializeOpening();
 	const	std::string &			getOpeningGroup() const;
  	const	MetaPairVector		    getBuildOrderGoal();
-	const	BuildOrder &            getOpeningBookBuildOrder() const;
+			BuildOrder              getOpeningBookBuildOrder() const;
 
             bool                    isRushing() const { return _rushing; };
 
@@ -0,0 +1,241 @@
+#include "TargetAssignment.h"
+#include "Logger.h"
+#include "../../BOSS/source/Timer.hpp"
+
+#include <random>
+
+using namespace UAlbertaBot;
+
+TargetAssignment::TargetAssignment()
+	: _rows(0)
+	, _columns(0)
+{
+}
+
+void TargetAssignment::resize(size_t rows, size_t columns)
+{
+	_rows = rows;
+	_columns = columns;
+	_scores.assign(rows * columns, int(NoTarget));
+	_budget.assign(columns, 1);
+	_assigned.assign(columns, 0);
+	_assignedColumn.assign(rows, -1);
+	_assignedScore.assign(rows, int(NoTarget));
+}
+
+void TargetAssignment::reset(const BWAPI::Unitset & units, const BWAPI::Unitset & targets)
+{
+	_units.assign(units.begin(), units.end());
+	_targets.assign(targets.begin(), targets.end());
+
+	resize(_units.size(), _targets.size());
+
+	int maxId = 0;
+	for (const auto unit : _units) maxId = std::max(maxId, unit->getID());
+	_rowOfId.assign(maxId + 1, -1);
+	for (size_t i = 0; i < _rows; ++i) _rowOfId[_units[i]->getID()] = int(i);
+
+	for (size_t j = 0; j < _columns; ++j)
+	{
+		_budget[j] = std::max(1, _targets[j]->getHitPoints() + _targets[j]->getShields());
+	}
+}
+
+// What the damage assigned so far adds to the score of any unit for this target.
+int TargetAssignment::adjustment(size_t column) const
+{
+	if (_assigned[column] >= _budget[column])
+	{
+		return -OverkillPenalty;
+	}
+	if (_assigned[column] * 10 > _budget[column] * 3)
+	{
+		return FocusBonus;
+	}
+	return 0;
+}
+
+// The best target for the row given the damage assigned so far, or -1 if none.
+int TargetAssignment::bestColumn(size_t row, int & bestRank) const
+{
+	const int * scores = &_scores[row * _columns];
+
+	int best = -1;
+	bestRank = NoTarget;
+	for (size_t j = 0; j < _columns; ++j)
+	{
+		if (scores[j] != NoTarget)
+		{
+			const int rank = scores[j] + adjustment(j);
+			if (best < 0 || rank > bestRank)
+			{
+				best = int(j);
+				bestRank = rank;
+			}
+		}
+	}
+	return best;
+}
+
+// Greedy assignment. Keep the best target of each unassigned unit, and at each step
+// commit the unit whose best pair is the best overall. Assigning damage to a target can
+// only change the ranks of that one target, so only that column has to be rechecked.
+void TargetAssignment::solve(const Damage & damage)
+{
+	std::vector<int> best(_rows);
+	std::vector<int> bestRank(_rows);
+	std::vector<uint8_t> done(_rows, 0);
+
+	for (size_t i = 0; i < _rows; ++i)
+	{
+		best[i] = bestColumn(i, bestRank[i]);
+	}
+
+	for (size_t step = 0; step < _rows; ++step)
+	{
+		int row = -1;
+		for (size_t i = 0; i < _rows; ++i)
+		{
+			if (!done[i] && best[i] >= 0 && (row < 0 || bestRank[i] > bestRank[row]))
+			{
+				row = int(i);
+			}
+		}
+		if (row < 0)
+		{
+			break;
+		}
+
+		const int column = best[row];
+		done[row] = 1;
+		_assignedColumn[row] = column;
+
+		// The unit still goes for an overkilled target if it has nothing better,
+		// so report its score without the penalty.
+		_assignedScore[row] = _scores[row * _columns + column] +
+			(_assigned[column] * 10 > _budget[column] * 3 ? FocusBonus : 0);
+
+		const int before = adjustment(column);
+		_assigned[column] += damage(row, column);
+		const int after = adjustment(column);
+
+		if (after == before)
+		{
+			continue;
+		}
+
+		for (size_t i = 0; i < _rows; ++i)
+		{
+			const int score = _scores[i * _columns + column];
+			if (done[i] || score == NoTarget)
+			{
+				continue;
+			}
+
+			if (best[i] == column)
+			{
+				if (after < before)
+				{
+					best[i] = bestColumn(i, bestRank[i]);
+				}
+				else
+				{
+					bestRank[i] = score + after;
+				}
+			}
+			else if (score + after > bestRank[i])
+			{
+				best[i] = column;
+				bestRank[i] = score + after;
+			}
+		}
+	}
+}
+
+void TargetAssignment::assign(const Damage & damage)
+{
+	if (damage)
+	{
+		solve(damage);
+		return;
+	}
+
+	solve([this](size_t row, size_t column)
+	{
+		return BWAPI::Broodwar->getDamageFrom(_units[row]->getType(), _targets[column]->getType());
+	});
+}
+
+BWAPI::Unit TargetAssignment::getTarget(BWAPI::Unit unit) const
+{
+	const int id = unit->getID();
+	if (id < 0 || id >= int(_rowOfId.size()) || _rowOfId[id] < 0)
+	{
+		return nullptr;
+	}
+
+	const int column = _assignedColumn[_rowOfId[id]];
+	return column >= 0 ? _targets[column] : nullptr;
+}
+
+int TargetAssignment::getScore(BWAPI::Unit unit) const
+{
+	const int id = unit->getID();
+	if (id < 0 || id >= int(_rowOfId.size()) || _rowOfId[id] < 0)
+	{
+		return NoTarget;
+	}
+
+	return _assignedScore[_rowOfId[id]];
+}
+
+// The scores, budgets and damages are random, in the ranges the micro managers produce.
+// Scoring the pairs is not included; that is the same per-pair code as before.
+void TargetAssignment::Benchmark(int units, int targets, int iterations)
+{
+	std::minstd_rand rng(1);
+	std::uniform_int_distribution<int> scoreDist(-12 * 32, 60 * 32);
+	std::uniform_int_distribution<int> budgetDist(20, 500);
+	std::uniform_int_distribution<int> damageDist(5, 40);
+
+	TargetAssignment assignment;
+	assignment.resize(units, targets);
+
+	std::vector<int> damages(size_t(units) * targets);
+	for (auto & d : damages) d = damageDist(rng);
+
+	const Damage damage = [&](size_t row, size_t column) { return damages[row * targets + column]; };
+
+	double totalMs = 0.0;
+	double maxMs = 0.0;
+	int assigned = 0;
+
+	for (int n = 0; n < iterations; ++n)
+	{
+		assignment.resize(units, targets);
+		for (auto & s : assignment._scores)
+		{
+			// About 1 pair in 8 is out of range or otherwise skipped.
+			s = rng() % 8 == 0 ? NoTarget : scoreDist(rng);
+		}
+		for (auto & b : assignment._budget) b = budgetDist(rng);
+
+		BOSS::Timer timer;
+		timer.start();
+		assignment.solve(damage);
+		timer.stop();
+
+		const double ms = timer.getElapsedTimeInMilliSec();
+		totalMs += ms;
+		maxMs = std::max(maxMs, ms);
+
+		for (int column : assignment._assignedColumn)
+		{
+			if (column >= 0) ++assigned;
+		}
+	}
+
+	Log().Get() << "Target assignment " << units << "x" << targets << ", " << iterations << " frames: "
+		<< "mean " << (iterations ? totalMs / iterations : 0.0) << "ms, max " << maxMs << "ms, "
+		<< assigned << " units assigned";
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Common.h"
+#include <functional>
+
+namespace UAlbertaBot
+{
+// Chooses targets for a whole group of units at once.
+// The micro manager fills in a score for every unit/target pair, one row per unit,
+// then assign() hands out targets greedily, best pair first. Each target has a damage
+// budget, its hit points plus shields. Once the units assigned to a target deal enough
+// damage to kill it, other units only choose it if they have nothing else to attack.
+// A target that is partly covered by assigned damage gets a bonus, for focus fire.
+class TargetAssignment
+{
+public:
+
+	// The score for a target the unit should not consider at all.
+	static const int NoTarget = INT_MIN;
+
+	// The damage that the unit in the row does to the target in the column with one attack.
+	typedef std::function<int(size_t row, size_t column)> Damage;
+
+private:
+
+	static const int FocusBonus = 2 * 32;           // the target has more than 30% of its budget assigned
+	static const int OverkillPenalty = 1 << 20;     // the target already has its whole budget assigned
+
+	std::vector<BWAPI::Unit>    _units;
+	std::vector<BWAPI::Unit>    _targets;
+	std::vector<int>            _rowOfId;           // by unit ID, -1 if not a row
+
+	size_t                      _rows;
+	size_t                      _columns;
+	std::vector<int>            _scores;            // row-major, filled in by the caller
+	std::vector<int>            _budget;            // by column, hit points + shields
+	std::vector<int>            _assigned;          // by column, damage assigned so far
+
+	std::vector<int>            _assignedColumn;    // by row, -1 if none
+	std::vector<int>            _assignedScore;     // by row
+
+	void    resize(size_t rows, size_t columns);
+	void    solve(const Damage & damage);
+	int     adjustment(size_t column) const;
+	int     bestColumn(size_t row, int & bestRank) const;
+
+public:
+
+	TargetAssignment();
+
+	// Start over with these units and targets. Every score is NoTarget until set.
+	void    reset(const BWAPI::Unitset & units, const BWAPI::Unitset & targets);
+
+	const std::vector<BWAPI::Unit> & getUnits() const { return _units; };
+	const std::vector<BWAPI::Unit> & getTargets() const { return _targets; };
+
+	// The scores of one unit against each target, in the order of getTargets().
+	int *   scoreRow(size_t row) { return &_scores[row * _columns]; };
+
+	// By default a unit does BWAPI's getDamageFrom() its type against the target's type.
+	void    assign(const Damage & damage = nullptr);
+
+	// The results. A unit with no target, or not in the assignment, gets nullptr.
+	BWAPI::Unit getTarget(BWAPI::Unit unit) const;
+	int     getScore(BWAPI::Unit unit) const;
+
+	// Time assign() on random scores, and write the result to the log.
+	static void Benchmark(int units, int targets, int iterations);
+};
+}
@@ -84,6 +84,8 @@ void UnitData::updateUnit(BWAPI::Unit unit)
     }
     
 	UnitInfo & ui   = unitMap[unit];
+	const BWAPI::UnitType oldType = ui.type;
+	const bool oldCompleted = ui.completed;
 
     // Check for buildings that have taken off or landed
     if (unit->getType().isBuilding() && unit->isFlying() != ui.isFlying)
@@ -116,6 +118,11 @@ void UnitData::updateUnit(BWAPI::Unit unit)
 
     if (unit->exists() && unit->isVisible()) 
         ui.groundWeaponCooldownFrame = BWAPI::Broodwar->getFrameCount() + unit->getGroundWeaponCooldown();
+
+	if (ui.player == BWAPI::Broodwar->enemy() && (ui.type != oldType || ui.completed != oldCompleted))
+	{
+		InformationManager::Instance().onEnemyUnitChanged(ui, oldType, oldCompleted);
+	}
 }
 
 void UnitData::removeUnit(BWAPI::Unit unit)
@@ -126,6 +133,12 @@ void UnitData::removeUnit(BWAPI::Unit unit)
 	gasLost += unit->getType().gasPrice();
 	--numUnits[unit->getType().getID()];
 	++numDeadUnits[unit->getType().getID()];
+
+	auto it = unitMap.find(unit);
+	if (it != unitMap.end() && it->second.player == BWAPI::Broodwar->enemy())
+	{
+		InformationManager::Instance().onEnemyUnitRemoved(it->second);
+	}
 	
 	unitMap.erase(unit);
 
@@ -139,6 +152,10 @@ void UnitData::removeBadUnits()
 	{
 		if (badUnitInfo(iter->second))
 		{
+			if (iter->second.player == BWAPI::Broodwar->enemy())
+			{
+				InformationManager::Instance().onEnemyUnitRemoved(iter->second);
+			}
 			numUnits[iter->second.type.getID()]--;
 			iter = unitMap.erase(iter);
 		}
@@ -0,0 +1,217 @@
+#include "UnitTargetMatrix.h"
+#include "UnitUtil.h"
+
+using namespace UAlbertaBot;
+
+UnitTargetMatrix::UnitTargetMatrix()
+{
+}
+
+void UnitTargetMatrix::clear()
+{
+	_units.clear();
+	_targets.clear();
+	_rowOfId.clear();
+	_columnOfId.clear();
+	_distance.clear();
+	_range.clear();
+	_targetRange.clear();
+	_flags.clear();
+}
+
+void UnitTargetMatrix::update(const BWAPI::Unitset & units, const BWAPI::Unitset & targets)
+{
+	clear();
+
+	for (const auto unit : units)
+	{
+		if (unit->getPosition().isValid())     // excludes loaded units
+		{
+			_units.push_back(unit);
+		}
+	}
+	for (const auto target : targets)
+	{
+		if (target->exists() && target->getPosition().isValid())
+		{
+			_targets.push_back(target);
+		}
+	}
+
+	const size_t rows = _units.size();
+	const size_t cols = _targets.size();
+
+	int maxId = 0;
+	for (const auto unit : _units)   maxId = std::max(maxId, unit->getID());
+	for (const auto unit : _targets) maxId = std::max(maxId, unit->getID());
+
+	_rowOfId.assign(maxId + 1, -1);
+	_columnOfId.assign(maxId + 1, -1);
+	for (size_t i = 0; i < rows; ++i) _rowOfId[_units[i]->getID()] = int(i);
+	for (size_t j = 0; j < cols; ++j) _columnOfId[_targets[j]->getID()] = int(j);
+
+	if (rows == 0 || cols == 0)
+	{
+		return;
+	}
+
+	// Attack range and ability to attack depend only on the attacker and on whether
+	// the target is flying. Look them up once per unit against a flying and a ground
+	// representative from the other side, instead of once per pair.
+	BWAPI::Unit airTarget = nullptr;
+	BWAPI::Unit groundTarget = nullptr;
+	for (const auto target : _targets)
+	{
+		if (target->isFlying()) airTarget = target;
+		else groundTarget = target;
+	}
+
+	BWAPI::Unit airUnit = nullptr;
+	BWAPI::Unit groundUnit = nullptr;
+	for (const auto unit : _units)
+	{
+		if (unit->isFlying()) airUnit = unit;
+		else groundUnit = unit;
+	}
+
+	// Structure-of-arrays copies of the bounding boxes and per-unit values, so that the
+	// per-pair loops below are straight-line integer arithmetic the compiler can vectorize.
+	std::vector<int> uLeft(rows), uTop(rows), uRight(rows), uBottom(rows);
+	std::vector<int> uRangeVsAir(rows), uRangeVsGround(rows);
+	std::vector<uint8_t> uFlying(rows), uCanAttackAir(rows), uCanAttackGround(rows);
+
+	for (size_t i = 0; i < rows; ++i)
+	{
+		const BWAPI::Unit unit = _units[i];
+		const BWAPI::Position pos = unit->getPosition();
+		uLeft[i] = pos.x - unit->getType().dimensionLeft();
+		uTop[i] = pos.y - unit->getType().dimensionUp();
+		uRight[i] = pos.x + unit->getType().dimensionRight();
+		uBottom[i] = pos.y + unit->getType().dimensionDown();
+		uRangeVsAir[i] = airTarget ? UnitUtil::GetAttackRange(unit, airTarget) : 0;
+		uRangeVsGround[i] = groundTarget ? UnitUtil::GetAttackRange(unit, groundTarget) : 0;
+		uFlying[i] = unit->isFlying();
+		uCanAttackAir[i] = UnitUtil::CanAttackAir(unit);
+		uCanAttackGround[i] = UnitUtil::CanAttackGround(unit);
+	}
+
+	std::vector<int> tLeft(cols), tTop(cols), tRight(cols), tBottom(cols);
+	std::vector<int> tRangeVsAir(cols), tRangeVsGround(cols);
+	std::vector<uint8_t> tFlying(cols), tCanAttackAir(cols), tCanAttackGround(cols);
+
+	for (size_t j = 0; j < cols; ++j)
+	{
+		const BWAPI::Unit target = _targets[j];
+		const BWAPI::Position pos = target->getPosition();
+		tLeft[j] = pos.x - target->getType().dimensionLeft();
+		tTop[j] = pos.y - target->getType().dimensionUp();
+		tRight[j] = pos.x + target->getType().dimensionRight();
+		tBottom[j] = pos.y + target->getType().dimensionDown();
+		tRangeVsAir[j] = airUnit ? UnitUtil::GetAttackRange(target, airUnit) : 0;
+		tRangeVsGround[j] = groundUnit ? UnitUtil::GetAttackRange(target, groundUnit) : 0;
+		tFlying[j] = target->isFlying();
+		tCanAttackAir[j] = UnitUtil::CanAttackAir(target);
+		tCanAttackGround[j] = UnitUtil::CanAttackGround(target);
+	}
+
+	_distance.resize(rows * cols);
+	_range.resize(rows * cols);
+	_targetRange.resize(rows * cols);
+	_flags.resize(rows * cols);
+
+	for (size_t i = 0; i < rows; ++i)
+	{
+		const int left = uLeft[i];
+		const int top = uTop[i];
+		const int right = uRight[i];
+		const int bottom = uBottom[i];
+		int * distance = &_distance[i * cols];
+
+		// Edge to edge distance, computed the same way as MathUtil::EdgeToEdgeDistance()
+		// and BWAPI's getDistance(), including the approximate distance formula.
+		for (size_t j = 0; j < cols; ++j)
+		{
+			const int xDist = std::max(std::max(left - tRight[j] - 1, tLeft[j] - right - 1), 0);
+			const int yDist = std::max(std::max(top - tBottom[j] - 1, tTop[j] - bottom - 1), 0);
+			const int lo = std::min(xDist, yDist);
+			const int hi = std::max(xDist, yDist);
+			const int loCalc = (3 * lo) >> 3;
+			distance[j] = lo < (hi >> 2) ? hi : (loCalc >> 5) + loCalc + hi - (hi >> 4) - (hi >> 6);
+		}
+
+		const int rangeVsAir = uRangeVsAir[i];
+		const int rangeVsGround = uRangeVsGround[i];
+		const int canAttackAir = uCanAttackAir[i];
+		const int canAttackGround = uCanAttackGround[i];
+		const int flying = uFlying[i];
+		int * range = &_range[i * cols];
+		int * targetRange = &_targetRange[i * cols];
+		uint8_t * flags = &_flags[i * cols];
+
+		for (size_t j = 0; j < cols; ++j)
+		{
+			const int r = tFlying[j] ? rangeVsAir : rangeVsGround;
+			const int tr = flying ? tRangeVsAir[j] : tRangeVsGround[j];
+			const int can = tFlying[j] ? canAttackAir : canAttackGround;
+			const int targetCan = flying ? tCanAttackAir[j] : tCanAttackGround[j];
+
+			range[j] = r;
+			targetRange[j] = tr;
+			flags[j] = uint8_t(
+				(can ? CanAttack : 0) |
+				(can && distance[j] <= r ? InRange : 0) |
+				(targetCan ? TargetCanAttack : 0) |
+				(targetCan && distance[j] <= tr ? TargetInRange : 0));
+		}
+	}
+}
+
+int UnitTargetMatrix::row(BWAPI::Unit unit) const
+{
+	const int id = unit->getID();
+	return id >= 0 && id < int(_rowOfId.size()) ? _rowOfId[id] : -1;
+}
+
+int UnitTargetMatrix::column(BWAPI::Unit unit) const
+{
+	const int id = unit->getID();
+	return id >= 0 && id < int(_columnOfId.size()) ? _columnOfId[id] : -1;
+}
+
+int UnitTargetMatrix::getDistance(BWAPI::Unit a, BWAPI::Unit b) const
+{
+	int r, c;
+	if ((r = row(a)) >= 0 && (c = column(b)) >= 0) return _distance[index(r, c)];
+	if ((r = row(b)) >= 0 && (c = column(a)) >= 0) return _distance[index(r, c)];
+
+	return a->getDistance(b);
+}
+
+int UnitTargetMatrix::getAttackRange(BWAPI::Unit attacker, BWAPI::Unit target) const
+{
+	int r, c;
+	if ((r = row(attacker)) >= 0 && (c = column(target)) >= 0) return _range[index(r, c)];
+	if ((r = row(target)) >= 0 && (c = column(attacker)) >= 0) return _targetRange[index(r, c)];
+
+	return UnitUtil::GetAttackRange(attacker, target);
+}
+
+bool UnitTargetMatrix::canAttack(BWAPI::Unit attacker, BWAPI::Unit target) const
+{
+	int r, c;
+	if ((r = row(attacker)) >= 0 && (c = column(target)) >= 0) return (_flags[index(r, c)] & CanAttack) != 0;
+	if ((r = row(target)) >= 0 && (c = column(attacker)) >= 0) return (_flags[index(r, c)] & TargetCanAttack) != 0;
+
+	return UnitUtil::CanAttack(attacker, target);
+}
+
+// Within the matrix, "in range" means within UnitUtil::GetAttackRange(), which assumes
+// the enemy has its range upgrades.
+bool UnitTargetMatrix::isInWeaponRange(BWAPI::Unit attacker, BWAPI::Unit target) const
+{
+	int r, c;
+	if ((r = row(attacker)) >= 0 && (c = column(target)) >= 0) return (_flags[index(r, c)] & InRange) != 0;
+	if ((r = row(target)) >= 0 && (c = column(attacker)) >= 0) return (_flags[index(r, c)] & TargetInRange) != 0;
+
+	return attacker->isInWeaponRange(target);
+}
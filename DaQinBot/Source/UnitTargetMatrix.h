@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Common.h"
+
+namespace UAlbertaBot
+{
+// Distances and attack ranges between the units of a squad and the enemy units around it.
+// Squad::update fills it once per frame, so the micro managers don't ask BWAPI again
+// for the same unit/target pairs. Each quantity is a contiguous row-major array,
+// one row per squad unit and one column per target.
+// Queries work in either direction (our unit attacking a target, or the target attacking
+// our unit). Pairs not in the matrix fall back to BWAPI and UnitUtil.
+class UnitTargetMatrix
+{
+	enum PairFlags
+	{
+		CanAttack       = 1 << 0,      // the unit can attack the target
+		InRange         = 1 << 1,      // ... and the target is within its attack range
+		TargetCanAttack = 1 << 2,      // the target can attack the unit
+		TargetInRange   = 1 << 3       // ... and the unit is within the target's attack range
+	};
+
+	std::vector<BWAPI::Unit>    _units;
+	std::vector<BWAPI::Unit>    _targets;
+	std::vector<int>            _rowOfId;           // by unit ID, -1 if not a row
+	std::vector<int>            _columnOfId;        // by unit ID, -1 if not a column
+
+	std::vector<int>            _distance;          // edge to edge, as unit->getDistance(target)
+	std::vector<int>            _range;             // UnitUtil::GetAttackRange(unit, target)
+	std::vector<int>            _targetRange;       // UnitUtil::GetAttackRange(target, unit)
+	std::vector<uint8_t>        _flags;             // PairFlags
+
+	int     row(BWAPI::Unit unit) const;
+	int     column(BWAPI::Unit unit) const;
+	size_t  index(int row, int column) const { return size_t(row) * _targets.size() + column; }
+
+public:
+
+	UnitTargetMatrix();
+
+	void    update(const BWAPI::Unitset & units, const BWAPI::Unitset & targets);
+	void    clear();
+
+	const std::vector<BWAPI::Unit> & getTargets() const { return _targets; };
+
+	int     getDistance(BWAPI::Unit a, BWAPI::Unit b) const;
+	int     getAttackRange(BWAPI::Unit attacker, BWAPI::Unit target) const;
+	bool    canAttack(BWAPI::Unit attacker, BWAPI::Unit target) const;
+	bool    isInWeaponRange(BWAPI::Unit attacker, BWAPI::Unit target) const;
+};
+}
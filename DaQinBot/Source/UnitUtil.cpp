@@ -559,3 +559,16 @@ BWAPI::Unit UnitUtil::GetNextCompletedBuildingOfType(BWAPI::UnitType type)
 
 	return bestUnit;
 }
+
+// The unit is completed, landed, powered and not producing or researching anything.
+// It may still be unable to produce a given type, for lack of an addon for example.
+bool UnitUtil::IsIdleProducer(BWAPI::Unit unit)
+{
+	return
+		unit->isCompleted() &&
+		!unit->isTraining() &&
+		!unit->isLifted() &&
+		unit->isPowered() &&
+		!unit->isUpgrading() &&
+		!unit->isResearching();
+}
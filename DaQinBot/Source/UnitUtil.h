@@ -47,5 +47,7 @@ namespace UnitUtil
 	int GetUncompletedUnitCount(BWAPI::UnitType type);
 
 	BWAPI::Unit GetNextCompletedBuildingOfType(BWAPI::UnitType type);
+
+	bool IsIdleProducer(BWAPI::Unit unit);
 };
 }
\ No newline at end of file
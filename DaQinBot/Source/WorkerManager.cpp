@@ -1,6 +1,7 @@
 #include "Common.h"
 #include "WorkerManager.h"
 #include "Micro.h"
+#include "NearestUnits.h"
 #include "ProductionManager.h"
 #include "UnitUtil.h"
 
@@ -541,26 +542,12 @@ BWAPI::Unit WorkerManager::getAnyClosestDepot(BWAPI::Unit worker)
 {
 	UAB_ASSERT(worker, "Worker was null");
 
-	BWAPI::Unit closestDepot = nullptr;
-	int closestDistance = 0;
-
-	for (const auto unit : BWAPI::Broodwar->self()->getUnits())
-	{
-		UAB_ASSERT(unit, "Unit was null");
-
-		if (unit->getType().isResourceDepot() &&
-			(unit->isCompleted() || unit->getType() == BWAPI::UnitTypes::Zerg_Lair || unit->getType() == BWAPI::UnitTypes::Zerg_Hive))
+	return NearestUnits::Instance().getClosest(worker, true, false,
+		[](BWAPI::Unit unit)
 		{
-			int distance = unit->getDistance(worker);
-			if (!closestDepot || distance < closestDistance)
-			{
-				closestDepot = unit;
-				closestDistance = distance;
-			}
-		}
-	}
-
-	return closestDepot;
+			return unit->getType().isResourceDepot() &&
+				(unit->isCompleted() || unit->getType() == BWAPI::UnitTypes::Zerg_Lair || unit->getType() == BWAPI::UnitTypes::Zerg_Hive);
+		});
 }
 
 // Get the closest resource depot that can accept another mineral worker.